@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Throughput and latency benchmark suite for struct ring_buf.
+ *
+ * Scenarios:
+ *   put_get       ring_buf_put() followed by ring_buf_get() (copying)
+ *   claim_finish  put claim/finish then get claim/finish (zero copy)
+ *   item          ring_buf_item_put() followed by ring_buf_item_get()
+ *   item_crc      same as item, on a ring initialized with
+ *                 ring_buf_item_checked_init()
+ *   spsc          ring_buf_put() in a producer thread, ring_buf_get() in a
+ *                 consumer thread
+ *
+ * Each scenario runs over a range of payload sizes and ring sizes, with two
+ * wrap patterns: "aligned" rings are a power of two, so power of two
+ * payloads never straddle the end of the storage, while "straddle" rings
+ * are 4 bytes shorter so that transfers regularly split at the wrap point.
+ *
+ * Single thread latencies time one put and get pair (timer overhead
+ * removed). Cross thread latencies are the time between a put and the
+ * matching get in the other thread, including time spent queued in the
+ * ring buffer.
+ *
+ * Build and run:
+ *   gcc -O2 -std=c11 -Isrc bench/bench_ring_buffer.c src/ring_buffer.c \
+ *       src/crc.c -lpthread -o bench_ring_buffer
+ *   ./bench_ring_buffer [--quick] [--json results.json]
+ *
+ * The JSON file holds one object per case, keyed by scenario, ring_size,
+ * payload and wrap, so that two runs can be compared case by case.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ring_buffer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#define BENCH_MAX_RING        65536u
+#define BENCH_TARGET_BYTES    (64u * 1024u * 1024u)
+#define BENCH_MIN_OPS         100000u
+#define BENCH_MAX_OPS         4000000u
+#define BENCH_LATENCY_SAMPLES 100000u
+#define BENCH_STRADDLE        4u
+#define BENCH_SPIN_COUNT      64u
+
+enum bench_scenario {
+    BENCH_PUT_GET,
+    BENCH_CLAIM_FINISH,
+    BENCH_ITEM,
+    BENCH_ITEM_CRC,
+    BENCH_SPSC,
+};
+
+static const char *const scenario_names[] = {
+    [BENCH_PUT_GET] = "put_get",
+    [BENCH_CLAIM_FINISH] = "claim_finish",
+    [BENCH_ITEM] = "item",
+    [BENCH_ITEM_CRC] = "item_crc",
+    [BENCH_SPSC] = "spsc",
+};
+
+struct bench_case {
+    enum bench_scenario scenario;
+    uint32_t ring_size;
+    uint32_t payload;
+    bool straddle;
+    uint32_t ops;
+};
+
+struct bench_result {
+    double ns_per_op;
+    double gb_per_s;
+    uint32_t p50_ns;
+    uint32_t p99_ns;
+    uint32_t p999_ns;
+};
+
+static uint32_t ring_storage[BENCH_MAX_RING / sizeof(uint32_t)];
+static uint32_t payload_in[BENCH_MAX_RING / sizeof(uint32_t)];
+static uint32_t payload_out[BENCH_MAX_RING / sizeof(uint32_t)];
+static uint32_t samples[BENCH_LATENCY_SAMPLES];
+static uint32_t timer_overhead_ns;
+
+static struct ring_buf spsc_rb;
+static const struct bench_case *spsc_case;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *) a;
+    uint32_t y = *(const uint32_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+static uint32_t percentile(const uint32_t *sorted, uint32_t count, uint32_t per_mille)
+{
+    uint64_t index = ((uint64_t) count * per_mille) / 1000u;
+
+    return sorted[index < count ? index : count - 1];
+}
+
+static void ring_setup(const struct bench_case *bc, struct ring_buf *rb)
+{
+    uint32_t size = bc->ring_size - (bc->straddle ? BENCH_STRADDLE : 0);
+
+    if (bc->scenario == BENCH_ITEM) {
+        ring_buf_item_init(rb, size / sizeof(uint32_t), ring_storage);
+    } else if (bc->scenario == BENCH_ITEM_CRC) {
+        ring_buf_item_checked_init(rb, size / sizeof(uint32_t), ring_storage);
+    } else {
+        ring_buf_init(rb, size, (uint8_t *) ring_storage);
+    }
+}
+
+/* One put and get pair of the single thread scenarios. */
+static void single_op(const struct bench_case *bc, struct ring_buf *rb)
+{
+    uint8_t *in = (uint8_t *) payload_in;
+    uint8_t *out = (uint8_t *) payload_out;
+    uint32_t size = bc->payload;
+
+    switch (bc->scenario) {
+    case BENCH_PUT_GET:
+        ring_buf_put(rb, in, size);
+        ring_buf_get(rb, out, size);
+        break;
+
+    case BENCH_CLAIM_FINISH: {
+        uint8_t *data;
+        uint32_t claimed = 0;
+
+        while (claimed < size) {
+            uint32_t len = ring_buf_put_claim(rb, &data, size - claimed);
+            data[0] = (uint8_t) claimed;
+            claimed += len;
+        }
+        ring_buf_put_finish(rb, size);
+
+        claimed = 0;
+        while (claimed < size) {
+            uint32_t len = ring_buf_get_claim(rb, &data, size - claimed);
+            out[0] = data[0];
+            claimed += len;
+        }
+        ring_buf_get_finish(rb, size);
+        break;
+    }
+
+    case BENCH_ITEM:
+    case BENCH_ITEM_CRC: {
+        uint16_t type;
+        uint8_t value;
+        uint8_t size32 = (uint8_t) (size / sizeof(uint32_t));
+
+        ring_buf_item_put(rb, 1, 2, payload_in, size32);
+        ring_buf_item_get(rb, &type, &value, payload_out, &size32);
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+static uint32_t latency_summarize(uint32_t count, struct bench_result *result)
+{
+    qsort(samples, count, sizeof(samples[0]), compare_u32);
+    result->p50_ns = percentile(samples, count, 500);
+    result->p99_ns = percentile(samples, count, 990);
+    result->p999_ns = percentile(samples, count, 999);
+
+    return count;
+}
+
+static void run_single(const struct bench_case *bc, struct bench_result *result)
+{
+    struct ring_buf rb;
+
+    ring_setup(bc, &rb);
+
+    uint64_t start = now_ns();
+
+    for (uint32_t i = 0; i < bc->ops; i++) {
+        single_op(bc, &rb);
+    }
+
+    uint64_t elapsed = now_ns() - start;
+    uint32_t count = bc->ops < BENCH_LATENCY_SAMPLES ? bc->ops : BENCH_LATENCY_SAMPLES;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t t0 = now_ns();
+        single_op(bc, &rb);
+        uint64_t t1 = now_ns();
+        uint64_t ns = t1 - t0;
+
+        samples[i] = ns > timer_overhead_ns ? (uint32_t) (ns - timer_overhead_ns) : 0;
+    }
+
+    latency_summarize(count, result);
+    result->ns_per_op = (double) elapsed / bc->ops;
+    result->gb_per_s = (double) bc->payload * bc->ops / (double) elapsed;
+}
+
+static void *spsc_producer(void *arg)
+{
+    uint8_t *in = (uint8_t *) payload_in;
+    uint32_t spins = 0;
+
+    (void) arg;
+
+    for (uint32_t i = 0; i < spsc_case->ops; ) {
+        if (ring_buf_space_get(&spsc_rb) < spsc_case->payload) {
+            if (++spins >= BENCH_SPIN_COUNT) {
+                spins = 0;
+                sched_yield();
+            }
+            continue;
+        }
+
+        uint64_t stamp = now_ns();
+
+        memcpy(in, &stamp, sizeof(stamp));
+        ring_buf_put(&spsc_rb, in, spsc_case->payload);
+        i++;
+    }
+
+    return NULL;
+}
+
+static uint32_t spsc_consume(void)
+{
+    uint8_t *out = (uint8_t *) payload_out;
+    uint32_t stride = spsc_case->ops / BENCH_LATENCY_SAMPLES + 1;
+    uint32_t count = 0;
+    uint32_t spins = 0;
+
+    for (uint32_t i = 0; i < spsc_case->ops; ) {
+        if (ring_buf_size_get(&spsc_rb) < spsc_case->payload) {
+            if (++spins >= BENCH_SPIN_COUNT) {
+                spins = 0;
+                sched_yield();
+            }
+            continue;
+        }
+
+        ring_buf_get(&spsc_rb, out, spsc_case->payload);
+
+        if (i % stride == 0 && count < BENCH_LATENCY_SAMPLES) {
+            uint64_t stamp;
+
+            memcpy(&stamp, out, sizeof(stamp));
+            samples[count++] = (uint32_t) (now_ns() - stamp);
+        }
+
+        i++;
+    }
+
+    return count;
+}
+
+static void run_spsc(const struct bench_case *bc, struct bench_result *result)
+{
+    pthread_t producer;
+
+    ring_setup(bc, &spsc_rb);
+    spsc_case = bc;
+
+    uint64_t start = now_ns();
+
+    pthread_create(&producer, NULL, spsc_producer, NULL);
+    uint32_t count = spsc_consume();
+    pthread_join(producer, NULL);
+
+    uint64_t elapsed = now_ns() - start;
+
+    latency_summarize(count, result);
+    result->ns_per_op = (double) elapsed / bc->ops;
+    result->gb_per_s = (double) bc->payload * bc->ops / (double) elapsed;
+}
+
+static void timer_calibrate(void)
+{
+    for (uint32_t i = 0; i < BENCH_LATENCY_SAMPLES; i++) {
+        uint64_t t0 = now_ns();
+        uint64_t t1 = now_ns();
+
+        samples[i] = (uint32_t) (t1 - t0);
+    }
+
+    qsort(samples, BENCH_LATENCY_SAMPLES, sizeof(samples[0]), compare_u32);
+    timer_overhead_ns = percentile(samples, BENCH_LATENCY_SAMPLES, 500);
+}
+
+static void json_write(FILE *json, const struct bench_case *bc,
+                       const struct bench_result *result, bool first)
+{
+    fprintf(json,
+            "%s\n    {\"scenario\": \"%s\", \"threads\": %u, \"ring_size\": %u, "
+            "\"payload\": %u, \"wrap\": \"%s\", \"ops\": %u, "
+            "\"ns_per_op\": %.3f, \"gb_per_s\": %.4f, "
+            "\"p50_ns\": %u, \"p99_ns\": %u, \"p999_ns\": %u}",
+            first ? "" : ",", scenario_names[bc->scenario],
+            bc->scenario == BENCH_SPSC ? 2u : 1u, bc->ring_size, bc->payload,
+            bc->straddle ? "straddle" : "aligned", bc->ops, result->ns_per_op,
+            result->gb_per_s, result->p50_ns, result->p99_ns, result->p999_ns);
+}
+
+int main(int argc, char **argv)
+{
+    static const uint32_t ring_sizes[] = {256, 4096, BENCH_MAX_RING};
+    static const uint32_t payloads[] = {1, 8, 64, 256, 1020, 4096, 16384};
+    const char *json_path = NULL;
+    uint32_t ops_divider = 1;
+    FILE *json = NULL;
+    bool first = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            ops_divider = 10;
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--quick] [--json file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (json_path) {
+        json = fopen(json_path, "w");
+        if (json == NULL) {
+            perror(json_path);
+            return 1;
+        }
+        fprintf(json, "{\n  \"benchmark\": \"ring_buffer\",\n  \"results\": [");
+    }
+
+    memset(payload_in, 0xa5, sizeof(payload_in));
+    timer_calibrate();
+
+    printf("%-13s %9s %8s %-9s %10s %9s %8s %8s %8s\n", "scenario", "ring_size", "payload",
+           "wrap", "ns/op", "GB/s", "p50_ns", "p99_ns", "p999_ns");
+
+    for (uint32_t s = BENCH_PUT_GET; s <= BENCH_SPSC; s++) {
+        for (uint32_t r = 0; r < sizeof(ring_sizes) / sizeof(ring_sizes[0]); r++) {
+            for (uint32_t p = 0; p < sizeof(payloads) / sizeof(payloads[0]); p++) {
+                for (uint32_t w = 0; w < 2; w++) {
+                    struct bench_case bc = {
+                        .scenario = (enum bench_scenario) s,
+                        .ring_size = ring_sizes[r],
+                        .payload = payloads[p],
+                        .straddle = w != 0,
+                    };
+                    struct bench_result result;
+
+                    /* keep at least two payloads (and their headers) in the ring */
+                    if (bc.payload + sizeof(uint32_t) > (bc.ring_size - BENCH_STRADDLE) / 2) {
+                        continue;
+                    }
+
+                    if ((bc.scenario == BENCH_ITEM || bc.scenario == BENCH_ITEM_CRC) &&
+                        (bc.payload % sizeof(uint32_t) != 0 || bc.payload > 1020)) {
+                        continue;
+                    }
+
+                    if (bc.scenario == BENCH_SPSC && bc.payload < sizeof(uint64_t)) {
+                        continue;
+                    }
+
+                    bc.ops = BENCH_TARGET_BYTES / bc.payload;
+                    bc.ops = bc.ops < BENCH_MIN_OPS ? BENCH_MIN_OPS : bc.ops;
+                    bc.ops = bc.ops > BENCH_MAX_OPS ? BENCH_MAX_OPS : bc.ops;
+                    bc.ops /= ops_divider;
+
+                    if (bc.scenario == BENCH_SPSC) {
+                        run_spsc(&bc, &result);
+                    } else {
+                        run_single(&bc, &result);
+                    }
+
+                    printf("%-13s %9u %8u %-9s %10.2f %9.3f %8u %8u %8u\n",
+                           scenario_names[bc.scenario], bc.ring_size, bc.payload,
+                           bc.straddle ? "straddle" : "aligned", result.ns_per_op,
+                           result.gb_per_s, result.p50_ns, result.p99_ns, result.p999_ns);
+
+                    if (json) {
+                        json_write(json, &bc, &result, first);
+                        first = false;
+                    }
+                }
+            }
+        }
+    }
+
+    if (json) {
+        fprintf(json, "\n  ]\n}\n");
+        fclose(json);
+    }
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Throughput benchmark for the MPMC item ring buffer.
+ *
+ * Moves a fixed number of 2-word items through a ring_buf_mpmc for every
+ * combination of 1..N producers and 1..N consumers, and through a
+ * mutex-guarded struct ring_buf in item mode for comparison.
+ *
+ * Build and run:
+ *   gcc -O2 -std=c11 -Isrc bench/bench_ring_buffer_mpmc.c \
+ *       src/ring_buffer_mpmc.c src/ring_buffer.c -lpthread -o bench_mpmc
+ *   ./bench_mpmc [max_threads]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ring_buffer.h"
+#include "ring_buffer_mpmc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#define BENCH_ITEMS      (4u * 1024u * 1024u)
+#define BENCH_SLOTS      1024u
+#define BENCH_SIZE32     2u
+#define BENCH_MAX_THREADS 16u
+
+struct bench_ctx {
+    struct ring_buf_mpmc mpmc;
+    struct ring_buf locked;
+    pthread_mutex_t lock;
+    uint32_t items_per_producer;
+    uint32_t consumed;
+    uint32_t total;
+    bool use_lock;
+};
+
+static uint32_t mpmc_storage[RING_BUF_MPMC_BUFFER_SIZE32(BENCH_SLOTS, BENCH_SIZE32)];
+static uint32_t locked_storage[BENCH_SLOTS * (BENCH_SIZE32 + 1u)];
+
+static int32_t bench_put(struct bench_ctx *ctx, uint32_t *data)
+{
+    if (!ctx->use_lock) {
+        return ring_buf_mpmc_item_put(&ctx->mpmc, 1, 2, data, BENCH_SIZE32);
+    }
+
+    pthread_mutex_lock(&ctx->lock);
+    int32_t ret = ring_buf_item_put(&ctx->locked, 1, 2, data, BENCH_SIZE32);
+    pthread_mutex_unlock(&ctx->lock);
+
+    return ret;
+}
+
+static int32_t bench_get(struct bench_ctx *ctx, uint32_t *data)
+{
+    uint16_t type;
+    uint8_t value;
+    uint8_t size32 = BENCH_SIZE32;
+
+    if (!ctx->use_lock) {
+        return ring_buf_mpmc_item_get(&ctx->mpmc, &type, &value, data, &size32);
+    }
+
+    pthread_mutex_lock(&ctx->lock);
+    int32_t ret = ring_buf_item_get(&ctx->locked, &type, &value, data, &size32);
+    pthread_mutex_unlock(&ctx->lock);
+
+    return ret;
+}
+
+static void *producer(void *arg)
+{
+    struct bench_ctx *ctx = arg;
+    uint32_t data[BENCH_SIZE32] = {0};
+
+    for (uint32_t i = 0; i < ctx->items_per_producer; ) {
+        data[0] = i;
+        if (bench_put(ctx, data) == 0) {
+            i++;
+        } else {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    struct bench_ctx *ctx = arg;
+    uint32_t data[BENCH_SIZE32];
+
+    while (__atomic_load_n(&ctx->consumed, __ATOMIC_RELAXED) < ctx->total) {
+        if (bench_get(ctx, data) == 0) {
+            __atomic_add_fetch(&ctx->consumed, 1, __ATOMIC_RELAXED);
+        } else {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static double run(bool use_lock, uint32_t producers, uint32_t consumers)
+{
+    static struct bench_ctx ctx;
+    pthread_t threads[2 * BENCH_MAX_THREADS];
+    struct timespec start;
+    struct timespec end;
+
+    ring_buf_mpmc_item_init(&ctx.mpmc, BENCH_SLOTS, BENCH_SIZE32, mpmc_storage);
+    ring_buf_item_init(&ctx.locked, sizeof(locked_storage) / sizeof(uint32_t), locked_storage);
+    pthread_mutex_init(&ctx.lock, NULL);
+    ctx.use_lock = use_lock;
+    ctx.items_per_producer = BENCH_ITEMS / producers;
+    ctx.total = ctx.items_per_producer * producers;
+    ctx.consumed = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (uint32_t i = 0; i < consumers; i++) {
+        pthread_create(&threads[i], NULL, consumer, &ctx);
+    }
+
+    for (uint32_t i = 0; i < producers; i++) {
+        pthread_create(&threads[consumers + i], NULL, producer, &ctx);
+    }
+
+    for (uint32_t i = 0; i < consumers + producers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    pthread_mutex_destroy(&ctx.lock);
+
+    double seconds = (double) (end.tv_sec - start.tv_sec) +
+                     (double) (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    return (double) ctx.total / seconds / 1e6;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t max_threads = 4;
+
+    if (argc > 1) {
+        max_threads = (uint32_t) strtoul(argv[1], NULL, 0);
+    }
+
+    if (max_threads == 0 || max_threads > BENCH_MAX_THREADS) {
+        fprintf(stderr, "max_threads must be in 1..%u\n", BENCH_MAX_THREADS);
+        return 1;
+    }
+
+    printf("%-9s %-9s %14s %14s\n", "producers", "consumers", "mpmc Mitem/s", "mutex Mitem/s");
+
+    for (uint32_t p = 1; p <= max_threads; p++) {
+        for (uint32_t c = 1; c <= max_threads; c++) {
+            double lock_free = run(false, p, c);
+            double locked = run(true, p, c);
+
+            printf("%-9u %-9u %14.2f %14.2f\n", p, c, lock_free, locked);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Cross-core ping-pong latency benchmark for struct ring_buf.
+ *
+ * Two threads, optionally pinned to two CPUs, bounce an 8 byte message
+ * through a pair of rings. The reported figure is the average round trip
+ * time, which is dominated by cache line transfers between the cores. It
+ * is measured without statistics, then with statistics enabled on both
+ * rings; build it with -DRING_BUF_NO_STATS to measure them compiled out.
+ *
+ * Build and run:
+ *   gcc -O2 -std=c11 -Isrc bench/bench_ring_buffer_pingpong.c \
+ *       src/ring_buffer.c src/crc.c -lpthread -o bench_pingpong
+ *   ./bench_pingpong [cpu_a cpu_b]
+ */
+
+#define _GNU_SOURCE
+
+#include "ring_buffer.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#define BENCH_ROUND_TRIPS 1000000u
+#define BENCH_MSG_SIZE    8u
+
+static struct ring_buf ping;
+static struct ring_buf pong;
+static uint8_t ping_storage[256];
+static uint8_t pong_storage[256];
+static struct ring_buf_counters ping_counters;
+static struct ring_buf_counters pong_counters;
+
+static void pin(int cpu)
+{
+    cpu_set_t set;
+
+    if (cpu < 0) {
+        return;
+    }
+
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        fprintf(stderr, "cannot pin to cpu %d\n", cpu);
+    }
+}
+
+static void transfer(struct ring_buf *rb, const uint8_t *msg, uint8_t *out)
+{
+    if (msg) {
+        while (ring_buf_space_get(rb) < BENCH_MSG_SIZE) {
+            sched_yield();
+        }
+        ring_buf_put(rb, msg, BENCH_MSG_SIZE);
+    } else {
+        uint32_t received = 0;
+
+        while (received < BENCH_MSG_SIZE) {
+            uint32_t size = ring_buf_get(rb, out + received, BENCH_MSG_SIZE - received);
+
+            if (size == 0) {
+                sched_yield();
+            }
+
+            received += size;
+        }
+    }
+}
+
+static void *echo(void *arg)
+{
+    uint8_t msg[BENCH_MSG_SIZE];
+
+    pin(*(int *) arg);
+
+    for (uint32_t i = 0; i < BENCH_ROUND_TRIPS; i++) {
+        transfer(&ping, NULL, msg);
+        transfer(&pong, msg, NULL);
+    }
+
+    return NULL;
+}
+
+/* Average round trip time, in nanoseconds. */
+static double run(bool stats, int cpu_a, int cpu_b)
+{
+    pthread_t thread;
+    uint8_t msg[BENCH_MSG_SIZE] = {0};
+    struct timespec start;
+    struct timespec end;
+
+    ring_buf_init(&ping, sizeof(ping_storage), ping_storage);
+    ring_buf_init(&pong, sizeof(pong_storage), pong_storage);
+
+    if (stats) {
+        ring_buf_stats_enable(&ping, &ping_counters);
+        ring_buf_stats_enable(&pong, &pong_counters);
+    }
+
+    pin(cpu_a);
+    pthread_create(&thread, NULL, echo, &cpu_b);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (uint32_t i = 0; i < BENCH_ROUND_TRIPS; i++) {
+        msg[0] = (uint8_t) i;
+        transfer(&ping, msg, NULL);
+        transfer(&pong, NULL, msg);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    pthread_join(thread, NULL);
+
+    double ns = (double) (end.tv_sec - start.tv_sec) * 1e9 +
+                (double) (end.tv_nsec - start.tv_nsec);
+
+    return ns / BENCH_ROUND_TRIPS;
+}
+
+int main(int argc, char **argv)
+{
+    int cpu_a = -1;
+    int cpu_b = -1;
+
+    if (argc > 2) {
+        cpu_a = atoi(argv[1]);
+        cpu_b = atoi(argv[2]);
+    }
+
+    printf("struct ring_buf: %zu bytes\n", sizeof(struct ring_buf));
+    printf("round trip, stats off: %.1f ns\n", run(false, cpu_a, cpu_b));
+    printf("round trip, stats on:  %.1f ns\n", run(true, cpu_a, cpu_b));
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Single thread benchmark of RING_BUF_DECLARE_POW2 against struct ring_buf.
+ *
+ * Both rings are 4096 bytes. Every iteration puts one chunk and gets it
+ * back, so the indices walk through every wrap position.
+ *
+ * Build and run:
+ *   gcc -O2 -std=c11 -Isrc bench/bench_ring_buffer_pow2.c src/ring_buffer.c \
+ *       -o bench_pow2
+ *   ./bench_pow2
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ring_buffer.h"
+#include "ring_buffer_pow2.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_RING_SIZE 4096u
+#define BENCH_BYTES     (512u * 1024u * 1024u)
+
+RING_BUF_DECLARE_POW2(pow2_rb, BENCH_RING_SIZE);
+
+static struct ring_buf generic_rb;
+static uint8_t generic_storage[BENCH_RING_SIZE];
+static volatile uint8_t sink;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+static double bench_generic(uint32_t chunk)
+{
+    uint8_t in[256] = {1};
+    uint8_t out[256];
+    uint32_t iterations = BENCH_BYTES / chunk;
+
+    ring_buf_init(&generic_rb, sizeof(generic_storage), generic_storage);
+    /* offset the indices so chunks straddle the wrap point */
+    ring_buf_put(&generic_rb, in, 3);
+
+    double start = now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        ring_buf_put(&generic_rb, in, chunk);
+        ring_buf_get(&generic_rb, out, chunk);
+        sink = out[0];
+    }
+
+    return (now_ns() - start) / iterations;
+}
+
+static double bench_pow2(uint32_t chunk)
+{
+    uint8_t in[256] = {1};
+    uint8_t out[256];
+    uint32_t iterations = BENCH_BYTES / chunk;
+
+    pow2_rb_reset();
+    /* offset the indices so chunks straddle the wrap point */
+    pow2_rb_put(in, 3);
+
+    double start = now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        pow2_rb_put(in, chunk);
+        pow2_rb_get(out, chunk);
+        sink = out[0];
+    }
+
+    return (now_ns() - start) / iterations;
+}
+
+static double bench_generic_claim(uint32_t chunk)
+{
+    uint32_t iterations = BENCH_BYTES / chunk;
+    uint8_t *ptr;
+
+    ring_buf_init(&generic_rb, sizeof(generic_storage), generic_storage);
+
+    double start = now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint32_t size = ring_buf_put_claim(&generic_rb, &ptr, chunk);
+        ptr[0] = (uint8_t) i;
+        ring_buf_put_finish(&generic_rb, size);
+        size = ring_buf_get_claim(&generic_rb, &ptr, chunk);
+        sink = ptr[0];
+        ring_buf_get_finish(&generic_rb, size);
+    }
+
+    return (now_ns() - start) / iterations;
+}
+
+static double bench_pow2_claim(uint32_t chunk)
+{
+    uint32_t iterations = BENCH_BYTES / chunk;
+    uint8_t *ptr;
+
+    pow2_rb_reset();
+
+    double start = now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint32_t size = pow2_rb_put_claim(&ptr, chunk);
+        ptr[0] = (uint8_t) i;
+        pow2_rb_put_finish(size);
+        size = pow2_rb_get_claim(&ptr, chunk);
+        sink = ptr[0];
+        pow2_rb_get_finish(size);
+    }
+
+    return (now_ns() - start) / iterations;
+}
+
+int main(void)
+{
+    static const uint32_t chunks[] = {1, 4, 16, 64, 256};
+
+    printf("%-6s %-12s %12s %12s %8s\n", "chunk", "operation", "generic ns", "pow2 ns", "speedup");
+
+    for (uint32_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        double generic = bench_generic(chunks[i]);
+        double pow2 = bench_pow2(chunks[i]);
+
+        printf("%-6u %-12s %12.2f %12.2f %7.2fx\n", chunks[i], "put+get",
+               generic, pow2, generic / pow2);
+
+        generic = bench_generic_claim(chunks[i]);
+        pow2 = bench_pow2_claim(chunks[i]);
+
+        printf("%-6u %-12s %12.2f %12.2f %7.2fx\n", chunks[i], "claim+finish",
+               generic, pow2, generic / pow2);
+    }
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Single thread benchmark of RING_BUF_DEFINE_TYPED against struct ring_buf
+ * byte and item modes, moving one 8 byte struct per operation.
+ *
+ * Every iteration pushes a burst of elements and pops them back, so the
+ * indices walk through every wrap position.
+ *
+ * Build and run:
+ *   gcc -O2 -std=c11 -Isrc bench/bench_ring_buffer_typed.c src/ring_buffer.c \
+ *       -o bench_typed
+ *   ./bench_typed
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ring_buffer.h"
+#include "ring_buffer_typed.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_CAPACITY 256u
+#define BENCH_BURST    7u
+#define BENCH_ELEMENTS (64u * 1024u * 1024u)
+
+struct bench_sample {
+    uint16_t channel;
+    int16_t value;
+    uint32_t timestamp;
+};
+
+RING_BUF_DEFINE_TYPED(typed_rb, struct bench_sample, BENCH_CAPACITY);
+
+static struct ring_buf generic_rb;
+static uint32_t generic_storage[BENCH_CAPACITY * 3u];
+static volatile uint32_t sink;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+static double bench_typed(void)
+{
+    struct bench_sample in = {.channel = 1, .value = -1};
+    struct bench_sample out = {0};
+
+    typed_rb_reset();
+
+    double start = now_ns();
+    for (uint32_t i = 0; i < BENCH_ELEMENTS; i += BENCH_BURST) {
+        for (uint32_t j = 0; j < BENCH_BURST; j++) {
+            in.timestamp = i + j;
+            typed_rb_push(in);
+        }
+        for (uint32_t j = 0; j < BENCH_BURST; j++) {
+            typed_rb_pop(&out);
+            sink = out.timestamp;
+        }
+    }
+
+    return (now_ns() - start) / BENCH_ELEMENTS;
+}
+
+static double bench_bytes(void)
+{
+    struct bench_sample in = {.channel = 1, .value = -1};
+    struct bench_sample out = {0};
+
+    ring_buf_init(&generic_rb, BENCH_CAPACITY * sizeof(in), (uint8_t *) generic_storage);
+
+    double start = now_ns();
+    for (uint32_t i = 0; i < BENCH_ELEMENTS; i += BENCH_BURST) {
+        for (uint32_t j = 0; j < BENCH_BURST; j++) {
+            in.timestamp = i + j;
+            ring_buf_put(&generic_rb, (const uint8_t *) &in, sizeof(in));
+        }
+        for (uint32_t j = 0; j < BENCH_BURST; j++) {
+            ring_buf_get(&generic_rb, (uint8_t *) &out, sizeof(out));
+            sink = out.timestamp;
+        }
+    }
+
+    return (now_ns() - start) / BENCH_ELEMENTS;
+}
+
+static double bench_item(void)
+{
+    uint32_t in[2] = {1, 0};
+    uint32_t out[2] = {0};
+    uint16_t type;
+    uint8_t value;
+
+    ring_buf_item_init(&generic_rb, BENCH_CAPACITY * 3u, generic_storage);
+
+    double start = now_ns();
+    for (uint32_t i = 0; i < BENCH_ELEMENTS; i += BENCH_BURST) {
+        for (uint32_t j = 0; j < BENCH_BURST; j++) {
+            in[1] = i + j;
+            ring_buf_item_put(&generic_rb, 0, 0, in, 2);
+        }
+        for (uint32_t j = 0; j < BENCH_BURST; j++) {
+            uint8_t size32 = 2;
+
+            ring_buf_item_get(&generic_rb, &type, &value, out, &size32);
+            sink = out[1];
+        }
+    }
+
+    return (now_ns() - start) / BENCH_ELEMENTS;
+}
+
+int main(void)
+{
+    double typed = bench_typed();
+    double bytes = bench_bytes();
+    double item = bench_item();
+
+    printf("%-22s %10s\n", "operation", "ns/element");
+    printf("%-22s %10.2f\n", "typed push+pop", typed);
+    printf("%-22s %10.2f\n", "ring_buf put+get", bytes);
+    printf("%-22s %10.2f\n", "ring_buf item put+get", item);
+
+    return 0;
+}
@@ -57,6 +57,20 @@ void crc_ieee_802_3_update(struct crc_ieee_802_3_ctx *ctx, const void *data, siz
  */
 void crc_ieee_802_3_update_fast(struct crc_ieee_802_3_ctx *ctx, const void *data, size_t len);
 
+/**
+ * @brief Copies data while updating the IEEE 802.3 CRC calculation with it.
+ *
+ * Same result as a copy followed by crc_ieee_802_3_update_fast, but the data
+ * is only read once, while it is copied.
+ *
+ * @param ctx Pointer to the IEEE 802.3 CRC context structure.
+ * @param dst Pointer to the destination of the copy.
+ * @param src Pointer to the data to copy and process.
+ * @param len Length of the data in bytes.
+ */
+void crc_ieee_802_3_update_copy(struct crc_ieee_802_3_ctx *ctx, void *dst, const void *src,
+                                size_t len);
+
 /**
  * @brief Finalizes the IEEE 802.3 CRC calculation.
  *
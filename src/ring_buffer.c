@@ -5,6 +5,7 @@
  */
 
 #include "ring_buffer.h"
+#include "crc.h"
 
 #include <string.h>
 #include <assert.h>
@@ -12,6 +13,45 @@
 #define RING_BUFFER_SIZE_ASSERT_MSG "Size too big"
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 
+/* Record mode: length header, and header value marking skipped bytes. */
+#define RECORD_HEADER_SIZE sizeof(uint32_t)
+#define RECORD_SKIP        0xffffffffu
+#define RECORD_ALIGN(size) (((size) + 3u) & ~3u)
+
+/*
+ * put_tail and get_tail are the only indices shared between the producer and
+ * the consumer. They are published with release semantics once the data (or
+ * the free space) they cover is ready, and observed with acquire semantics by
+ * the opposite side. All remaining indices are private to one side.
+ *
+ * With RING_BUF_FLAG_OVERWRITE the producer may also move get_tail to drop
+ * data, so both sides advance it with a compare-and-swap, and the consumer
+ * keeps its own copy in get_tail_local to tell whether it was moved.
+ */
+#define RING_BUF_LOAD_ACQUIRE(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define RING_BUF_STORE_RELEASE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+
+/*
+ * Statistics counters have a single writer, and are stored relaxed so that
+ * a snapshot taken from another thread reads whole values.
+ */
+#ifndef RING_BUF_NO_STATS
+#define RING_BUF_STAT_ADD(rb, name, val)                                     \
+    do {                                                                     \
+        struct ring_buf_counters *counters_ = (rb)->stats;                  \
+                                                                             \
+        if (counters_ != NULL) {                                             \
+            __atomic_store_n(&counters_->name, counters_->name + (val),      \
+                             __ATOMIC_RELAXED);                              \
+        }                                                                    \
+    } while (0)
+#define RING_BUF_STAT_INC(rb, name) RING_BUF_STAT_ADD(rb, name, 1u)
+#define RING_BUF_STAT_GET(counters, name) __atomic_load_n(&(counters)->name, __ATOMIC_RELAXED)
+#else
+#define RING_BUF_STAT_ADD(rb, name, val) ((void) 0)
+#define RING_BUF_STAT_INC(rb, name) ((void) 0)
+#endif
+
 
 /**
  * Internal data structure for a buffer header.
@@ -27,8 +67,27 @@ struct ring_element {
 
 
 static void ring_buf_internal_reset(struct ring_buf *rb, uint32_t value);
+static uint32_t ring_buf_put_space(struct ring_buf *rb, uint32_t size);
+static uint32_t ring_buf_get_available(struct ring_buf *rb, uint32_t size);
+static uint32_t ring_buf_get_copy(struct ring_buf *rb, uint8_t *data, uint32_t size);
+static int32_t ring_buf_get_finish_shared(struct ring_buf *rb, uint32_t size);
+static uint32_t ring_buf_drop_shared(struct ring_buf *rb, uint32_t size);
+static uint32_t ring_buf_item_drop_shared(struct ring_buf *rb, uint32_t size);
+static int32_t ring_buf_item_read(struct ring_buf *rb, uint16_t *type, uint8_t *value,
+                                  uint32_t *data32, uint8_t *size32);
 static uint32_t ring_element_to_uint32(struct ring_element *re);
 static struct ring_element uint32_to_ring_element(uint32_t header);
+static uint32_t record_header_get(struct ring_buf *rb, uint32_t offset);
+static void record_header_set(struct ring_buf *rb, uint32_t offset, uint32_t header);
+static void ring_buf_stats_fill_update(struct ring_buf *rb);
+static uint32_t ring_buf_get_segments(struct ring_buf *rb, uint8_t *seg[2],
+                                      uint32_t seg_size[2]);
+static int32_t ring_buf_segments_find(uint8_t *seg[2], uint32_t seg_size[2], uint8_t byte,
+                                      uint32_t start, uint32_t end);
+static bool ring_buf_segments_match(uint8_t *seg[2], uint32_t seg_size[2], uint32_t offset,
+                                    const uint8_t *seq, uint32_t len);
+static void ring_buf_segments_copy(uint8_t *seg[2], uint32_t seg_size[2], uint32_t offset,
+                                   uint8_t *dst, uint32_t len);
 
 
 void ring_buf_init(struct ring_buf *rb, uint32_t size, uint8_t *data)
@@ -37,6 +96,8 @@ void ring_buf_init(struct ring_buf *rb, uint32_t size, uint8_t *data)
 
     rb->size = size;
     rb->buffer = data;
+    rb->flags = 0;
+    rb->stats = NULL;
     ring_buf_internal_reset(rb, 0);
 }
 
@@ -47,9 +108,15 @@ void ring_buf_item_init(struct ring_buf *rb, uint32_t size, uint32_t *data)
     ring_buf_init(rb, size * sizeof(uint32_t), (uint8_t *) data);
 }
 
+void ring_buf_item_checked_init(struct ring_buf *rb, uint32_t size, uint32_t *data)
+{
+    ring_buf_item_init(rb, size, data);
+    rb->flags |= RING_BUF_FLAG_ITEM_CRC;
+}
+
 bool ring_buf_is_empty(struct ring_buf *rb)
 {
-    return rb->get_head == rb->put_tail;
+    return rb->get_head == RING_BUF_LOAD_ACQUIRE(&rb->put_tail);
 }
 
 void ring_buf_reset(struct ring_buf *rb)
@@ -59,7 +126,7 @@ void ring_buf_reset(struct ring_buf *rb)
 
 uint32_t ring_buf_space_get(struct ring_buf *rb)
 {
-    return rb->size - (rb->put_head - rb->get_tail);
+    return rb->size - (rb->put_head - RING_BUF_LOAD_ACQUIRE(&rb->get_tail));
 }
 
 uint32_t ring_buf_item_space_get(struct ring_buf *rb)
@@ -74,7 +141,7 @@ uint32_t ring_buf_capacity_get(struct ring_buf *rb)
 
 uint32_t ring_buf_size_get(struct ring_buf *rb)
 {
-    return rb->put_tail - rb->get_head;
+    return RING_BUF_LOAD_ACQUIRE(&rb->put_tail) - rb->get_head;
 }
 
 uint32_t ring_buf_put_claim(struct ring_buf *rb, uint8_t **data, uint32_t size)
@@ -88,11 +155,25 @@ uint32_t ring_buf_put_claim(struct ring_buf *rb, uint8_t **data, uint32_t size)
         base += rb->size;
     }
 
-    wrap_size = rb->size - wrap_size;
+    if (rb->flags & RING_BUF_FLAG_MIRRORED) {
+        /* the mirror mapping makes the whole capacity contiguous */
+        wrap_size = rb->size;
+    } else {
+        wrap_size = rb->size - wrap_size;
+    }
+
+    uint32_t free_space = ring_buf_put_space(rb, size);
 
-    uint32_t free_space = ring_buf_space_get(rb);
+    if ((free_space < size) && (rb->put_head == rb->put_tail)) {
+        RING_BUF_STAT_INC(rb, put_full);
+    }
 
     size = MIN(size, free_space);
+
+    if (wrap_size < size) {
+        RING_BUF_STAT_INC(rb, put_wrap);
+    }
+
     size = MIN(size, wrap_size);
 
     *data = &rb->buffer[rb->put_head - base];
@@ -109,10 +190,17 @@ int32_t ring_buf_put_finish(struct ring_buf *rb, uint32_t size)
         return -1;
     }
 
-    rb->put_tail += size;
-    rb->put_head = rb->put_tail;
+    uint32_t put_tail = rb->put_tail + size;
 
-    uint32_t wrap_size = rb->put_tail - rb->put_base;
+    rb->put_head = put_tail;
+    RING_BUF_STORE_RELEASE(&rb->put_tail, put_tail);
+
+    if (size) {
+        RING_BUF_STAT_ADD(rb, bytes_in, size);
+        ring_buf_stats_fill_update(rb);
+    }
+
+    uint32_t wrap_size = put_tail - rb->put_base;
 
     if (wrap_size >= rb->size) {
         /* we wrapped: adjust put_base */
@@ -143,6 +231,40 @@ uint32_t ring_buf_put(struct ring_buf *rb, const uint8_t *data, uint32_t size)
     return total_size;
 }
 
+uint32_t ring_buf_put_overwrite(struct ring_buf *rb, const uint8_t *data,
+                                uint32_t size)
+{
+    if (size > rb->size) {
+        /* only the newest bytes can be kept */
+        rb->dropped_bytes += size - rb->size;
+        data += size - rb->size;
+        size = rb->size;
+    }
+
+    if (rb->flags & RING_BUF_FLAG_OVERWRITE) {
+        rb->dropped_bytes += ring_buf_drop_shared(rb, size);
+    } else {
+        uint32_t space = ring_buf_space_get(rb);
+
+        if (size > space) {
+            rb->dropped_bytes += ring_buf_get(rb, NULL, size - space);
+        }
+    }
+
+    return ring_buf_put(rb, data, size);
+}
+
+uint32_t ring_buf_dropped_get(struct ring_buf *rb)
+{
+    return rb->dropped_bytes;
+}
+
+void ring_buf_overwrite_enable(struct ring_buf *rb)
+{
+    rb->flags |= RING_BUF_FLAG_OVERWRITE;
+    rb->get_tail_local = rb->get_tail;
+}
+
 uint32_t ring_buf_get_claim(struct ring_buf *rb, uint8_t **data, uint32_t size)
 {
     uint32_t base = rb->get_base;
@@ -154,11 +276,26 @@ uint32_t ring_buf_get_claim(struct ring_buf *rb, uint8_t **data, uint32_t size)
         base += rb->size;
     }
 
-    wrap_size = rb->size - wrap_size;
+    if (rb->flags & RING_BUF_FLAG_MIRRORED) {
+        /* the mirror mapping makes the whole capacity contiguous */
+        wrap_size = rb->size;
+    } else {
+        wrap_size = rb->size - wrap_size;
+    }
+
+    uint32_t available_size = ring_buf_get_available(rb, size);
 
-    uint32_t available_size = ring_buf_size_get(rb);
+    if ((available_size == 0) && (size != 0) &&
+        (rb->get_head == RING_BUF_LOAD_ACQUIRE(&rb->get_tail))) {
+        RING_BUF_STAT_INC(rb, get_empty);
+    }
 
     size = MIN(size, available_size);
+
+    if (wrap_size < size) {
+        RING_BUF_STAT_INC(rb, get_wrap);
+    }
+
     size = MIN(size, wrap_size);
 
     *data = &rb->buffer[rb->get_head - base];
@@ -169,16 +306,23 @@ uint32_t ring_buf_get_claim(struct ring_buf *rb, uint8_t **data, uint32_t size)
 
 int32_t ring_buf_get_finish(struct ring_buf *rb, uint32_t size)
 {
+    if (rb->flags & RING_BUF_FLAG_OVERWRITE) {
+        return ring_buf_get_finish_shared(rb, size);
+    }
+
     uint32_t finish_space = rb->get_head - rb->get_tail;
 
     if (size > finish_space) {
         return -1;
     }
 
-    rb->get_tail += size;
-    rb->get_head = rb->get_tail;
+    uint32_t get_tail = rb->get_tail + size;
 
-    uint32_t wrap_size = rb->get_tail - rb->get_base;
+    rb->get_head = get_tail;
+    RING_BUF_STORE_RELEASE(&rb->get_tail, get_tail);
+    RING_BUF_STAT_ADD(rb, bytes_out, size);
+
+    uint32_t wrap_size = get_tail - rb->get_base;
 
     if (wrap_size >= rb->size) {
         /* we wrapped: adjust get_base */
@@ -190,23 +334,15 @@ int32_t ring_buf_get_finish(struct ring_buf *rb, uint32_t size)
 
 uint32_t ring_buf_get(struct ring_buf *rb, uint8_t *data, uint32_t size)
 {
-    uint32_t total_size = 0;
-    uint32_t partial_size;
+    uint32_t total_size;
+    int32_t finish_result;
 
     do {
-        uint8_t *src;
-        partial_size = ring_buf_get_claim(rb, &src, size);
+        /* read again if an overwriting put dropped the data meanwhile */
+        total_size = ring_buf_get_copy(rb, data, size);
+        finish_result = ring_buf_get_finish(rb, total_size);
+    } while (finish_result == -2);
 
-        if (data) {
-            memcpy(data, src, partial_size);
-            data += partial_size;
-        }
-
-        total_size += partial_size;
-        size -= partial_size;
-    } while (size && partial_size);
-
-    int32_t finish_result = ring_buf_get_finish(rb, total_size);
     assert(finish_result == 0);
     (void) finish_result;
 
@@ -215,38 +351,75 @@ uint32_t ring_buf_get(struct ring_buf *rb, uint8_t *data, uint32_t size)
 
 uint32_t ring_buf_peek(struct ring_buf *rb, uint8_t *data, uint32_t size)
 {
-    uint32_t total_size = 0;
+    uint32_t total_size;
+    int32_t finish_result;
 
-    size = MIN(size, ring_buf_size_get(rb));
+    assert(data != NULL);
 
-    uint32_t partial_size;
     do {
-        uint8_t *src;
-        partial_size = ring_buf_get_claim(rb, &src, size);
-        assert(data != NULL);
-        memcpy(data, src, partial_size);
-        data += partial_size;
-        total_size += partial_size;
-        size -= partial_size;
-    } while (size && partial_size);
+        total_size = ring_buf_get_copy(rb, data, size);
+        /* effectively unclaim total_size bytes */
+        finish_result = ring_buf_get_finish(rb, 0);
+    } while (finish_result == -2);
 
-    /* effectively unclaim total_size bytes */
-    int32_t finish_result = ring_buf_get_finish(rb, 0);
     assert(finish_result == 0);
     (void) finish_result;
 
     return total_size;
 }
 
+int32_t ring_buf_find_byte(struct ring_buf *rb, uint8_t byte, uint32_t start)
+{
+    uint8_t *seg[2];
+    uint32_t seg_size[2];
+    uint32_t available = ring_buf_get_segments(rb, seg, seg_size);
+
+    return ring_buf_segments_find(seg, seg_size, byte, start, available);
+}
+
+int32_t ring_buf_find_seq(struct ring_buf *rb, const uint8_t *seq, uint32_t len,
+                          uint32_t start)
+{
+    uint8_t *seg[2];
+    uint32_t seg_size[2];
+    uint32_t available = ring_buf_get_segments(rb, seg, seg_size);
+
+    if ((len > available) || (start > available - len)) {
+        return -1;
+    }
+
+    if (len == 0) {
+        return (int32_t) start;
+    }
+
+    /* candidates are the occurrences of the first byte */
+    uint32_t end = available - len + 1;
+    int32_t offset;
+
+    while ((offset = ring_buf_segments_find(seg, seg_size, seq[0], start, end)) >= 0) {
+        if (ring_buf_segments_match(seg, seg_size, (uint32_t) offset + 1, &seq[1], len - 1)) {
+            return offset;
+        }
+
+        start = (uint32_t) offset + 1;
+    }
+
+    return -1;
+}
+
 int32_t ring_buf_item_put(struct ring_buf *rb, uint16_t type, uint8_t value,
                           uint32_t *data32, uint8_t size32)
 {
     uint8_t *data = (uint8_t *) data32;
 
-    uint32_t space = ring_buf_space_get(rb);
+    bool checked = (rb->flags & RING_BUF_FLAG_ITEM_CRC) != 0;
+    uint32_t trailer_size = checked ? sizeof(uint32_t) : 0;
     uint32_t size = size32 * sizeof(uint32_t);
+    uint32_t space = ring_buf_put_space(rb, size + sizeof(uint32_t) + trailer_size);
+
+    if (size + sizeof(uint32_t) + trailer_size > space) {
+        RING_BUF_STAT_INC(rb, put_full);
 
-    if (size + sizeof(uint32_t) > space) {
         return -2;
     }
 
@@ -264,12 +437,23 @@ int32_t ring_buf_item_put(struct ring_buf *rb, uint16_t type, uint8_t value,
     uint32_t header_u32 = ring_element_to_uint32(&header);
     memcpy(dst, &header_u32, sizeof(header_u32));
 
+    struct crc_ieee_802_3_ctx crc;
+
+    if (checked) {
+        crc_ieee_802_3_init(&crc);
+        crc_ieee_802_3_update_fast(&crc, &header_u32, sizeof(header_u32));
+    }
+
     uint32_t total_size = sizeof(uint32_t);
 
     uint32_t partial_size;
     do {
         partial_size = ring_buf_put_claim(rb, &dst, size);
-        memcpy(dst, data, partial_size);
+        if (checked) {
+            crc_ieee_802_3_update_copy(&crc, dst, data, partial_size);
+        } else {
+            memcpy(dst, data, partial_size);
+        }
         size -= partial_size;
         total_size += partial_size;
         data += partial_size;
@@ -277,19 +461,89 @@ int32_t ring_buf_item_put(struct ring_buf *rb, uint16_t type, uint8_t value,
 
     assert(size == 0);
 
+    if (checked) {
+        uint32_t crc_u32 = crc_ieee_802_3_final(&crc);
+
+        claim_result = ring_buf_put_claim(rb, &dst, sizeof(uint32_t));
+        assert(claim_result == sizeof(uint32_t));
+        memcpy(dst, &crc_u32, sizeof(crc_u32));
+        total_size += sizeof(uint32_t);
+    }
+
     int32_t finish_result = ring_buf_put_finish(rb, total_size);
     assert(finish_result == 0);
     (void) finish_result;
+    RING_BUF_STAT_INC(rb, items_in);
 
     return 0;
 }
 
+int32_t ring_buf_item_put_overwrite(struct ring_buf *rb, uint16_t type,
+                                    uint8_t value, uint32_t *data,
+                                    uint8_t size32)
+{
+    uint32_t size = size32 * sizeof(uint32_t) + sizeof(uint32_t);
+
+    if (rb->flags & RING_BUF_FLAG_ITEM_CRC) {
+        size += sizeof(uint32_t);
+    }
+
+    if (size > rb->size) {
+        return -2;
+    }
+
+    if (rb->flags & RING_BUF_FLAG_OVERWRITE) {
+        rb->dropped_items += ring_buf_item_drop_shared(rb, size);
+    } else {
+        /* drop whole items, oldest first, until the new one fits */
+        while (ring_buf_space_get(rb) < size) {
+            uint16_t dropped_type;
+            uint8_t dropped_value;
+            uint8_t dropped_size32 = 0;
+
+            int32_t get_result = ring_buf_item_get(rb, &dropped_type, &dropped_value,
+                                                   NULL, &dropped_size32);
+            assert(get_result == 0 || get_result == -3);
+            (void) get_result;
+
+            rb->dropped_items++;
+        }
+    }
+
+    return ring_buf_item_put(rb, type, value, data, size32);
+}
+
+uint32_t ring_buf_item_dropped_get(struct ring_buf *rb)
+{
+    return rb->dropped_items;
+}
+
 int32_t ring_buf_item_get(struct ring_buf *rb, uint16_t *type, uint8_t *value,
                           uint32_t *data32, uint8_t *size32)
+{
+    uint8_t capacity = *size32;
+    int32_t result;
+
+    /* read again if an overwriting put dropped the item meanwhile */
+    while ((result = ring_buf_item_read(rb, type, value, data32, size32)) == -4) {
+        *size32 = capacity;
+    }
+
+    return result;
+}
+
+/*
+ * Body of ring_buf_item_get. Returns -4 when the item was dropped by an
+ * overwriting put while it was read.
+ */
+static int32_t ring_buf_item_read(struct ring_buf *rb, uint16_t *type, uint8_t *value,
+                                  uint32_t *data32, uint8_t *size32)
 {
     uint8_t *data = (uint8_t *) data32;
 
-    if (ring_buf_is_empty(rb)) {
+    if (ring_buf_get_available(rb, sizeof(uint32_t)) == 0) {
+        RING_BUF_STAT_INC(rb, get_empty);
+
         return -1;
     }
 
@@ -304,15 +558,22 @@ int32_t ring_buf_item_get(struct ring_buf *rb, uint16_t *type, uint8_t *value,
 
     if (data && (header.length > *size32)) {
         *size32 = header.length;
-        ring_buf_get_finish(rb, 0);
 
-        return -2;
+        return (ring_buf_get_finish(rb, 0) == -2) ? -4 : -2;
     }
 
     *size32 = header.length;
     *type = header.type;
     *value = header.value;
 
+    bool checked = (rb->flags & RING_BUF_FLAG_ITEM_CRC) != 0;
+    struct crc_ieee_802_3_ctx crc;
+
+    if (checked) {
+        crc_ieee_802_3_init(&crc);
+        crc_ieee_802_3_update_fast(&crc, &header_u32, sizeof(header_u32));
+    }
+
     uint32_t total_size = sizeof(struct ring_element);
     uint32_t size = *size32 * sizeof(uint32_t);
 
@@ -320,30 +581,533 @@ int32_t ring_buf_item_get(struct ring_buf *rb, uint16_t *type, uint8_t *value,
     do {
         partial_size = ring_buf_get_claim(rb, &src, size);
 
-        if (data) {
+        if (data && checked) {
+            crc_ieee_802_3_update_copy(&crc, data, src, partial_size);
+            data += partial_size;
+        } else if (data) {
             memcpy(data, src, partial_size);
             data += partial_size;
+        } else if (checked) {
+            crc_ieee_802_3_update_fast(&crc, src, partial_size);
         }
 
         total_size += partial_size;
         size -= partial_size;
     } while (size && partial_size);
 
+    int32_t result = 0;
+
+    if (checked) {
+        uint32_t crc_u32;
+
+        /* a truncated item (corrupted length) fails the check as well */
+        if (size != 0 || ring_buf_get_claim(rb, &src, sizeof(uint32_t)) != sizeof(uint32_t)) {
+            result = -3;
+        } else {
+            memcpy(&crc_u32, src, sizeof(crc_u32));
+            total_size += sizeof(uint32_t);
+
+            if (crc_u32 != crc_ieee_802_3_final(&crc)) {
+                result = -3;
+            }
+        }
+    }
+
     int32_t finish_result = ring_buf_get_finish(rb, total_size);
+
+    if (finish_result == -2) {
+        return -4;
+    }
+
+    assert(finish_result == 0);
+    (void) finish_result;
+    RING_BUF_STAT_INC(rb, items_out);
+
+    return result;
+}
+
+void ring_buf_item_iter_init(struct ring_buf_item_iter *it, struct ring_buf *rb)
+{
+    it->rb = rb;
+    it->offset = 0;
+    it->items = 0;
+    (void) ring_buf_get_segments(rb, it->seg, it->seg_size);
+}
+
+int32_t ring_buf_item_iter_next(struct ring_buf_item_iter *it, struct ring_buf_item_view *item)
+{
+    bool checked = (it->rb->flags & RING_BUF_FLAG_ITEM_CRC) != 0;
+    uint32_t trailer_size = checked ? sizeof(uint32_t) : 0;
+    uint32_t available = it->seg_size[0] + it->seg_size[1] - it->offset;
+
+    if (available < sizeof(uint32_t)) {
+        return -1;
+    }
+
+    uint32_t header_u32;
+    ring_buf_segments_copy(it->seg, it->seg_size, it->offset, (uint8_t *) &header_u32,
+                           sizeof(header_u32));
+    struct ring_element header = uint32_to_ring_element(header_u32);
+
+    uint32_t size = header.length * sizeof(uint32_t);
+
+    if (sizeof(uint32_t) + size + trailer_size > available) {
+        /* only a corrupted length can point past the committed data */
+        if (checked) {
+            it->offset += available;
+
+            return -3;
+        }
+
+        return -1;
+    }
+
+    uint32_t start = it->offset + sizeof(uint32_t);
+
+    item->type = header.type;
+    item->value = header.value;
+    item->size32 = header.length;
+
+    if (start < it->seg_size[0]) {
+        item->data[0] = &it->seg[0][start];
+        item->data_size[0] = MIN(size, it->seg_size[0] - start);
+        item->data[1] = it->seg[1];
+        item->data_size[1] = size - item->data_size[0];
+    } else {
+        item->data[0] = &it->seg[1][start - it->seg_size[0]];
+        item->data_size[0] = size;
+        item->data[1] = NULL;
+        item->data_size[1] = 0;
+    }
+
+    it->offset = start + size + trailer_size;
+    it->items++;
+
+    if (checked) {
+        struct crc_ieee_802_3_ctx crc;
+        uint32_t crc_u32;
+
+        crc_ieee_802_3_init(&crc);
+        crc_ieee_802_3_update_fast(&crc, &header_u32, sizeof(header_u32));
+        crc_ieee_802_3_update_fast(&crc, item->data[0], item->data_size[0]);
+        crc_ieee_802_3_update_fast(&crc, item->data[1], item->data_size[1]);
+        ring_buf_segments_copy(it->seg, it->seg_size, start + size, (uint8_t *) &crc_u32,
+                               sizeof(crc_u32));
+
+        if (crc_u32 != crc_ieee_802_3_final(&crc)) {
+            return -3;
+        }
+    }
+
+    return 0;
+}
+
+uint32_t ring_buf_item_iter_consume(struct ring_buf_item_iter *it)
+{
+    uint32_t items = it->items;
+    uint32_t read = ring_buf_get(it->rb, NULL, it->offset);
+
+    assert(read == it->offset);
+    (void) read;
+    RING_BUF_STAT_ADD(it->rb, items_out, items);
+
+    ring_buf_item_iter_init(it, it->rb);
+
+    return items;
+}
+
+int32_t ring_buf_item_peek(struct ring_buf *rb, uint32_t index, struct ring_buf_item_view *item)
+{
+    struct ring_buf_item_iter it;
+    int32_t result;
+
+    ring_buf_item_iter_init(&it, rb);
+
+    do {
+        result = ring_buf_item_iter_next(&it, item);
+    } while (index-- > 0 && result != -1);
+
+    return result;
+}
+
+void ring_buf_record_init(struct ring_buf *rb, uint32_t size, uint32_t *data)
+{
+    ring_buf_item_init(rb, size, data);
+}
+
+int32_t ring_buf_record_claim(struct ring_buf *rb, uint8_t **data, uint32_t size)
+{
+    if (size > rb->size) {
+        return -1;
+    }
+
+    uint32_t total_size = RECORD_HEADER_SIZE + RECORD_ALIGN(size);
+
+    /* The skipped bytes are always shorter than the record, so a record of
+     * up to half the storage fits wherever the previous one ended.
+     */
+    if (total_size > (rb->size + RECORD_HEADER_SIZE) / 2) {
+        return -1;
+    }
+
+    /* Offsets stay 32-bit aligned, as every record is */
+    uint32_t offset = rb->put_tail - rb->put_base;
+    uint32_t skip_size = 0;
+
+    if (total_size > rb->size - offset) {
+        /* not contiguous: skip up to the wrap point */
+        skip_size = rb->size - offset;
+    }
+
+    if (skip_size + total_size > ring_buf_put_space(rb, skip_size + total_size)) {
+        RING_BUF_STAT_INC(rb, put_full);
+
+        return -2;
+    }
+
+    if (skip_size) {
+        RING_BUF_STAT_INC(rb, put_wrap);
+        record_header_set(rb, offset, RECORD_SKIP);
+        offset = 0;
+    }
+
+    record_header_set(rb, offset, size);
+    rb->put_head = rb->put_tail + skip_size + total_size;
+    *data = &rb->buffer[offset + RECORD_HEADER_SIZE];
+
+    return 0;
+}
+
+int32_t ring_buf_record_commit(struct ring_buf *rb, uint32_t size)
+{
+    if (rb->put_head == rb->put_tail) {
+        return -1;
+    }
+
+    uint32_t offset = rb->put_tail - rb->put_base;
+    uint32_t skip_size = 0;
+    uint32_t claimed_size = record_header_get(rb, offset);
+
+    if (claimed_size == RECORD_SKIP) {
+        skip_size = rb->size - offset;
+        offset = 0;
+        claimed_size = record_header_get(rb, offset);
+    }
+
+    if (size > claimed_size) {
+        return -1;
+    }
+
+    record_header_set(rb, offset, size);
+
+    int32_t finish_result = ring_buf_put_finish(rb, skip_size + RECORD_HEADER_SIZE +
+                                                RECORD_ALIGN(size));
     assert(finish_result == 0);
     (void) finish_result;
+    RING_BUF_STAT_INC(rb, items_in);
 
     return 0;
 }
 
+int32_t ring_buf_record_put(struct ring_buf *rb, const uint8_t *data, uint32_t size)
+{
+    uint8_t *dst;
+    int32_t claim_result = ring_buf_record_claim(rb, &dst, size);
+
+    if (claim_result != 0) {
+        return claim_result;
+    }
+
+    memcpy(dst, data, size);
+
+    return ring_buf_record_commit(rb, size);
+}
+
+int32_t ring_buf_record_peek(struct ring_buf *rb, uint8_t **data, uint32_t *size)
+{
+    /* a record peeked but not released yet is peeked again */
+    rb->get_head = rb->get_tail;
+
+    if (ring_buf_get_available(rb, RECORD_HEADER_SIZE) == 0) {
+        RING_BUF_STAT_INC(rb, get_empty);
+
+        return -1;
+    }
+
+    uint32_t offset = rb->get_tail - rb->get_base;
+    uint32_t skip_size = 0;
+    uint32_t header = record_header_get(rb, offset);
+
+    if (header == RECORD_SKIP) {
+        /* skipped bytes are always committed along with the next record */
+        skip_size = rb->size - offset;
+        offset = 0;
+        header = record_header_get(rb, offset);
+    }
+
+    rb->get_head = rb->get_tail + skip_size + RECORD_HEADER_SIZE + RECORD_ALIGN(header);
+    *data = &rb->buffer[offset + RECORD_HEADER_SIZE];
+    *size = header;
+
+    return 0;
+}
+
+int32_t ring_buf_record_release(struct ring_buf *rb)
+{
+    if (rb->get_head == rb->get_tail) {
+        return -1;
+    }
+
+    RING_BUF_STAT_INC(rb, items_out);
+
+    return ring_buf_get_finish(rb, rb->get_head - rb->get_tail);
+}
+
+int32_t ring_buf_record_get(struct ring_buf *rb, uint8_t *data, uint32_t *size)
+{
+    uint8_t *src;
+    uint32_t record_size;
+
+    if (ring_buf_record_peek(rb, &src, &record_size) != 0) {
+        return -1;
+    }
+
+    if (data && (record_size > *size)) {
+        *size = record_size;
+        ring_buf_get_finish(rb, 0);
+
+        return -2;
+    }
+
+    if (data) {
+        memcpy(data, src, record_size);
+    }
+
+    *size = record_size;
+
+    return ring_buf_record_release(rb);
+}
+
+void ring_buf_stats_enable(struct ring_buf *rb, struct ring_buf_counters *counters)
+{
+    rb->stats = counters;
+    ring_buf_stats_reset(rb);
+}
+
+int32_t ring_buf_stats_get(struct ring_buf *rb, struct ring_buf_stats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+
+#ifndef RING_BUF_NO_STATS
+    struct ring_buf_counters *counters = rb->stats;
+
+    if (counters == NULL) {
+        return -2;
+    }
+
+    stats->bytes_in = RING_BUF_STAT_GET(counters, bytes_in);
+    stats->bytes_out = RING_BUF_STAT_GET(counters, bytes_out);
+    stats->items_in = RING_BUF_STAT_GET(counters, items_in);
+    stats->items_out = RING_BUF_STAT_GET(counters, items_out);
+    stats->put_full = RING_BUF_STAT_GET(counters, put_full);
+    stats->get_empty = RING_BUF_STAT_GET(counters, get_empty);
+    stats->put_wrap = RING_BUF_STAT_GET(counters, put_wrap);
+    stats->get_wrap = RING_BUF_STAT_GET(counters, get_wrap);
+    stats->high_water = RING_BUF_STAT_GET(counters, high_water);
+
+    uint64_t fill_samples = RING_BUF_STAT_GET(counters, fill_samples);
+
+    if (fill_samples) {
+        stats->fill_avg = (uint32_t) (RING_BUF_STAT_GET(counters, fill_sum) / fill_samples);
+    }
+
+    return 0;
+#else
+    (void) rb;
+
+    return -2;
+#endif
+}
+
+void ring_buf_stats_reset(struct ring_buf *rb)
+{
+    if (rb->stats != NULL) {
+        memset(rb->stats, 0, sizeof(*rb->stats));
+    }
+}
+
 static void ring_buf_internal_reset(struct ring_buf *rb, uint32_t value)
 {
     rb->put_head = value;
     rb->put_tail = value;
     rb->put_base = value;
+    rb->get_tail_cache = value;
+    rb->dropped_bytes = 0;
+    rb->dropped_items = 0;
     rb->get_head = value;
     rb->get_tail = value;
     rb->get_base = value;
+    rb->put_tail_cache = value;
+    rb->get_tail_local = value;
+}
+
+/*
+ * Free space seen by the producer. The consumer index is only reloaded when
+ * the cached copy does not leave room for the requested size: a stale copy
+ * can only under-estimate the free space.
+ */
+static uint32_t ring_buf_put_space(struct ring_buf *rb, uint32_t size)
+{
+    uint32_t space = rb->size - (rb->put_head - rb->get_tail_cache);
+
+    if (space < size) {
+        rb->get_tail_cache = RING_BUF_LOAD_ACQUIRE(&rb->get_tail);
+        space = rb->size - (rb->put_head - rb->get_tail_cache);
+    }
+
+    return space;
+}
+
+/*
+ * Valid data seen by the consumer. The producer index is only reloaded when
+ * the cached copy does not cover the requested size: a stale copy can only
+ * under-estimate the valid data.
+ */
+static uint32_t ring_buf_get_available(struct ring_buf *rb, uint32_t size)
+{
+    uint32_t available = rb->put_tail_cache - rb->get_head;
+
+    if (available < size) {
+        rb->put_tail_cache = RING_BUF_LOAD_ACQUIRE(&rb->put_tail);
+        available = rb->put_tail_cache - rb->get_head;
+    }
+
+    return available;
+}
+
+static uint32_t ring_buf_get_copy(struct ring_buf *rb, uint8_t *data, uint32_t size)
+{
+    uint32_t total_size = 0;
+    uint32_t partial_size;
+
+    do {
+        uint8_t *src;
+        partial_size = ring_buf_get_claim(rb, &src, size);
+
+        if (data) {
+            memcpy(data, src, partial_size);
+            data += partial_size;
+        }
+
+        total_size += partial_size;
+        size -= partial_size;
+    } while (size && partial_size);
+
+    return total_size;
+}
+
+/*
+ * ring_buf_get_finish for RING_BUF_FLAG_OVERWRITE. The compare-and-swap
+ * fails if the producer dropped data since the consumer last committed: the
+ * claim may then cover overwritten bytes, so it is discarded and the
+ * consumer restarts from the index the producer left.
+ */
+static int32_t ring_buf_get_finish_shared(struct ring_buf *rb, uint32_t size)
+{
+    uint32_t get_tail = rb->get_tail_local;
+
+    if (size > rb->get_head - get_tail) {
+        return -1;
+    }
+
+    if (!__atomic_compare_exchange_n(&rb->get_tail, &get_tail, get_tail + size, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        rb->get_head = get_tail;
+        rb->get_tail_local = get_tail;
+        rb->get_base += ((get_tail - rb->get_base) / rb->size) * rb->size;
+        rb->put_tail_cache = RING_BUF_LOAD_ACQUIRE(&rb->put_tail);
+
+        return -2;
+    }
+
+    get_tail += size;
+    rb->get_head = get_tail;
+    rb->get_tail_local = get_tail;
+    RING_BUF_STAT_ADD(rb, bytes_out, size);
+
+    uint32_t wrap_size = get_tail - rb->get_base;
+
+    if (wrap_size >= rb->size) {
+        /* we wrapped: adjust get_base */
+        rb->get_base += rb->size;
+    }
+
+    return 0;
+}
+
+/*
+ * Producer side drop for RING_BUF_FLAG_OVERWRITE: move get_tail past the
+ * oldest bytes until size bytes are free. Returns the number of bytes
+ * dropped, which is 0 if the consumer freed enough meanwhile.
+ */
+static uint32_t ring_buf_drop_shared(struct ring_buf *rb, uint32_t size)
+{
+    uint32_t get_tail = RING_BUF_LOAD_ACQUIRE(&rb->get_tail);
+    uint32_t drop_size;
+
+    do {
+        uint32_t space = rb->size - (rb->put_head - get_tail);
+
+        drop_size = (size > space) ? size - space : 0;
+    } while ((drop_size != 0) &&
+             !__atomic_compare_exchange_n(&rb->get_tail, &get_tail, get_tail + drop_size,
+                                          false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+    rb->get_tail_cache = get_tail + drop_size;
+
+    return drop_size;
+}
+
+/*
+ * Same as ring_buf_drop_shared, dropping whole items. Item headers are read
+ * from the producer side: the consumer never writes to the storage.
+ * Returns the number of items dropped.
+ */
+static uint32_t ring_buf_item_drop_shared(struct ring_buf *rb, uint32_t size)
+{
+    uint32_t trailer_size = (rb->flags & RING_BUF_FLAG_ITEM_CRC) ? sizeof(uint32_t) : 0;
+    uint32_t put_offset = rb->put_head - rb->put_base;
+    uint32_t get_tail = RING_BUF_LOAD_ACQUIRE(&rb->get_tail);
+    uint32_t drop_tail;
+    uint32_t items;
+
+    do {
+        drop_tail = get_tail;
+        items = 0;
+
+        while (rb->size - (rb->put_head - drop_tail) < size) {
+            uint32_t used = rb->put_head - drop_tail;
+            uint32_t offset = (used > put_offset) ? put_offset + rb->size - used
+                                                  : put_offset - used;
+            uint32_t header_u32;
+
+            memcpy(&header_u32, &rb->buffer[offset], sizeof(header_u32));
+
+            struct ring_element header = uint32_to_ring_element(header_u32);
+            uint32_t item_size = sizeof(uint32_t) + header.length * sizeof(uint32_t) +
+                                 trailer_size;
+
+            /* a corrupted length drops everything that is left */
+            drop_tail += MIN(item_size, used);
+            items++;
+        }
+    } while ((items != 0) &&
+             !__atomic_compare_exchange_n(&rb->get_tail, &get_tail, drop_tail, false,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+    rb->get_tail_cache = drop_tail;
+
+    return items;
 }
 
 static uint32_t ring_element_to_uint32(struct ring_element *re) {
@@ -371,3 +1135,130 @@ static struct ring_element uint32_to_ring_element(uint32_t header) {
     
     return re;
 }
+
+static uint32_t record_header_get(struct ring_buf *rb, uint32_t offset)
+{
+    uint32_t header;
+
+    memcpy(&header, &rb->buffer[offset], sizeof(header));
+
+    return header;
+}
+
+static void record_header_set(struct ring_buf *rb, uint32_t offset, uint32_t header)
+{
+    memcpy(&rb->buffer[offset], &header, sizeof(header));
+}
+
+/*
+ * Sample the fill level after a commit. The cached consumer index is only
+ * refreshed every RING_BUF_STATS_FILL_PERIOD samples, so the consumer cache
+ * line is rarely read; in between, a stale cache overestimates the fill.
+ */
+static void ring_buf_stats_fill_update(struct ring_buf *rb)
+{
+#ifndef RING_BUF_NO_STATS
+    struct ring_buf_counters *counters = rb->stats;
+
+    if (counters == NULL) {
+        return;
+    }
+
+    if (counters->fill_samples % RING_BUF_STATS_FILL_PERIOD == 0) {
+        rb->get_tail_cache = RING_BUF_LOAD_ACQUIRE(&rb->get_tail);
+    }
+
+    uint32_t fill = rb->put_tail - rb->get_tail_cache;
+
+    if (fill > counters->high_water) {
+        RING_BUF_STAT_ADD(rb, high_water, fill - counters->high_water);
+    }
+
+    RING_BUF_STAT_ADD(rb, fill_sum, fill);
+    RING_BUF_STAT_INC(rb, fill_samples);
+#else
+    (void) rb;
+#endif
+}
+
+static uint32_t ring_buf_get_segments(struct ring_buf *rb, uint8_t *seg[2],
+                                      uint32_t seg_size[2])
+{
+    uint32_t offset = rb->get_head - rb->get_base;
+
+    if (offset >= rb->size) {
+        /* get_base is not yet adjusted */
+        offset -= rb->size;
+    }
+
+    uint32_t available = ring_buf_get_available(rb, rb->size);
+    uint32_t wrap_size = rb->size - offset;
+
+    if (rb->flags & RING_BUF_FLAG_MIRRORED) {
+        /* the mirror mapping makes the whole capacity contiguous */
+        wrap_size = rb->size;
+    }
+
+    seg[0] = &rb->buffer[offset];
+    seg_size[0] = MIN(available, wrap_size);
+    seg[1] = rb->buffer;
+    seg_size[1] = available - seg_size[0];
+
+    return available;
+}
+
+static int32_t ring_buf_segments_find(uint8_t *seg[2], uint32_t seg_size[2], uint8_t byte,
+                                      uint32_t start, uint32_t end)
+{
+    uint32_t seg_start = 0;
+
+    for (uint32_t i = 0; i < 2; i++) {
+        uint32_t seg_end = MIN(seg_start + seg_size[i], end);
+
+        if (start < seg_end) {
+            uint32_t from = start > seg_start ? start - seg_start : 0;
+            uint8_t *found = memchr(&seg[i][from], byte, seg_end - seg_start - from);
+
+            if (found) {
+                return (int32_t) (seg_start + (uint32_t) (found - seg[i]));
+            }
+        }
+
+        seg_start += seg_size[i];
+    }
+
+    return -1;
+}
+
+static bool ring_buf_segments_match(uint8_t *seg[2], uint32_t seg_size[2], uint32_t offset,
+                                    const uint8_t *seq, uint32_t len)
+{
+    if (offset < seg_size[0]) {
+        uint32_t first_len = MIN(len, seg_size[0] - offset);
+
+        if (memcmp(&seg[0][offset], seq, first_len) != 0) {
+            return false;
+        }
+
+        seq += first_len;
+        len -= first_len;
+        offset = seg_size[0];
+    }
+
+    return memcmp(&seg[1][offset - seg_size[0]], seq, len) == 0;
+}
+
+static void ring_buf_segments_copy(uint8_t *seg[2], uint32_t seg_size[2], uint32_t offset,
+                                   uint8_t *dst, uint32_t len)
+{
+    if (offset < seg_size[0]) {
+        uint32_t first_len = MIN(len, seg_size[0] - offset);
+
+        memcpy(dst, &seg[0][offset], first_len);
+        dst += first_len;
+        len -= first_len;
+        offset = seg_size[0];
+    }
+
+    memcpy(dst, &seg[1][offset - seg_size[0]], len);
+}
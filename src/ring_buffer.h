@@ -20,21 +20,133 @@ extern "C" {
  * state.
  */
 #define RING_BUFFER_MAX_SIZE 0x80000000u
+
+/*
+ * Indices written by different threads are kept on separate cache lines.
+ * Builds for single-core targets, where no cache line is shared, may define
+ * RING_BUF_CACHE_LINE_SIZE to 0 to drop the padding. It changes the layout
+ * of the structures, so it must be the same for the whole build.
+ */
+#ifndef RING_BUF_CACHE_LINE_SIZE
+#define RING_BUF_CACHE_LINE_SIZE 64u
+#endif
+
+#if RING_BUF_CACHE_LINE_SIZE > 0
+#define RING_BUF_CACHE_LINE_PAD(name) uint8_t name[RING_BUF_CACHE_LINE_SIZE];
+#else
+#define RING_BUF_CACHE_LINE_PAD(name)
+#endif
+
+/* Storage is mapped twice back to back, so claims never wrap. */
+#define RING_BUF_FLAG_MIRRORED (1u << 0)
+
+/* Items carry a CRC-32 trailer, see ring_buf_item_checked_init(). */
+#define RING_BUF_FLAG_ITEM_CRC (1u << 1)
+
+/* Overwriting puts may race with the consumer, see ring_buf_overwrite_enable(). */
+#define RING_BUF_FLAG_OVERWRITE (1u << 2)
+
+/*
+ * Define RING_BUF_NO_STATS (for the translation unit of ring_buffer.c) to
+ * compile the statistics out: ring_buf_stats_get() then always reports -2.
+ * The layout of the structures does not depend on it.
+ */
+
+/*
+ * Number of producer commits between two refreshes of the cached consumer
+ * position for fill level sampling, see ring_buf_stats_get().
+ */
+#ifndef RING_BUF_STATS_FILL_PERIOD
+#define RING_BUF_STATS_FILL_PERIOD 16u
+#endif
+
 /** @endcond */
 
+/**
+ * @brief Storage for the statistics counters of a ring buffer.
+ *
+ * Attached to a ring buffer with @ref ring_buf_stats_enable. Each counter is
+ * only written by the side (producer or consumer) it belongs to, and the
+ * counters of both sides are on separate cache lines.
+ */
+struct ring_buf_counters {
+    /** @cond INTERNAL_HIDDEN */
+    /* producer counters */
+    uint64_t bytes_in;
+    uint64_t fill_sum;
+    uint64_t fill_samples;
+    uint32_t items_in;
+    uint32_t put_full;
+    uint32_t put_wrap;
+    uint32_t high_water;
+    RING_BUF_CACHE_LINE_PAD(pad0)
+    /* consumer counters */
+    uint64_t bytes_out;
+    uint32_t items_out;
+    uint32_t get_empty;
+    uint32_t get_wrap;
+    RING_BUF_CACHE_LINE_PAD(pad1)
+    /** @endcond */
+};
+
+/**
+ * @brief A snapshot of the statistics of a ring buffer.
+ *
+ * Counters run from ring buffer initialization or from the last call to
+ * @ref ring_buf_stats_reset. Byte counters include item and record headers.
+ */
+struct ring_buf_stats {
+    uint64_t bytes_in;       /**< Bytes committed by the producer */
+    uint64_t bytes_out;      /**< Bytes freed by the consumer */
+    uint32_t items_in;       /**< Items and records written */
+    uint32_t items_out;      /**< Items and records read */
+    uint32_t put_full;       /**< Puts and claims cut short by lack of space */
+    uint32_t get_empty;      /**< Gets and claims that found no data */
+    uint32_t put_wrap;       /**< Put claims cut short by the end of storage */
+    uint32_t get_wrap;       /**< Get claims cut short by the end of storage */
+    uint32_t high_water;     /**< Highest fill level (in bytes) */
+    uint32_t fill_avg;       /**< Average fill level (in bytes) */
+};
+
 /**
  * @brief A structure to represent a ring buffer
+ *
+ * One producer and one consumer may use a ring buffer concurrently from
+ * different threads without any locking: the producer owns the put_ side
+ * (claim/finish, put and item put calls) and the consumer owns the get_
+ * side (claim/finish, get, peek and item get calls). Indices shared between
+ * both sides are published with release and observed with acquire
+ * semantics. Multiple producers or multiple consumers still have to be
+ * serialized by the application, and so do the overwriting puts, which act
+ * on both sides, unless @ref ring_buf_overwrite_enable was called.
+ *
+ * Each side keeps a copy of the last index it observed from the other side
+ * and only reloads it when the ring looks full (producer) or empty
+ * (consumer), so the other side's state is rarely read. The producer state,
+ * the consumer state and the read-mostly fields are on separate cache lines.
  */
 struct ring_buf {
     /** @cond INTERNAL_HIDDEN */
     uint8_t *buffer;
+    uint32_t size;
+    uint32_t flags;
+    struct ring_buf_counters *stats;
+    RING_BUF_CACHE_LINE_PAD(pad0)
+    /* producer state */
     uint32_t put_head;
     uint32_t put_tail;
     uint32_t put_base;
+    uint32_t get_tail_cache;
+    uint32_t dropped_bytes;
+    uint32_t dropped_items;
+    RING_BUF_CACHE_LINE_PAD(pad1)
+    /* consumer state */
     uint32_t get_head;
     uint32_t get_tail;
     uint32_t get_base;
-    uint32_t size;
+    uint32_t put_tail_cache;
+    uint32_t get_tail_local;
+    RING_BUF_CACHE_LINE_PAD(pad2)
     /** @endcond */
 };
 
@@ -65,6 +177,21 @@ void ring_buf_init(struct ring_buf *rb, uint32_t size, uint8_t *data);
  */
 void ring_buf_item_init(struct ring_buf *rb, uint32_t size, uint32_t *data);
 
+/**
+ * @brief Initialize an "item based" ring buffer with integrity checks.
+ *
+ * Same as @ref ring_buf_item_init, but every item is followed by an
+ * IEEE 802.3 CRC-32 of its header and data, taking one more 32-bit word.
+ * The CRC is computed while the data is copied in by
+ * @ref ring_buf_item_put and checked while it is copied out by
+ * @ref ring_buf_item_get, which reports corrupted items.
+ *
+ * @param rb Address of ring buffer.
+ * @param size Ring buffer size (in 32-bit words)
+ * @param data Ring buffer data area (uint32_t data[size]).
+ */
+void ring_buf_item_checked_init(struct ring_buf *rb, uint32_t size, uint32_t *data);
+
 /**
  * @brief Determine if a ring buffer is empty.
  *
@@ -77,6 +204,10 @@ bool ring_buf_is_empty(struct ring_buf *rb);
 /**
  * @brief Reset ring buffer state.
  *
+ * @warning
+ * Resetting touches both the producer and the consumer state, so it must not
+ * run concurrently with any other operation on the same ring buffer.
+ *
  * @param rb Address of ring buffer.
  */
 void ring_buf_reset(struct ring_buf *rb);
@@ -139,7 +270,8 @@ uint32_t ring_buf_size_get(struct ring_buf *rb);
  * @param[in]  size Requested allocation size (in bytes).
  *
  * @return Size of allocated buffer which can be smaller than requested if
- *	   there is not enough free space or buffer wraps.
+ *	   there is not enough free space or buffer wraps (buffers initialized
+ *	   with ring_buf_mirror_init never wrap).
  */
 uint32_t ring_buf_put_claim(struct ring_buf *rb, uint8_t **data, uint32_t size);
 
@@ -189,6 +321,71 @@ int32_t ring_buf_put_finish(struct ring_buf *rb, uint32_t size);
  */
 uint32_t ring_buf_put(struct ring_buf *rb, const uint8_t *data, uint32_t size);
 
+/**
+ * @brief Write (copy) data to a ring buffer, overwriting the oldest data.
+ *
+ * This routine writes data to a ring buffer @a buf. When there is not enough
+ * free space, the oldest bytes are dropped to make room, so the producer
+ * never has to wait for the consumer. If @a size exceeds the capacity, only
+ * the last bytes of @a data that fit are kept. Dropped bytes are counted
+ * (see @ref ring_buf_dropped_get).
+ *
+ * @warning
+ * Dropping data moves the consumer side of the ring buffer. Unless
+ * @ref ring_buf_overwrite_enable was called, all calls on a ring buffer
+ * written with this routine must be made from a single thread (or
+ * serialized by the application), and none while a
+ * @ref ring_buf_get_claim is pending.
+ *
+ * @warning
+ * Ring buffer instance should not mix byte access and item access
+ * (calls prefixed with ring_buf_item_).
+ *
+ * @param buf Address of ring buffer.
+ * @param data Address of data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written.
+ */
+uint32_t ring_buf_put_overwrite(struct ring_buf *rb, const uint8_t *data,
+                                uint32_t size);
+
+/**
+ * @brief Return the number of bytes dropped by @ref ring_buf_put_overwrite.
+ *
+ * The counter wraps around and is cleared by @ref ring_buf_reset.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return Number of bytes dropped since initialization.
+ */
+uint32_t ring_buf_dropped_get(struct ring_buf *rb);
+
+/**
+ * @brief Let overwriting puts run concurrently with the consumer.
+ *
+ * After this call, @ref ring_buf_put_overwrite and
+ * @ref ring_buf_item_put_overwrite drop data from the producer side, by
+ * moving the consumer index with a compare-and-swap, instead of reading it
+ * out. The consumer commits with a compare-and-swap as well, so a read that
+ * raced with a drop is detected: @ref ring_buf_get_finish then returns -2,
+ * discards the claim and moves the consumer to the oldest data left.
+ * @ref ring_buf_get, @ref ring_buf_peek and @ref ring_buf_item_get retry on
+ * their own and only ever return data which was not dropped while it was
+ * read.
+ *
+ * Until the consumer commits, the bytes it reads may be overwritten, so it
+ * must not act on claimed data before @ref ring_buf_get_finish succeeded.
+ *
+ * @warning
+ * Must be called before the producer and the consumer start. Of the other
+ * consumer calls, only @ref ring_buf_get_claim, @ref ring_buf_is_empty and
+ * @ref ring_buf_size_get may be used on such a ring buffer.
+ *
+ * @param rb Address of ring buffer.
+ */
+void ring_buf_overwrite_enable(struct ring_buf *rb);
+
 /**
  * @brief Get address of a valid data in a ring buffer.
  *
@@ -211,7 +408,8 @@ uint32_t ring_buf_put(struct ring_buf *rb, const uint8_t *data, uint32_t size);
  * @param[in]  size Requested size (in bytes).
  *
  * @return Number of valid bytes in the provided buffer which can be smaller
- *	   than requested if there is not enough free space or buffer wraps.
+ *	   than requested if there is not enough free space or buffer wraps
+ *	   (buffers initialized with ring_buf_mirror_init never wrap).
  */
 uint32_t ring_buf_get_claim(struct ring_buf *rb, uint8_t **data,
 			                uint32_t size);
@@ -237,6 +435,9 @@ uint32_t ring_buf_get_claim(struct ring_buf *rb, uint8_t **data,
  *
  * @retval 0 Successful operation.
  * @retval -1 Provided @a size exceeds valid bytes in the ring buffer.
+ * @retval -2 The claimed data was dropped by an overwriting put while it was
+ *            read (see @ref ring_buf_overwrite_enable). Nothing was freed and
+ *            the next claim starts at the oldest data left.
  */
 int32_t ring_buf_get_finish(struct ring_buf *rb, uint32_t size);
 
@@ -290,6 +491,45 @@ uint32_t ring_buf_get(struct ring_buf *rb, uint8_t *data, uint32_t size);
  */
 uint32_t ring_buf_peek(struct ring_buf *rb, uint8_t *data, uint32_t size);
 
+/**
+ * @brief Find a byte in the data of a ring buffer.
+ *
+ * This routine searches the data which has not been claimed yet, in place
+ * and without removing it. The returned offset is counted from the first
+ * byte the next @ref ring_buf_get_claim or @ref ring_buf_get would return,
+ * so a frame ending with the byte found at offset @a n can be read with a
+ * claim (or get) of @a n + 1 bytes.
+ *
+ * @warning
+ * Must be called from the consumer side of the ring buffer.
+ *
+ * @param rb    Address of ring buffer.
+ * @param byte  Byte to look for.
+ * @param start Offset to start searching from, e.g. the number of bytes
+ *              already searched by a previous call.
+ *
+ * @return Offset of the first occurrence of @a byte at or after @a start,
+ *         or -1 if it is not found.
+ */
+int32_t ring_buf_find_byte(struct ring_buf *rb, uint8_t byte, uint32_t start);
+
+/**
+ * @brief Find a sequence of bytes in the data of a ring buffer.
+ *
+ * Same as @ref ring_buf_find_byte for a sequence of bytes, which may span
+ * the wrap point of the ring buffer storage.
+ *
+ * @param rb    Address of ring buffer.
+ * @param seq   Address of the sequence to look for.
+ * @param len   Sequence length (in bytes).
+ * @param start Offset to start searching from.
+ *
+ * @return Offset of the first byte of the first occurrence of @a seq at or
+ *         after @a start, or -1 if it is not found.
+ */
+int32_t ring_buf_find_seq(struct ring_buf *rb, const uint8_t *seq, uint32_t len,
+                          uint32_t start);
+
 /**
  * @brief Write a data item to a ring buffer.
  *
@@ -314,6 +554,44 @@ uint32_t ring_buf_peek(struct ring_buf *rb, uint8_t *data, uint32_t size);
 int32_t ring_buf_item_put(struct ring_buf *rb, uint16_t type, uint8_t value,
                           uint32_t *data, uint8_t size32);
 
+/**
+ * @brief Write a data item to a ring buffer, overwriting the oldest items.
+ *
+ * This routine works like @ref ring_buf_item_put, but when there is not
+ * enough free space the oldest items are dropped, whole, until the new item
+ * fits. Dropped items are counted (see @ref ring_buf_item_dropped_get).
+ *
+ * @warning
+ * Dropping items moves the consumer side of the ring buffer. Unless
+ * @ref ring_buf_overwrite_enable was called, all calls on a ring buffer
+ * written with this routine must be made from a single thread (or
+ * serialized by the application).
+ *
+ * @param buf Address of ring buffer.
+ * @param type Data item's type identifier (application specific).
+ * @param value Data item's integer value (application specific).
+ * @param data Address of data item.
+ * @param size32 Data item size (number of 32-bit words).
+ *
+ * @retval 0 Data item was written.
+ * @retval -2 Data item is bigger than the ring buffer capacity.
+ */
+int32_t ring_buf_item_put_overwrite(struct ring_buf *rb, uint16_t type,
+                                    uint8_t value, uint32_t *data,
+                                    uint8_t size32);
+
+/**
+ * @brief Return the number of items dropped by
+ *        @ref ring_buf_item_put_overwrite.
+ *
+ * The counter wraps around and is cleared by @ref ring_buf_reset.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return Number of items dropped since initialization.
+ */
+uint32_t ring_buf_item_dropped_get(struct ring_buf *rb);
+
 /**
  * @brief Read a data item from a ring buffer.
  *
@@ -337,10 +615,260 @@ int32_t ring_buf_item_put(struct ring_buf *rb, uint16_t type, uint8_t value,
  * @retval -1 Ring buffer is empty.
  * @retval -2 Data area @a data is too small; @a size32 now contains
  *         the number of 32-bit words needed.
+ * @retval -3 Data item was fetched but failed its integrity check (ring
+ *         buffers initialized with @ref ring_buf_item_checked_init only).
  */
 int32_t ring_buf_item_get(struct ring_buf *rb, uint16_t *type, uint8_t *value,
                           uint32_t *data, uint8_t *size32);
 
+/**
+ * @brief A data item seen in place by @ref ring_buf_item_iter_next or
+ *        @ref ring_buf_item_peek.
+ *
+ * The data may wrap at the end of the ring buffer storage, in which case it
+ * is split in two segments. Pointers remain valid until the item is read or
+ * consumed.
+ */
+struct ring_buf_item_view {
+    uint16_t type;           /**< Data item's type identifier */
+    uint8_t value;           /**< Data item's integer value */
+    uint8_t size32;          /**< Data item size (number of 32-bit words) */
+    uint8_t *data[2];        /**< Data segments, in order */
+    uint32_t data_size[2];   /**< Segment sizes (in bytes), the second one is
+                                  0 unless the data wraps */
+};
+
+/**
+ * @brief An iterator over the data items of a ring buffer.
+ */
+struct ring_buf_item_iter {
+    /** @cond INTERNAL_HIDDEN */
+    struct ring_buf *rb;
+    uint8_t *seg[2];
+    uint32_t seg_size[2];
+    uint32_t offset;
+    uint32_t items;
+    /** @endcond */
+};
+
+/**
+ * @brief Start iterating over the data items of a ring buffer.
+ *
+ * Items are walked in place, oldest first, without being removed. Items
+ * committed after this call are not seen by the iterator.
+ *
+ * @warning
+ * Must be called from the consumer side of the ring buffer, and no item may
+ * be read while the iterator is in use.
+ *
+ * @param it Address of iterator.
+ * @param rb Address of ring buffer.
+ */
+void ring_buf_item_iter_init(struct ring_buf_item_iter *it, struct ring_buf *rb);
+
+/**
+ * @brief Get the next data item of an iterator.
+ *
+ * @param it   Address of iterator.
+ * @param item Filled with the type, value and data location of the item.
+ *
+ * @retval 0 Item was found.
+ * @retval -1 No more items.
+ * @retval -3 Item was found but failed its integrity check (ring buffers
+ *         initialized with @ref ring_buf_item_checked_init only).
+ */
+int32_t ring_buf_item_iter_next(struct ring_buf_item_iter *it, struct ring_buf_item_view *item);
+
+/**
+ * @brief Remove the data items returned by an iterator so far.
+ *
+ * Items are removed as if read with @ref ring_buf_item_get, up to and
+ * including the last one returned by @ref ring_buf_item_iter_next. The
+ * iterator then restarts from the oldest item left.
+ *
+ * @param it Address of iterator.
+ *
+ * @return Number of items removed.
+ */
+uint32_t ring_buf_item_iter_consume(struct ring_buf_item_iter *it);
+
+/**
+ * @brief Look at a data item of a ring buffer in place.
+ *
+ * @warning
+ * Must be called from the consumer side of the ring buffer. Items are
+ * walked from the oldest one, so the cost grows with @a index.
+ *
+ * @param rb    Address of ring buffer.
+ * @param index Position of the item, 0 being the oldest one.
+ * @param item  Filled with the type, value and data location of the item.
+ *
+ * @retval 0 Item was found.
+ * @retval -1 Ring buffer holds @a index items or fewer.
+ * @retval -3 Item was found but failed its integrity check.
+ */
+int32_t ring_buf_item_peek(struct ring_buf *rb, uint32_t index, struct ring_buf_item_view *item);
+
+/**
+ * @brief Initialize a "record based" ring buffer.
+ *
+ * This routine initializes a ring buffer, prior to its first use, for
+ * variable length records. Each record is a run of bytes (up to half the
+ * ring buffer capacity) stored contiguously behind a 32-bit length header,
+ * so it can be written and read in place. When a record does not
+ * fit before the end of the storage, the remaining bytes are skipped and
+ * the record starts again at the beginning.
+ *
+ * @param rb Address of ring buffer.
+ * @param size Ring buffer size (in 32-bit words)
+ * @param data Ring buffer data area (uint32_t data[size]).
+ */
+void ring_buf_record_init(struct ring_buf *rb, uint32_t size, uint32_t *data);
+
+/**
+ * @brief Allocate a contiguous record for writing.
+ *
+ * With this routine a record can be built directly in ring buffer storage.
+ * Once written it must be published with @ref ring_buf_record_commit.
+ * Claiming again before committing replaces the pending claim.
+ *
+ * @warning
+ * Use cases involving multiple writers to the ring buffer must prevent
+ * concurrent write operations, either by preventing all writers from
+ * being preempted or by using a mutex to govern writes to the ring buffer.
+ *
+ * @warning
+ * Ring buffer instance should not mix record access with byte or item
+ * access.
+ *
+ * @param[in]  rb   Address of ring buffer.
+ * @param[out] data Set to the record location within ring buffer.
+ * @param[in]  size Record size (in bytes).
+ *
+ * @retval 0 Record was allocated.
+ * @retval -1 Record is bigger than the ring buffer can ever hold.
+ * @retval -2 Ring buffer has insufficient free space.
+ */
+int32_t ring_buf_record_claim(struct ring_buf *rb, uint8_t **data, uint32_t size);
+
+/**
+ * @brief Publish the record allocated by @ref ring_buf_record_claim.
+ *
+ * @param rb   Address of ring buffer.
+ * @param size Final record size (in bytes), equal to or lower than the
+ *             claimed size. The surplus is returned to the free space.
+ *
+ * @retval 0 Record was published.
+ * @retval -1 No record is claimed or @a size exceeds the claimed size.
+ */
+int32_t ring_buf_record_commit(struct ring_buf *rb, uint32_t size);
+
+/**
+ * @brief Write (copy) a record to a ring buffer.
+ *
+ * @param rb   Address of ring buffer.
+ * @param data Address of record data.
+ * @param size Record size (in bytes).
+ *
+ * @retval 0 Record was written.
+ * @retval -1 Record is bigger than the ring buffer can ever hold.
+ * @retval -2 Ring buffer has insufficient free space.
+ */
+int32_t ring_buf_record_put(struct ring_buf *rb, const uint8_t *data, uint32_t size);
+
+/**
+ * @brief Get the address of the oldest record in a ring buffer.
+ *
+ * The record stays in the ring buffer, contiguous in storage, until it is
+ * removed with @ref ring_buf_record_release. Peeking again before releasing
+ * returns the same record.
+ *
+ * @warning
+ * Use cases involving multiple reads of the ring buffer must prevent
+ * concurrent read operations, either by preventing all readers from
+ * being preempted or by using a mutex to govern reads to the ring buffer.
+ *
+ * @param[in]  rb   Address of ring buffer.
+ * @param[out] data Set to the record location within ring buffer.
+ * @param[out] size Set to the record size (in bytes).
+ *
+ * @retval 0 Record is available.
+ * @retval -1 Ring buffer is empty.
+ */
+int32_t ring_buf_record_peek(struct ring_buf *rb, uint8_t **data, uint32_t *size);
+
+/**
+ * @brief Remove the record returned by @ref ring_buf_record_peek.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @retval 0 Record was removed.
+ * @retval -1 No record was peeked.
+ */
+int32_t ring_buf_record_release(struct ring_buf *rb);
+
+/**
+ * @brief Read (copy) a record from a ring buffer.
+ *
+ * @param rb   Address of ring buffer.
+ * @param data Area to store the record. Can be NULL to discard it.
+ * @param size Size of the storage area (in bytes). Set to the record size.
+ *
+ * @retval 0 Record was fetched.
+ * @retval -1 Ring buffer is empty.
+ * @retval -2 Data area @a data is too small; @a size now contains the
+ *         number of bytes needed and the record is left in the ring buffer.
+ */
+int32_t ring_buf_record_get(struct ring_buf *rb, uint8_t *data, uint32_t *size);
+
+/**
+ * @brief Enable the statistics of a ring buffer.
+ *
+ * Counting costs a few additions per operation on the calling side, and an
+ * acquire load of the consumer position every RING_BUF_STATS_FILL_PERIOD
+ * producer commits to sample the fill level. Ring buffers without counters
+ * only test for them, and builds defining RING_BUF_NO_STATS do not even
+ * test.
+ *
+ * This routine must not be called while the ring buffer is in use.
+ *
+ * @param rb       Address of ring buffer.
+ * @param counters Storage for the counters, which are reset. NULL disables
+ *                 the statistics.
+ */
+void ring_buf_stats_enable(struct ring_buf *rb, struct ring_buf_counters *counters);
+
+/**
+ * @brief Take a snapshot of the statistics of a ring buffer.
+ *
+ * The snapshot may be taken from any thread; while the ring buffer is in use
+ * its counters are read one by one.
+ *
+ * Fill levels are sampled by the producer right after it commits data, from
+ * its cached copy of the consumer position, which it refreshes every
+ * RING_BUF_STATS_FILL_PERIOD commits (and whenever the ring buffer looks
+ * full). A sample never underestimates the fill level, and overestimates it
+ * by at most the bytes freed by the consumer during the last
+ * RING_BUF_STATS_FILL_PERIOD - 1 commits.
+ *
+ * @param[in]  rb    Address of ring buffer.
+ * @param[out] stats Set to the current statistics.
+ *
+ * @retval 0 Statistics were copied.
+ * @retval -2 Statistics are not enabled or compiled out; @a stats is zeroed.
+ */
+int32_t ring_buf_stats_get(struct ring_buf *rb, struct ring_buf_stats *stats);
+
+/**
+ * @brief Reset the statistics of a ring buffer.
+ *
+ * @warning
+ * Counts made concurrently by the producer or the consumer may be lost.
+ *
+ * @param rb Address of ring buffer.
+ */
+void ring_buf_stats_reset(struct ring_buf *rb);
+
 #ifdef __cplusplus
 }
 #endif
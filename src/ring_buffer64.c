@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include "ring_buffer64.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#define RING_BUFFER_SIZE_ASSERT_MSG "Size too big"
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+/* Same index publication scheme as struct ring_buf. */
+#define RING_BUF_LOAD_ACQUIRE(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define RING_BUF_STORE_RELEASE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+
+
+static void ring_buf64_internal_reset(struct ring_buf64 *rb);
+static uint64_t ring_buf64_put_space(struct ring_buf64 *rb, uint64_t size);
+static uint64_t ring_buf64_get_available(struct ring_buf64 *rb, uint64_t size);
+
+
+void ring_buf64_init(struct ring_buf64 *rb, uint64_t size, uint8_t *data)
+{
+    assert(size < RING_BUFFER64_MAX_SIZE && RING_BUFFER_SIZE_ASSERT_MSG);
+
+    rb->size = size;
+    rb->buffer = data;
+    rb->flags = 0;
+    ring_buf64_internal_reset(rb);
+}
+
+#if defined(__linux__)
+
+int32_t ring_buf64_alloc(struct ring_buf64 *rb, uint64_t size, uint32_t flags)
+{
+    if (size == 0 || size >= RING_BUFFER64_MAX_SIZE || size > SIZE_MAX ||
+        (flags & ~(RING_BUF64_ALLOC_HUGETLB | RING_BUF64_ALLOC_THP)) != 0 ||
+        flags == (RING_BUF64_ALLOC_HUGETLB | RING_BUF64_ALLOC_THP)) {
+        return -1;
+    }
+
+    size_t length = (size_t) size;
+    int mmap_flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+
+    if (flags & RING_BUF64_ALLOC_HUGETLB) {
+        length = ((length + RING_BUF64_HUGE_PAGE_SIZE - 1) / RING_BUF64_HUGE_PAGE_SIZE) *
+                 RING_BUF64_HUGE_PAGE_SIZE;
+        mmap_flags |= MAP_HUGETLB;
+    }
+
+    uint8_t *base = mmap(NULL, length, PROT_READ | PROT_WRITE, mmap_flags, -1, 0);
+    if (base == MAP_FAILED) {
+        return -2;
+    }
+
+    if ((flags & RING_BUF64_ALLOC_THP) && madvise(base, length, MADV_HUGEPAGE) != 0) {
+        munmap(base, length);
+        return -2;
+    }
+
+    ring_buf64_init(rb, size, base);
+    rb->flags |= RING_BUF64_FLAG_ALLOCATED;
+
+    if (flags & RING_BUF64_ALLOC_HUGETLB) {
+        rb->flags |= RING_BUF64_FLAG_HUGETLB;
+    }
+
+    return 0;
+}
+
+void ring_buf64_free(struct ring_buf64 *rb)
+{
+    if (rb->buffer != NULL && (rb->flags & RING_BUF64_FLAG_ALLOCATED)) {
+        size_t length = (size_t) rb->size;
+
+        if (rb->flags & RING_BUF64_FLAG_HUGETLB) {
+            length = ((length + RING_BUF64_HUGE_PAGE_SIZE - 1) / RING_BUF64_HUGE_PAGE_SIZE) *
+                     RING_BUF64_HUGE_PAGE_SIZE;
+        }
+
+        munmap(rb->buffer, length);
+    }
+
+    rb->buffer = NULL;
+    rb->flags = 0;
+}
+
+#else /* !__linux__ */
+
+int32_t ring_buf64_alloc(struct ring_buf64 *rb, uint64_t size, uint32_t flags)
+{
+    (void) rb;
+    (void) size;
+    (void) flags;
+
+    return -2;
+}
+
+void ring_buf64_free(struct ring_buf64 *rb)
+{
+    rb->buffer = NULL;
+    rb->flags = 0;
+}
+
+#endif /* __linux__ */
+
+bool ring_buf64_is_empty(struct ring_buf64 *rb)
+{
+    return rb->get_head == RING_BUF_LOAD_ACQUIRE(&rb->put_tail);
+}
+
+void ring_buf64_reset(struct ring_buf64 *rb)
+{
+    ring_buf64_internal_reset(rb);
+}
+
+uint64_t ring_buf64_space_get(struct ring_buf64 *rb)
+{
+    return rb->size - (rb->put_head - RING_BUF_LOAD_ACQUIRE(&rb->get_tail));
+}
+
+uint64_t ring_buf64_capacity_get(struct ring_buf64 *rb)
+{
+    return rb->size;
+}
+
+uint64_t ring_buf64_size_get(struct ring_buf64 *rb)
+{
+    return RING_BUF_LOAD_ACQUIRE(&rb->put_tail) - rb->get_head;
+}
+
+uint64_t ring_buf64_put_claim(struct ring_buf64 *rb, uint8_t **data, uint64_t size)
+{
+    uint64_t base = rb->put_base;
+    uint64_t wrap_size = rb->put_head - base;
+
+    if (wrap_size >= rb->size) {
+        /* put_base is not yet adjusted */
+        wrap_size -= rb->size;
+        base += rb->size;
+    }
+
+    wrap_size = rb->size - wrap_size;
+
+    uint64_t free_space = ring_buf64_put_space(rb, size);
+
+    size = MIN(size, free_space);
+    size = MIN(size, wrap_size);
+
+    *data = &rb->buffer[rb->put_head - base];
+    rb->put_head += size;
+
+    return size;
+}
+
+int32_t ring_buf64_put_finish(struct ring_buf64 *rb, uint64_t size)
+{
+    uint64_t finish_space = rb->put_head - rb->put_tail;
+
+    if (size > finish_space) {
+        return -1;
+    }
+
+    uint64_t put_tail = rb->put_tail + size;
+
+    rb->put_head = put_tail;
+    RING_BUF_STORE_RELEASE(&rb->put_tail, put_tail);
+
+    if (put_tail - rb->put_base >= rb->size) {
+        /* we wrapped: adjust put_base */
+        rb->put_base += rb->size;
+    }
+
+    return 0;
+}
+
+uint64_t ring_buf64_put(struct ring_buf64 *rb, const uint8_t *data, uint64_t size)
+{
+    uint64_t total_size = 0;
+    uint64_t partial_size;
+
+    do {
+        uint8_t *dst;
+        partial_size = ring_buf64_put_claim(rb, &dst, size);
+        memcpy(dst, data, partial_size);
+        total_size += partial_size;
+        size -= partial_size;
+        data += partial_size;
+    } while (size && partial_size);
+
+    int32_t finish_result = ring_buf64_put_finish(rb, total_size);
+    assert(finish_result == 0);
+    (void) finish_result;
+
+    return total_size;
+}
+
+uint64_t ring_buf64_get_claim(struct ring_buf64 *rb, uint8_t **data, uint64_t size)
+{
+    uint64_t base = rb->get_base;
+    uint64_t wrap_size = rb->get_head - base;
+
+    if (wrap_size >= rb->size) {
+        /* get_base is not yet adjusted */
+        wrap_size -= rb->size;
+        base += rb->size;
+    }
+
+    wrap_size = rb->size - wrap_size;
+
+    uint64_t available_size = ring_buf64_get_available(rb, size);
+
+    size = MIN(size, available_size);
+    size = MIN(size, wrap_size);
+
+    *data = &rb->buffer[rb->get_head - base];
+    rb->get_head += size;
+
+    return size;
+}
+
+int32_t ring_buf64_get_finish(struct ring_buf64 *rb, uint64_t size)
+{
+    uint64_t finish_space = rb->get_head - rb->get_tail;
+
+    if (size > finish_space) {
+        return -1;
+    }
+
+    uint64_t get_tail = rb->get_tail + size;
+
+    rb->get_head = get_tail;
+    RING_BUF_STORE_RELEASE(&rb->get_tail, get_tail);
+
+    if (get_tail - rb->get_base >= rb->size) {
+        /* we wrapped: adjust get_base */
+        rb->get_base += rb->size;
+    }
+
+    return 0;
+}
+
+uint64_t ring_buf64_get(struct ring_buf64 *rb, uint8_t *data, uint64_t size)
+{
+    uint64_t total_size = 0;
+    uint64_t partial_size;
+
+    do {
+        uint8_t *src;
+        partial_size = ring_buf64_get_claim(rb, &src, size);
+        if (data) {
+            memcpy(data, src, partial_size);
+            data += partial_size;
+        }
+        total_size += partial_size;
+        size -= partial_size;
+    } while (size && partial_size);
+
+    int32_t finish_result = ring_buf64_get_finish(rb, total_size);
+    assert(finish_result == 0);
+    (void) finish_result;
+
+    return total_size;
+}
+
+uint64_t ring_buf64_peek(struct ring_buf64 *rb, uint8_t *data, uint64_t size)
+{
+    uint64_t total_size = 0;
+    uint64_t partial_size;
+
+    assert(data != NULL);
+
+    do {
+        uint8_t *src;
+        partial_size = ring_buf64_get_claim(rb, &src, size);
+        memcpy(data, src, partial_size);
+        data += partial_size;
+        total_size += partial_size;
+        size -= partial_size;
+    } while (size && partial_size);
+
+    /* effectively unclaim total_size bytes */
+    int32_t finish_result = ring_buf64_get_finish(rb, 0);
+    assert(finish_result == 0);
+    (void) finish_result;
+
+    return total_size;
+}
+
+static void ring_buf64_internal_reset(struct ring_buf64 *rb)
+{
+    rb->put_head = 0;
+    rb->put_tail = 0;
+    rb->put_base = 0;
+    rb->get_tail_cache = 0;
+    rb->get_head = 0;
+    rb->get_tail = 0;
+    rb->get_base = 0;
+    rb->put_tail_cache = 0;
+}
+
+static uint64_t ring_buf64_put_space(struct ring_buf64 *rb, uint64_t size)
+{
+    uint64_t space = rb->size - (rb->put_head - rb->get_tail_cache);
+
+    if (space < size) {
+        rb->get_tail_cache = RING_BUF_LOAD_ACQUIRE(&rb->get_tail);
+        space = rb->size - (rb->put_head - rb->get_tail_cache);
+    }
+
+    return space;
+}
+
+static uint64_t ring_buf64_get_available(struct ring_buf64 *rb, uint64_t size)
+{
+    uint64_t available = rb->put_tail_cache - rb->get_head;
+
+    if (available < size) {
+        rb->put_tail_cache = RING_BUF_LOAD_ACQUIRE(&rb->put_tail);
+        available = rb->put_tail_cache - rb->get_head;
+    }
+
+    return available;
+}
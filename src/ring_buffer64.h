@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef RING_BUFFER64_H
+#define RING_BUFFER64_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @cond INTERNAL_HIDDEN */
+/* Same as RING_BUFFER_MAX_SIZE, for 64-bit indices. */
+#define RING_BUFFER64_MAX_SIZE UINT64_C(0x8000000000000000)
+
+/* Granularity of huge page backed storage. */
+#ifndef RING_BUF64_HUGE_PAGE_SIZE
+#define RING_BUF64_HUGE_PAGE_SIZE (2u * 1024u * 1024u)
+#endif
+
+/* Storage was allocated by ring_buf64_alloc() (and how). */
+#define RING_BUF64_FLAG_ALLOCATED (1u << 0)
+#define RING_BUF64_FLAG_HUGETLB   (1u << 1)
+/** @endcond */
+
+/**
+ * @brief Back the storage with pages from the huge page pool (MAP_HUGETLB).
+ *
+ * Pages must have been reserved beforehand (vm.nr_hugepages).
+ */
+#define RING_BUF64_ALLOC_HUGETLB (1u << 0)
+
+/**
+ * @brief Ask for transparent huge pages (MADV_HUGEPAGE) on regular storage.
+ */
+#define RING_BUF64_ALLOC_THP (1u << 1)
+
+/**
+ * @brief A structure to represent a ring buffer with 64-bit indices.
+ *
+ * Same as struct ring_buf, for storage of 2 GiB and more: sizes, claims and
+ * indices are 64-bit wide. The same single producer/single consumer
+ * guarantees apply.
+ *
+ * @note 64-bit indices are published with atomic 64-bit loads and stores,
+ *       which are only lock-free on 64-bit targets.
+ */
+struct ring_buf64 {
+    /** @cond INTERNAL_HIDDEN */
+    uint8_t *buffer;
+    uint64_t size;
+    uint32_t flags;
+    RING_BUF_CACHE_LINE_PAD(pad0)
+    /* producer state */
+    uint64_t put_head;
+    uint64_t put_tail;
+    uint64_t put_base;
+    uint64_t get_tail_cache;
+    RING_BUF_CACHE_LINE_PAD(pad1)
+    /* consumer state */
+    uint64_t get_head;
+    uint64_t get_tail;
+    uint64_t get_base;
+    uint64_t put_tail_cache;
+    RING_BUF_CACHE_LINE_PAD(pad2)
+    /** @endcond */
+};
+
+/**
+ * @brief Initialize a 64-bit index ring buffer for byte data.
+ *
+ * @param rb Address of ring buffer.
+ * @param size Ring buffer size (in bytes).
+ * @param data Ring buffer data area (uint8_t data[size]).
+ */
+void ring_buf64_init(struct ring_buf64 *rb, uint64_t size, uint8_t *data);
+
+/**
+ * @brief Initialize a 64-bit index ring buffer with allocated storage.
+ *
+ * Storage is mapped anonymously, optionally backed by huge pages to reduce
+ * TLB misses when streaming through large rings, and must be released with
+ * @ref ring_buf64_free. Pages are only committed when first written.
+ *
+ * @note Only available on Linux (mmap).
+ *
+ * @param rb Address of ring buffer.
+ * @param size Ring buffer size (in bytes). With RING_BUF64_ALLOC_HUGETLB,
+ *             the mapping is rounded up to RING_BUF64_HUGE_PAGE_SIZE.
+ * @param flags 0, RING_BUF64_ALLOC_HUGETLB or RING_BUF64_ALLOC_THP.
+ *
+ * @retval 0 Ring buffer was initialized.
+ * @retval -1 @a size is zero or too big, or @a flags are invalid.
+ * @retval -2 Storage could not be allocated or is not supported.
+ */
+int32_t ring_buf64_alloc(struct ring_buf64 *rb, uint64_t size, uint32_t flags);
+
+/**
+ * @brief Release the storage of a ring buffer initialized with
+ *        @ref ring_buf64_alloc.
+ *
+ * @param rb Address of ring buffer.
+ */
+void ring_buf64_free(struct ring_buf64 *rb);
+
+/**
+ * @brief Determine if a 64-bit index ring buffer is empty.
+ *
+ * As @ref ring_buf_is_empty, data claimed by the consumer counts as read.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return true if the ring buffer is empty, or false if not.
+ */
+bool ring_buf64_is_empty(struct ring_buf64 *rb);
+
+/**
+ * @brief Reset 64-bit index ring buffer state.
+ *
+ * @warning
+ * Must not run concurrently with any other operation on the same ring
+ * buffer.
+ *
+ * @param rb Address of ring buffer.
+ */
+void ring_buf64_reset(struct ring_buf64 *rb);
+
+/**
+ * @brief Determine free space in a 64-bit index ring buffer.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return Ring buffer free space (in bytes).
+ */
+uint64_t ring_buf64_space_get(struct ring_buf64 *rb);
+
+/**
+ * @brief Return 64-bit index ring buffer capacity.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return Ring buffer capacity (in bytes).
+ */
+uint64_t ring_buf64_capacity_get(struct ring_buf64 *rb);
+
+/**
+ * @brief Determine used space in a 64-bit index ring buffer.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return Ring buffer space used (in bytes).
+ */
+uint64_t ring_buf64_size_get(struct ring_buf64 *rb);
+
+/**
+ * @brief Allocate buffer for writing data to a 64-bit index ring buffer.
+ *
+ * Same as @ref ring_buf_put_claim.
+ *
+ * @param[in]  rb   Address of ring buffer.
+ * @param[out] data Pointer to the address. It is set to a location within
+ *                  ring buffer.
+ * @param[in]  size Requested allocation size (in bytes).
+ *
+ * @return Size of allocated buffer which can be smaller than requested if
+ *         there is not enough free space or buffer wraps.
+ */
+uint64_t ring_buf64_put_claim(struct ring_buf64 *rb, uint8_t **data, uint64_t size);
+
+/**
+ * @brief Indicate number of bytes written to allocated buffers.
+ *
+ * Same as @ref ring_buf_put_finish.
+ *
+ * @param rb   Address of ring buffer.
+ * @param size Number of valid bytes in the allocated buffers.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 Provided @a size exceeds free space in the ring buffer.
+ */
+int32_t ring_buf64_put_finish(struct ring_buf64 *rb, uint64_t size);
+
+/**
+ * @brief Write (copy) data to a 64-bit index ring buffer.
+ *
+ * @param rb Address of ring buffer.
+ * @param data Address of data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written.
+ */
+uint64_t ring_buf64_put(struct ring_buf64 *rb, const uint8_t *data, uint64_t size);
+
+/**
+ * @brief Get address of valid data in a 64-bit index ring buffer.
+ *
+ * Same as @ref ring_buf_get_claim.
+ *
+ * @param[in]  rb   Address of ring buffer.
+ * @param[out] data Pointer to the address. It is set to a location within
+ *                  ring buffer.
+ * @param[in]  size Requested size (in bytes).
+ *
+ * @return Number of valid bytes in the provided buffer which can be smaller
+ *         than requested if there is not enough data or buffer wraps.
+ */
+uint64_t ring_buf64_get_claim(struct ring_buf64 *rb, uint8_t **data, uint64_t size);
+
+/**
+ * @brief Indicate number of bytes read from claimed buffer.
+ *
+ * Same as @ref ring_buf_get_finish.
+ *
+ * @param rb   Address of ring buffer.
+ * @param size Number of bytes that can be freed.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 Provided @a size exceeds valid bytes in the ring buffer.
+ */
+int32_t ring_buf64_get_finish(struct ring_buf64 *rb, uint64_t size);
+
+/**
+ * @brief Read data from a 64-bit index ring buffer.
+ *
+ * @param rb   Address of ring buffer.
+ * @param data Address of the output buffer. Can be NULL to discard data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes read.
+ */
+uint64_t ring_buf64_get(struct ring_buf64 *rb, uint8_t *data, uint64_t size);
+
+/**
+ * @brief Peek at data from a 64-bit index ring buffer.
+ *
+ * Same as @ref ring_buf_peek.
+ *
+ * @param rb   Address of ring buffer.
+ * @param data Address of the output buffer. Cannot be NULL.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written to the output buffer.
+ */
+uint64_t ring_buf64_peek(struct ring_buf64 *rb, uint8_t *data, uint64_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_BUFFER64_H */
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ring_buffer_bcast.h"
+
+#include <string.h>
+#include <assert.h>
+
+#define RING_BUFFER_SIZE_ASSERT_MSG "Size too big"
+#define RING_BUFFER_POW2_ASSERT_MSG "Size must be a power of two"
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+/*
+ * Indices run freely and are masked on access. put_tail is published by the
+ * producer and each reader's get_tail by that reader, with release semantics;
+ * the opposite side observes them with acquire semantics. The producer keeps
+ * the position of the slowest reader in get_tail_cache and only scans the
+ * readers again when the cached position does not leave enough space.
+ */
+#define RING_BUF_LOAD_ACQUIRE(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define RING_BUF_STORE_RELEASE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+
+
+static uint32_t ring_buf_bcast_put_space(struct ring_buf_bcast *rb, uint32_t size);
+static uint32_t ring_buf_bcast_slowest_get(struct ring_buf_bcast *rb);
+
+
+void ring_buf_bcast_init(struct ring_buf_bcast *rb, uint32_t size, uint8_t *data)
+{
+    assert(size != 0 && (size & (size - 1)) == 0 && RING_BUFFER_POW2_ASSERT_MSG);
+    assert(size < RING_BUFFER_MAX_SIZE && RING_BUFFER_SIZE_ASSERT_MSG);
+
+    rb->buffer = data;
+    rb->mask = size - 1;
+
+    for (uint32_t i = 0; i < RING_BUF_BCAST_MAX_READERS; i++) {
+        rb->readers[i] = NULL;
+    }
+
+    rb->put_head = 0;
+    rb->put_tail = 0;
+    rb->get_tail_cache = 0;
+}
+
+int32_t ring_buf_bcast_reader_add(struct ring_buf_bcast *rb,
+                                  struct ring_buf_bcast_reader *reader)
+{
+    for (uint32_t i = 0; i < RING_BUF_BCAST_MAX_READERS; i++) {
+        if (rb->readers[i] == NULL) {
+            reader->rb = rb;
+            reader->get_head = rb->put_tail;
+            reader->get_tail = rb->put_tail;
+            reader->put_tail_cache = rb->put_tail;
+            rb->readers[i] = reader;
+
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int32_t ring_buf_bcast_reader_remove(struct ring_buf_bcast_reader *reader)
+{
+    struct ring_buf_bcast *rb = reader->rb;
+
+    if (rb == NULL) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < RING_BUF_BCAST_MAX_READERS; i++) {
+        if (rb->readers[i] == reader) {
+            rb->readers[i] = NULL;
+            reader->rb = NULL;
+            /* the cached position may belong to the detached reader */
+            rb->get_tail_cache = ring_buf_bcast_slowest_get(rb);
+
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+uint32_t ring_buf_bcast_space_get(struct ring_buf_bcast *rb)
+{
+    return ring_buf_bcast_put_space(rb, rb->mask + 1);
+}
+
+uint32_t ring_buf_bcast_put_claim(struct ring_buf_bcast *rb, uint8_t **data, uint32_t size)
+{
+    uint32_t offset = rb->put_head & rb->mask;
+    uint32_t wrap_size = rb->mask + 1 - offset;
+    uint32_t free_space = ring_buf_bcast_put_space(rb, size);
+
+    size = MIN(size, free_space);
+    size = MIN(size, wrap_size);
+
+    *data = &rb->buffer[offset];
+    rb->put_head += size;
+
+    return size;
+}
+
+int32_t ring_buf_bcast_put_finish(struct ring_buf_bcast *rb, uint32_t size)
+{
+    uint32_t finish_space = rb->put_head - rb->put_tail;
+
+    if (size > finish_space) {
+        return -1;
+    }
+
+    uint32_t put_tail = rb->put_tail + size;
+
+    rb->put_head = put_tail;
+    RING_BUF_STORE_RELEASE(&rb->put_tail, put_tail);
+
+    return 0;
+}
+
+uint32_t ring_buf_bcast_put(struct ring_buf_bcast *rb, const uint8_t *data, uint32_t size)
+{
+    uint32_t total_size = 0;
+    uint32_t partial_size;
+
+    do {
+        uint8_t *dst;
+        partial_size = ring_buf_bcast_put_claim(rb, &dst, size);
+        memcpy(dst, data, partial_size);
+        total_size += partial_size;
+        size -= partial_size;
+        data += partial_size;
+    } while (size && partial_size);
+
+    int32_t finish_result = ring_buf_bcast_put_finish(rb, total_size);
+    assert(finish_result == 0);
+    (void) finish_result;
+
+    return total_size;
+}
+
+uint32_t ring_buf_bcast_size_get(struct ring_buf_bcast_reader *reader)
+{
+    reader->put_tail_cache = RING_BUF_LOAD_ACQUIRE(&reader->rb->put_tail);
+
+    return reader->put_tail_cache - reader->get_tail;
+}
+
+uint32_t ring_buf_bcast_get_claim(struct ring_buf_bcast_reader *reader, uint8_t **data,
+                                  uint32_t size)
+{
+    struct ring_buf_bcast *rb = reader->rb;
+    uint32_t offset = reader->get_head & rb->mask;
+    uint32_t wrap_size = rb->mask + 1 - offset;
+    uint32_t available = reader->put_tail_cache - reader->get_head;
+
+    if (available < size) {
+        reader->put_tail_cache = RING_BUF_LOAD_ACQUIRE(&rb->put_tail);
+        available = reader->put_tail_cache - reader->get_head;
+    }
+
+    size = MIN(size, available);
+    size = MIN(size, wrap_size);
+
+    *data = &rb->buffer[offset];
+    reader->get_head += size;
+
+    return size;
+}
+
+int32_t ring_buf_bcast_get_finish(struct ring_buf_bcast_reader *reader, uint32_t size)
+{
+    uint32_t finish_space = reader->get_head - reader->get_tail;
+
+    if (size > finish_space) {
+        return -1;
+    }
+
+    uint32_t get_tail = reader->get_tail + size;
+
+    reader->get_head = get_tail;
+    RING_BUF_STORE_RELEASE(&reader->get_tail, get_tail);
+
+    return 0;
+}
+
+uint32_t ring_buf_bcast_get(struct ring_buf_bcast_reader *reader, uint8_t *data, uint32_t size)
+{
+    uint32_t total_size = 0;
+    uint32_t partial_size;
+
+    do {
+        uint8_t *src;
+        partial_size = ring_buf_bcast_get_claim(reader, &src, size);
+        if (data) {
+            memcpy(data, src, partial_size);
+            data += partial_size;
+        }
+        total_size += partial_size;
+        size -= partial_size;
+    } while (size && partial_size);
+
+    int32_t finish_result = ring_buf_bcast_get_finish(reader, total_size);
+    assert(finish_result == 0);
+    (void) finish_result;
+
+    return total_size;
+}
+
+static uint32_t ring_buf_bcast_put_space(struct ring_buf_bcast *rb, uint32_t size)
+{
+    uint32_t space = rb->mask + 1 - (rb->put_head - rb->get_tail_cache);
+
+    if (space < size) {
+        rb->get_tail_cache = ring_buf_bcast_slowest_get(rb);
+        space = rb->mask + 1 - (rb->put_head - rb->get_tail_cache);
+    }
+
+    return space;
+}
+
+static uint32_t ring_buf_bcast_slowest_get(struct ring_buf_bcast *rb)
+{
+    /* with no reader attached, written data is simply dropped */
+    uint32_t max_lag = 0;
+
+    for (uint32_t i = 0; i < RING_BUF_BCAST_MAX_READERS; i++) {
+        struct ring_buf_bcast_reader *reader = rb->readers[i];
+
+        if (reader != NULL) {
+            uint32_t lag = rb->put_tail - RING_BUF_LOAD_ACQUIRE(&reader->get_tail);
+
+            max_lag = lag > max_lag ? lag : max_lag;
+        }
+    }
+
+    return rb->put_tail - max_lag;
+}
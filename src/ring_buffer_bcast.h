@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef RING_BUFFER_BCAST_H
+#define RING_BUFFER_BCAST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @cond INTERNAL_HIDDEN */
+/* Largest number of readers attached at once to a broadcast ring buffer. */
+#ifndef RING_BUF_BCAST_MAX_READERS
+#define RING_BUF_BCAST_MAX_READERS 8u
+#endif
+/** @endcond */
+
+struct ring_buf_bcast;
+
+/**
+ * @brief A structure to represent a reader of a broadcast ring buffer.
+ *
+ * Each reader owns its own read cursor: it sees every byte written after it
+ * was attached, at its own pace, without copying the data of other readers.
+ */
+struct ring_buf_bcast_reader {
+    /** @cond INTERNAL_HIDDEN */
+    struct ring_buf_bcast *rb;
+    uint32_t get_head;
+    uint32_t get_tail;
+    uint32_t put_tail_cache;
+    RING_BUF_CACHE_LINE_PAD(pad0)
+    /** @endcond */
+};
+
+/**
+ * @brief A structure to represent a single producer/multiple readers
+ *        broadcast ring buffer.
+ *
+ * Data is written once and read by every attached reader. The space
+ * available to the producer is governed by the slowest reader, so a reader
+ * that stops reading eventually stalls the producer until it is detached.
+ *
+ * The producer and each reader may run in their own thread without locking.
+ */
+struct ring_buf_bcast {
+    /** @cond INTERNAL_HIDDEN */
+    uint8_t *buffer;
+    uint32_t mask;
+    struct ring_buf_bcast_reader *readers[RING_BUF_BCAST_MAX_READERS];
+    RING_BUF_CACHE_LINE_PAD(pad0)
+    uint32_t put_head;
+    uint32_t put_tail;
+    uint32_t get_tail_cache;
+    RING_BUF_CACHE_LINE_PAD(pad1)
+    /** @endcond */
+};
+
+/**
+ * @brief Initialize a broadcast ring buffer.
+ *
+ * This routine initializes a ring buffer, prior to its first use. It has no
+ * reader attached.
+ *
+ * @param rb Address of ring buffer.
+ * @param size Ring buffer size (in bytes, must be a power of two).
+ * @param data Ring buffer data area (uint8_t data[size]).
+ */
+void ring_buf_bcast_init(struct ring_buf_bcast *rb, uint32_t size, uint8_t *data);
+
+/**
+ * @brief Attach a reader to a broadcast ring buffer.
+ *
+ * The reader starts at the current write position: it only sees data
+ * written from now on.
+ *
+ * @warning
+ * Must not be called concurrently with a write operation to the ring
+ * buffer: call it from the producer thread or while the producer is idle.
+ *
+ * @param rb Address of ring buffer.
+ * @param reader Address of reader.
+ *
+ * @retval 0 Reader was attached.
+ * @retval -1 RING_BUF_BCAST_MAX_READERS readers are already attached.
+ */
+int32_t ring_buf_bcast_reader_add(struct ring_buf_bcast *rb,
+                                  struct ring_buf_bcast_reader *reader);
+
+/**
+ * @brief Detach a reader from a broadcast ring buffer.
+ *
+ * The reader no longer holds back the producer.
+ *
+ * @warning
+ * Must not be called concurrently with a write operation to the ring
+ * buffer, nor with a read operation of @a reader.
+ *
+ * @param reader Address of reader.
+ *
+ * @retval 0 Reader was detached.
+ * @retval -1 Reader is not attached.
+ */
+int32_t ring_buf_bcast_reader_remove(struct ring_buf_bcast_reader *reader);
+
+/**
+ * @brief Determine free space of a broadcast ring buffer.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return Ring buffer free space (in bytes) left by the slowest reader.
+ */
+uint32_t ring_buf_bcast_space_get(struct ring_buf_bcast *rb);
+
+/**
+ * @brief Allocate buffer for writing data to a broadcast ring buffer.
+ *
+ * Same as @ref ring_buf_put_claim.
+ *
+ * @param[in]  rb   Address of ring buffer.
+ * @param[out] data Pointer to the address. It is set to a location within
+ *                  ring buffer.
+ * @param[in]  size Requested allocation size (in bytes).
+ *
+ * @return Size of allocated buffer which can be smaller than requested if
+ *         there is not enough free space or buffer wraps.
+ */
+uint32_t ring_buf_bcast_put_claim(struct ring_buf_bcast *rb, uint8_t **data, uint32_t size);
+
+/**
+ * @brief Indicate number of bytes written to allocated buffers.
+ *
+ * Same as @ref ring_buf_put_finish. The bytes become visible to every
+ * attached reader.
+ *
+ * @param rb   Address of ring buffer.
+ * @param size Number of valid bytes in the allocated buffers.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 Provided @a size exceeds free space in the ring buffer.
+ */
+int32_t ring_buf_bcast_put_finish(struct ring_buf_bcast *rb, uint32_t size);
+
+/**
+ * @brief Write (copy) data to a broadcast ring buffer.
+ *
+ * @param rb Address of ring buffer.
+ * @param data Address of data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written.
+ */
+uint32_t ring_buf_bcast_put(struct ring_buf_bcast *rb, const uint8_t *data, uint32_t size);
+
+/**
+ * @brief Determine the number of bytes a reader has not read yet.
+ *
+ * @param reader Address of reader.
+ *
+ * @return Number of bytes available to @a reader.
+ */
+uint32_t ring_buf_bcast_size_get(struct ring_buf_bcast_reader *reader);
+
+/**
+ * @brief Get address of valid data in a broadcast ring buffer.
+ *
+ * Same as @ref ring_buf_get_claim, for the cursor of @a reader only.
+ *
+ * @param[in]  reader Address of reader.
+ * @param[out] data   Pointer to the address. It is set to a location within
+ *                    ring buffer.
+ * @param[in]  size   Requested size (in bytes).
+ *
+ * @return Number of valid bytes in the provided buffer which can be smaller
+ *         than requested if there is not enough data or buffer wraps.
+ */
+uint32_t ring_buf_bcast_get_claim(struct ring_buf_bcast_reader *reader, uint8_t **data,
+                                  uint32_t size);
+
+/**
+ * @brief Indicate number of bytes read from claimed buffer.
+ *
+ * Same as @ref ring_buf_get_finish. The space is returned to the producer
+ * once every attached reader has read it.
+ *
+ * @param reader Address of reader.
+ * @param size   Number of bytes that can be freed.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 Provided @a size exceeds valid bytes in the ring buffer.
+ */
+int32_t ring_buf_bcast_get_finish(struct ring_buf_bcast_reader *reader, uint32_t size);
+
+/**
+ * @brief Read data from a broadcast ring buffer.
+ *
+ * @param reader Address of reader.
+ * @param data   Address of the output buffer. Can be NULL to discard data.
+ * @param size   Data size (in bytes).
+ *
+ * @retval Number of bytes read.
+ */
+uint32_t ring_buf_bcast_get(struct ring_buf_bcast_reader *reader, uint8_t *data, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_BUFFER_BCAST_H */
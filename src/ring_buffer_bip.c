@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ring_buffer_bip.h"
+
+#include <stddef.h>
+#include <assert.h>
+
+#define RING_BUFFER_SIZE_ASSERT_MSG "Size too big"
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+/*
+ * write and read are storage offsets. While write >= read, data lies in
+ * [read, write). Once the producer has restarted from the beginning of the
+ * storage, write < read and data lies in [read, watermark) then [0, write).
+ * write may never catch up with read from below, as equal offsets mean
+ * empty.
+ *
+ * write is published by the producer with release semantics after the data
+ * and, when restarting, after the watermark; read is published by the
+ * consumer the same way once data is freed.
+ */
+#define RING_BUF_LOAD_RELAXED(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#define RING_BUF_LOAD_ACQUIRE(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define RING_BUF_STORE_RELAXED(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELAXED)
+#define RING_BUF_STORE_RELEASE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+
+
+void ring_buf_bip_init(struct ring_buf_bip *rb, uint32_t size, uint8_t *data)
+{
+    assert(size < RING_BUFFER_MAX_SIZE && RING_BUFFER_SIZE_ASSERT_MSG);
+
+    rb->buffer = data;
+    rb->size = size;
+    ring_buf_bip_reset(rb);
+}
+
+void ring_buf_bip_reset(struct ring_buf_bip *rb)
+{
+    rb->write = 0;
+    rb->watermark = 0;
+    rb->put_start = 0;
+    rb->put_size = 0;
+    rb->read = 0;
+    rb->get_start = 0;
+    rb->get_size = 0;
+}
+
+bool ring_buf_bip_is_empty(struct ring_buf_bip *rb)
+{
+    return ring_buf_bip_size_get(rb) == 0;
+}
+
+uint32_t ring_buf_bip_size_get(struct ring_buf_bip *rb)
+{
+    uint32_t read = RING_BUF_LOAD_ACQUIRE(&rb->read);
+    uint32_t write = RING_BUF_LOAD_ACQUIRE(&rb->write);
+
+    if (write >= read) {
+        return write - read;
+    }
+
+    return RING_BUF_LOAD_RELAXED(&rb->watermark) - read + write;
+}
+
+uint32_t ring_buf_bip_space_get(struct ring_buf_bip *rb)
+{
+    uint32_t write = rb->write;
+    uint32_t read = RING_BUF_LOAD_ACQUIRE(&rb->read);
+
+    if (write < read) {
+        return read - write - 1;
+    }
+
+    uint32_t head_space = (read > 0) ? read - 1 : 0;
+
+    return (rb->size - write > head_space) ? rb->size - write : head_space;
+}
+
+uint32_t ring_buf_bip_put_claim(struct ring_buf_bip *rb, uint8_t **data, uint32_t size)
+{
+    uint32_t write = rb->write;
+    uint32_t read = RING_BUF_LOAD_ACQUIRE(&rb->read);
+    uint32_t start;
+
+    if (write >= read) {
+        if (size <= rb->size - write) {
+            start = write;
+        } else if (size < read) {
+            /* restart from the beginning, skipping the end of the storage */
+            start = 0;
+        } else {
+            return 0;
+        }
+    } else if (size < read - write) {
+        start = write;
+    } else {
+        return 0;
+    }
+
+    rb->put_start = start;
+    rb->put_size = size;
+    *data = &rb->buffer[start];
+
+    return size;
+}
+
+int32_t ring_buf_bip_put_finish(struct ring_buf_bip *rb, uint32_t size)
+{
+    if (size > rb->put_size) {
+        return -1;
+    }
+
+    rb->put_size = 0;
+
+    if (size == 0) {
+        return 0;
+    }
+
+    if (rb->put_start != rb->write) {
+        /* data before the restart ends where writing stopped */
+        RING_BUF_STORE_RELAXED(&rb->watermark, rb->write);
+    }
+
+    RING_BUF_STORE_RELEASE(&rb->write, rb->put_start + size);
+
+    return 0;
+}
+
+uint32_t ring_buf_bip_get_claim(struct ring_buf_bip *rb, uint8_t **data, uint32_t size)
+{
+    uint32_t read = rb->read;
+    uint32_t write = RING_BUF_LOAD_ACQUIRE(&rb->write);
+    uint32_t start = read;
+    uint32_t available;
+
+    if (write >= read) {
+        available = write - read;
+    } else {
+        uint32_t watermark = RING_BUF_LOAD_RELAXED(&rb->watermark);
+
+        if (read == watermark) {
+            /* older region fully read: continue with the newer one */
+            start = 0;
+            available = write;
+        } else {
+            available = watermark - read;
+        }
+    }
+
+    size = MIN(size, available);
+
+    rb->get_start = start;
+    rb->get_size = size;
+    *data = &rb->buffer[start];
+
+    return size;
+}
+
+int32_t ring_buf_bip_get_finish(struct ring_buf_bip *rb, uint32_t size)
+{
+    if (size > rb->get_size) {
+        return -1;
+    }
+
+    rb->get_size = 0;
+
+    if (size == 0) {
+        return 0;
+    }
+
+    RING_BUF_STORE_RELEASE(&rb->read, rb->get_start + size);
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef RING_BUFFER_BIP_H
+#define RING_BUFFER_BIP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A structure to represent a bipartite ring buffer (bip-buffer).
+ *
+ * Unlike struct ring_buf, whose claims are cut at the end of the storage, a
+ * bip-buffer hands out every claim as a single contiguous span. When a claim
+ * does not fit before the end of the storage, it is placed at its beginning
+ * and the bytes left at the end are skipped: data is then held in two
+ * regions, the older one up to a watermark at the end of the storage and the
+ * newer one from its beginning. Readers get the regions one after the other.
+ *
+ * Contiguous spans come at the cost of the skipped bytes: a claim of up to
+ * half the capacity always succeeds once the ring buffer is empty, larger
+ * claims depend on where the previous data ended.
+ *
+ * One producer and one consumer may use a bip-buffer concurrently from
+ * different threads without any locking.
+ */
+struct ring_buf_bip {
+    /** @cond INTERNAL_HIDDEN */
+    uint8_t *buffer;
+    uint32_t size;
+    RING_BUF_CACHE_LINE_PAD(pad0)
+    /* producer state */
+    uint32_t write;
+    uint32_t watermark;
+    uint32_t put_start;
+    uint32_t put_size;
+    RING_BUF_CACHE_LINE_PAD(pad1)
+    /* consumer state */
+    uint32_t read;
+    uint32_t get_start;
+    uint32_t get_size;
+    RING_BUF_CACHE_LINE_PAD(pad2)
+    /** @endcond */
+};
+
+/**
+ * @brief Initialize a bip-buffer.
+ *
+ * @param rb Address of ring buffer.
+ * @param size Ring buffer size (in bytes).
+ * @param data Ring buffer data area (uint8_t data[size]).
+ */
+void ring_buf_bip_init(struct ring_buf_bip *rb, uint32_t size, uint8_t *data);
+
+/**
+ * @brief Reset bip-buffer state.
+ *
+ * @warning
+ * Must not run concurrently with any other operation on the same ring
+ * buffer.
+ *
+ * @param rb Address of ring buffer.
+ */
+void ring_buf_bip_reset(struct ring_buf_bip *rb);
+
+/**
+ * @brief Determine if a bip-buffer is empty.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return true if the ring buffer is empty, or false if not.
+ */
+bool ring_buf_bip_is_empty(struct ring_buf_bip *rb);
+
+/**
+ * @brief Determine used space in a bip-buffer.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return Number of bytes held in both regions.
+ */
+uint32_t ring_buf_bip_size_get(struct ring_buf_bip *rb);
+
+/**
+ * @brief Determine the largest claim a bip-buffer can currently grant.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return Size (in bytes) of the largest contiguous free span.
+ */
+uint32_t ring_buf_bip_space_get(struct ring_buf_bip *rb);
+
+/**
+ * @brief Allocate a contiguous buffer for writing data to a bip-buffer.
+ *
+ * The claim is granted whole or not at all. Claiming again before
+ * @ref ring_buf_bip_put_finish replaces the pending claim.
+ *
+ * @param[in]  rb   Address of ring buffer.
+ * @param[out] data Set to the location of the span within ring buffer.
+ * @param[in]  size Requested size (in bytes).
+ *
+ * @return @a size if the span was allocated, or 0 if no contiguous span of
+ *         @a size bytes is free.
+ */
+uint32_t ring_buf_bip_put_claim(struct ring_buf_bip *rb, uint8_t **data, uint32_t size);
+
+/**
+ * @brief Indicate number of bytes written to the claimed span.
+ *
+ * The bytes become visible to the consumer; the rest of the span returns to
+ * the free space.
+ *
+ * @param rb   Address of ring buffer.
+ * @param size Number of valid bytes, from the start of the span.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 Provided @a size exceeds the claimed size.
+ */
+int32_t ring_buf_bip_put_finish(struct ring_buf_bip *rb, uint32_t size);
+
+/**
+ * @brief Get address of contiguous valid data in a bip-buffer.
+ *
+ * Returns data of the older region first; the newer region is returned once
+ * the older one has been fully read.
+ *
+ * @param[in]  rb   Address of ring buffer.
+ * @param[out] data Set to the location of the data within ring buffer.
+ * @param[in]  size Requested size (in bytes).
+ *
+ * @return Number of valid bytes, which can be smaller than requested if
+ *         there is not enough data in the current region.
+ */
+uint32_t ring_buf_bip_get_claim(struct ring_buf_bip *rb, uint8_t **data, uint32_t size);
+
+/**
+ * @brief Indicate number of bytes read from the claimed data.
+ *
+ * @param rb   Address of ring buffer.
+ * @param size Number of bytes that can be freed.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 Provided @a size exceeds the claimed size.
+ */
+int32_t ring_buf_bip_get_finish(struct ring_buf_bip *rb, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_BUFFER_BIP_H */
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ring_buffer_io.h"
+
+#include <assert.h>
+#include <errno.h>
+
+
+uint32_t ring_buf_put_claim_iov(struct ring_buf *rb,
+                                struct iovec iov[RING_BUF_IOV_MAX],
+                                int *iovcnt, uint32_t size)
+{
+    uint32_t total_size = 0;
+
+    *iovcnt = 0;
+
+    /* at most two claims: up to the wrap point, then from the beginning */
+    while (*iovcnt < RING_BUF_IOV_MAX && size) {
+        uint8_t *dst;
+        uint32_t partial_size = ring_buf_put_claim(rb, &dst, size);
+
+        if (partial_size == 0) {
+            break;
+        }
+
+        iov[*iovcnt].iov_base = dst;
+        iov[*iovcnt].iov_len = partial_size;
+        (*iovcnt)++;
+        total_size += partial_size;
+        size -= partial_size;
+    }
+
+    return total_size;
+}
+
+uint32_t ring_buf_get_claim_iov(struct ring_buf *rb,
+                                struct iovec iov[RING_BUF_IOV_MAX],
+                                int *iovcnt, uint32_t size)
+{
+    uint32_t total_size = 0;
+
+    *iovcnt = 0;
+
+    /* at most two claims: up to the wrap point, then from the beginning */
+    while (*iovcnt < RING_BUF_IOV_MAX && size) {
+        uint8_t *src;
+        uint32_t partial_size = ring_buf_get_claim(rb, &src, size);
+
+        if (partial_size == 0) {
+            break;
+        }
+
+        iov[*iovcnt].iov_base = src;
+        iov[*iovcnt].iov_len = partial_size;
+        (*iovcnt)++;
+        total_size += partial_size;
+        size -= partial_size;
+    }
+
+    return total_size;
+}
+
+ssize_t ring_buf_read_fd(struct ring_buf *rb, int fd, uint32_t size)
+{
+    struct iovec iov[RING_BUF_IOV_MAX];
+    int iovcnt;
+
+    if (ring_buf_put_claim_iov(rb, iov, &iovcnt, size) == 0) {
+        if (size == 0) {
+            return 0;
+        }
+
+        /* not 0, which would mean end of file */
+        errno = ENOBUFS;
+
+        return -1;
+    }
+
+    ssize_t result = readv(fd, iov, iovcnt);
+
+    /* commit what was read and give the rest of the claim back */
+    int32_t finish_result = ring_buf_put_finish(rb, (result > 0) ? (uint32_t) result : 0);
+    assert(finish_result == 0);
+    (void) finish_result;
+
+    return result;
+}
+
+ssize_t ring_buf_write_fd(struct ring_buf *rb, int fd, uint32_t size)
+{
+    struct iovec iov[RING_BUF_IOV_MAX];
+    int iovcnt;
+
+    if (ring_buf_get_claim_iov(rb, iov, &iovcnt, size) == 0) {
+        return 0;
+    }
+
+    ssize_t result = writev(fd, iov, iovcnt);
+
+    /* free what was written and keep the rest for a later call */
+    int32_t finish_result = ring_buf_get_finish(rb, (result > 0) ? (uint32_t) result : 0);
+    assert(finish_result == 0);
+    (void) finish_result;
+
+    return result;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef RING_BUFFER_IO_H
+#define RING_BUFFER_IO_H
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum number of segments returned by the iovec claim routines.
+ */
+#define RING_BUF_IOV_MAX 2
+
+/**
+ * @brief Allocate buffers for writing data to a ring buffer, across the
+ *        wrap point.
+ *
+ * Works like @ref ring_buf_put_claim but returns both the region up to the
+ * end of the storage and the one continuing at its beginning, so that up to
+ * the whole free space can be claimed at once. Once data is written the
+ * number of bytes written must be confirmed with @ref ring_buf_put_finish.
+ *
+ * @warning
+ * Use cases involving multiple writers to the ring buffer must prevent
+ * concurrent write operations, either by preventing all writers from
+ * being preempted or by using a mutex to govern writes to the ring buffer.
+ *
+ * @param[in]  rb     Address of ring buffer.
+ * @param[out] iov    Segments set to locations within the ring buffer.
+ * @param[out] iovcnt Number of segments used in @a iov (0 to 2).
+ * @param[in]  size   Requested allocation size (in bytes).
+ *
+ * @return Total size of the allocated segments, which can be smaller than
+ *         requested if there is not enough free space.
+ */
+uint32_t ring_buf_put_claim_iov(struct ring_buf *rb,
+                                struct iovec iov[RING_BUF_IOV_MAX],
+                                int *iovcnt, uint32_t size);
+
+/**
+ * @brief Get addresses of valid data in a ring buffer, across the wrap
+ *        point.
+ *
+ * Works like @ref ring_buf_get_claim but returns both the region up to the
+ * end of the storage and the one continuing at its beginning. Once data is
+ * processed it must be freed using @ref ring_buf_get_finish.
+ *
+ * @warning
+ * Use cases involving multiple reads of the ring buffer must prevent
+ * concurrent read operations, either by preventing all readers from
+ * being preempted or by using a mutex to govern reads to the ring buffer.
+ *
+ * @param[in]  rb     Address of ring buffer.
+ * @param[out] iov    Segments set to locations within the ring buffer.
+ * @param[out] iovcnt Number of segments used in @a iov (0 to 2).
+ * @param[in]  size   Requested size (in bytes).
+ *
+ * @return Total size of valid data in the segments, which can be smaller
+ *         than requested if there is not enough valid data.
+ */
+uint32_t ring_buf_get_claim_iov(struct ring_buf *rb,
+                                struct iovec iov[RING_BUF_IOV_MAX],
+                                int *iovcnt, uint32_t size);
+
+/**
+ * @brief Read from a file descriptor straight into a ring buffer.
+ *
+ * Up to @a size bytes are read with a single readv() into the free space of
+ * the ring buffer and committed, without any intermediate copy.
+ *
+ * @param rb   Address of ring buffer.
+ * @param fd   File descriptor to read from (socket, pipe, file...).
+ * @param size Maximum number of bytes to read.
+ *
+ * @return Number of bytes read and committed. 0 on end of file, or when
+ *         @a size is 0 (no system call is made). -1 with errno set to
+ *         ENOBUFS when the ring buffer is full (no system call is made),
+ *         or on error, with errno set by readv().
+ */
+ssize_t ring_buf_read_fd(struct ring_buf *rb, int fd, uint32_t size);
+
+/**
+ * @brief Write from a ring buffer straight to a file descriptor.
+ *
+ * Up to @a size bytes of valid data are written with a single writev() and
+ * only the bytes actually written are removed from the ring buffer.
+ *
+ * @param rb   Address of ring buffer.
+ * @param fd   File descriptor to write to (socket, pipe, file...).
+ * @param size Maximum number of bytes to write.
+ *
+ * @return Number of bytes written and removed. 0 when @a size is 0 or the
+ *         ring buffer is empty (no system call is made in these cases). -1
+ *         on error, with errno set by writev().
+ */
+ssize_t ring_buf_write_fd(struct ring_buf *rb, int fd, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_BUFFER_IO_H */
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include "ring_buffer_mirror.h"
+
+#include <stddef.h>
+
+#if defined(__linux__)
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+static uint32_t page_size_get(void);
+
+
+uint32_t ring_buf_mirror_size_align(uint32_t size)
+{
+    uint32_t page_size = page_size_get();
+
+    if (page_size == 0) {
+        return 0;
+    }
+
+    return ((size + page_size - 1) / page_size) * page_size;
+}
+
+int32_t ring_buf_mirror_init(struct ring_buf *rb, uint32_t size)
+{
+    uint32_t page_size = page_size_get();
+
+    if (size == 0 || size >= RING_BUFFER_MAX_SIZE || page_size == 0 ||
+        (size % page_size) != 0) {
+        return -1;
+    }
+
+    int fd = memfd_create("ring_buf", MFD_CLOEXEC);
+    if (fd < 0) {
+        return -2;
+    }
+
+    if (ftruncate(fd, size) != 0) {
+        close(fd);
+        return -2;
+    }
+
+    /* reserve twice the size, then map the file over both halves */
+    uint8_t *base = mmap(NULL, 2 * (size_t) size, PROT_NONE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return -2;
+    }
+
+    if (mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+             fd, 0) == MAP_FAILED ||
+        mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+             fd, 0) == MAP_FAILED) {
+        munmap(base, 2 * (size_t) size);
+        close(fd);
+        return -2;
+    }
+
+    /* the mappings keep the memory alive */
+    close(fd);
+
+    ring_buf_init(rb, size, base);
+    rb->flags |= RING_BUF_FLAG_MIRRORED;
+
+    return 0;
+}
+
+void ring_buf_mirror_free(struct ring_buf *rb)
+{
+    if (rb->buffer != NULL && (rb->flags & RING_BUF_FLAG_MIRRORED)) {
+        munmap(rb->buffer, 2 * (size_t) rb->size);
+    }
+
+    rb->buffer = NULL;
+    rb->flags &= ~RING_BUF_FLAG_MIRRORED;
+}
+
+static uint32_t page_size_get(void)
+{
+    long page_size = sysconf(_SC_PAGESIZE);
+
+    return (page_size > 0) ? (uint32_t) page_size : 0;
+}
+
+#else /* !__linux__ */
+
+uint32_t ring_buf_mirror_size_align(uint32_t size)
+{
+    (void) size;
+
+    return 0;
+}
+
+int32_t ring_buf_mirror_init(struct ring_buf *rb, uint32_t size)
+{
+    (void) rb;
+    (void) size;
+
+    return -2;
+}
+
+void ring_buf_mirror_free(struct ring_buf *rb)
+{
+    rb->buffer = NULL;
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef RING_BUFFER_MIRROR_H
+#define RING_BUFFER_MIRROR_H
+
+#include <stdint.h>
+
+#include "ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Round a size up to the granularity required by mirrored storage.
+ *
+ * @param size Requested ring buffer size (in bytes).
+ *
+ * @return Smallest multiple of the system page size that is not lower than
+ *         @a size, or 0 if mirrored storage is not supported.
+ */
+uint32_t ring_buf_mirror_size_align(uint32_t size);
+
+/**
+ * @brief Initialize a ring buffer for byte data backed by mirrored storage.
+ *
+ * The same physical pages are mapped twice, back to back, so that the byte
+ * following the last one of the storage is the first one again. Claims made
+ * with @ref ring_buf_put_claim and @ref ring_buf_get_claim are then only
+ * limited by the free space (or the valid data) and never split at the wrap
+ * point, so whole records can be written or parsed in place.
+ *
+ * Storage is allocated by this routine and must be released with
+ * @ref ring_buf_mirror_free. The ring buffer is otherwise used through the
+ * regular ring_buf_ API.
+ *
+ * @note Only available on Linux (memfd_create and mmap).
+ *
+ * @param rb Address of ring buffer.
+ * @param size Ring buffer size (in bytes). Must be a multiple of the page
+ *             size (see @ref ring_buf_mirror_size_align).
+ *
+ * @retval 0 Ring buffer was initialized.
+ * @retval -1 @a size is zero, too big or not a multiple of the page size.
+ * @retval -2 Mirrored storage could not be allocated or is not supported.
+ */
+int32_t ring_buf_mirror_init(struct ring_buf *rb, uint32_t size);
+
+/**
+ * @brief Release the storage of a ring buffer initialized with
+ *        @ref ring_buf_mirror_init.
+ *
+ * @param rb Address of ring buffer.
+ */
+void ring_buf_mirror_free(struct ring_buf *rb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_BUFFER_MIRROR_H */
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ring_buffer_mpmc.h"
+
+#include <string.h>
+#include <assert.h>
+
+#define RING_BUFFER_SIZE_ASSERT_MSG "Size too big"
+#define RING_BUFFER_POW2_ASSERT_MSG "Slots must be a power of two"
+
+#define RING_BUF_LOAD_RELAXED(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#define RING_BUF_LOAD_ACQUIRE(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define RING_BUF_STORE_RELAXED(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELAXED)
+#define RING_BUF_STORE_RELEASE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#define RING_BUF_CAS_RELAXED(ptr, expected, desired)                         \
+    __atomic_compare_exchange_n((ptr), (expected), (desired), true,         \
+                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+
+/*
+ * Slot layout (in 32-bit words):
+ *   [0] sequence counter, owned by whoever may touch the slot next
+ *   [1] item header, packed as in struct ring_element
+ *   [2] payload, up to max_size32 words
+ *
+ * A slot at position pos is free for a writer when its sequence equals pos,
+ * and holds an item for a reader when its sequence equals pos + 1. Once read,
+ * the sequence is advanced by the number of slots so that the writer of the
+ * next lap finds it free.
+ */
+#define SLOT_SEQ    0u
+#define SLOT_HEADER 1u
+#define SLOT_DATA   2u
+
+
+static uint32_t *ring_buf_mpmc_slot(struct ring_buf_mpmc *rb, uint32_t pos);
+static uint32_t header_pack(uint16_t type, uint8_t value, uint8_t length);
+
+
+void ring_buf_mpmc_item_init(struct ring_buf_mpmc *rb, uint32_t slots,
+                             uint8_t max_size32, uint32_t *data)
+{
+    assert(slots != 0 && (slots & (slots - 1)) == 0 && RING_BUFFER_POW2_ASSERT_MSG);
+    assert(slots < RING_BUFFER_MAX_SIZE / sizeof(uint32_t) && RING_BUFFER_SIZE_ASSERT_MSG);
+
+    rb->buffer = data;
+    rb->mask = slots - 1;
+    rb->slot_size32 = RING_BUF_MPMC_SLOT_SIZE32(max_size32);
+    rb->max_size32 = max_size32;
+
+    for (uint32_t pos = 0; pos < slots; pos++) {
+        RING_BUF_STORE_RELAXED(&ring_buf_mpmc_slot(rb, pos)[SLOT_SEQ], pos);
+    }
+
+    RING_BUF_STORE_RELAXED(&rb->enqueue_pos, 0);
+    RING_BUF_STORE_RELEASE(&rb->dequeue_pos, 0);
+}
+
+bool ring_buf_mpmc_is_empty(struct ring_buf_mpmc *rb)
+{
+    uint32_t pos = RING_BUF_LOAD_RELAXED(&rb->dequeue_pos);
+    uint32_t seq = RING_BUF_LOAD_ACQUIRE(&ring_buf_mpmc_slot(rb, pos)[SLOT_SEQ]);
+
+    return (int32_t) (seq - (pos + 1)) < 0;
+}
+
+uint32_t ring_buf_mpmc_capacity_get(struct ring_buf_mpmc *rb)
+{
+    return rb->mask + 1;
+}
+
+int32_t ring_buf_mpmc_item_put(struct ring_buf_mpmc *rb, uint16_t type,
+                               uint8_t value, const uint32_t *data,
+                               uint8_t size32)
+{
+    if (size32 > rb->max_size32) {
+        return -1;
+    }
+
+    uint32_t pos = RING_BUF_LOAD_RELAXED(&rb->enqueue_pos);
+    uint32_t *slot;
+
+    for (;;) {
+        slot = ring_buf_mpmc_slot(rb, pos);
+
+        uint32_t seq = RING_BUF_LOAD_ACQUIRE(&slot[SLOT_SEQ]);
+        int32_t diff = (int32_t) (seq - pos);
+
+        if (diff == 0) {
+            /* slot is free: try to take it (pos is refreshed on failure) */
+            if (RING_BUF_CAS_RELAXED(&rb->enqueue_pos, &pos, pos + 1)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* slot still holds the item of the previous lap */
+            return -2;
+        } else {
+            /* another writer took the slot */
+            pos = RING_BUF_LOAD_RELAXED(&rb->enqueue_pos);
+        }
+    }
+
+    RING_BUF_STORE_RELAXED(&slot[SLOT_HEADER], header_pack(type, value, size32));
+    memcpy(&slot[SLOT_DATA], data, size32 * sizeof(uint32_t));
+
+    /* publish the item to readers */
+    RING_BUF_STORE_RELEASE(&slot[SLOT_SEQ], pos + 1);
+
+    return 0;
+}
+
+int32_t ring_buf_mpmc_item_get(struct ring_buf_mpmc *rb, uint16_t *type,
+                               uint8_t *value, uint32_t *data,
+                               uint8_t *size32)
+{
+    uint32_t pos = RING_BUF_LOAD_RELAXED(&rb->dequeue_pos);
+    uint32_t *slot;
+    uint32_t header;
+
+    for (;;) {
+        slot = ring_buf_mpmc_slot(rb, pos);
+
+        uint32_t seq = RING_BUF_LOAD_ACQUIRE(&slot[SLOT_SEQ]);
+        int32_t diff = (int32_t) (seq - (pos + 1));
+
+        if (diff == 0) {
+            /* the slot may be recycled by the time the header is read, in
+             * which case the compare-and-swap below fails
+             */
+            header = RING_BUF_LOAD_RELAXED(&slot[SLOT_HEADER]);
+
+            if (data && ((uint8_t) header > *size32)) {
+                /* leave the item where it is */
+                *size32 = (uint8_t) header;
+
+                return -2;
+            }
+
+            /* slot holds an item: try to take it (pos is refreshed on failure) */
+            if (RING_BUF_CAS_RELAXED(&rb->dequeue_pos, &pos, pos + 1)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* slot has not been written yet */
+            return -1;
+        } else {
+            /* another reader took the slot */
+            pos = RING_BUF_LOAD_RELAXED(&rb->dequeue_pos);
+        }
+    }
+
+    *type = (uint16_t) (header >> 16);
+    *value = (uint8_t) (header >> 8);
+    *size32 = (uint8_t) header;
+
+    if (data) {
+        memcpy(data, &slot[SLOT_DATA], *size32 * sizeof(uint32_t));
+    }
+
+    /* hand the slot over to the writer of the next lap */
+    RING_BUF_STORE_RELEASE(&slot[SLOT_SEQ], pos + rb->mask + 1);
+
+    return 0;
+}
+
+static uint32_t *ring_buf_mpmc_slot(struct ring_buf_mpmc *rb, uint32_t pos)
+{
+    return &rb->buffer[(pos & rb->mask) * rb->slot_size32];
+}
+
+static uint32_t header_pack(uint16_t type, uint8_t value, uint8_t length)
+{
+    uint32_t header = (uint32_t) type << 16;
+    header |= (uint32_t) value << 8;
+    header |= length;
+
+    return header;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef RING_BUFFER_MPMC_H
+#define RING_BUFFER_MPMC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of 32-bit words used by one slot of a MPMC item ring buffer.
+ *
+ * Every slot holds a sequence counter, the item header and room for the
+ * largest payload accepted by the ring buffer.
+ *
+ * @param max_size32 Largest data item size (number of 32-bit words).
+ */
+#define RING_BUF_MPMC_SLOT_SIZE32(max_size32) ((uint32_t) (max_size32) + 2u)
+
+/**
+ * @brief Size of the data area of a MPMC item ring buffer.
+ *
+ * @param slots Number of slots (must be a power of two).
+ * @param max_size32 Largest data item size (number of 32-bit words).
+ *
+ * @return Data area size (in 32-bit words).
+ */
+#define RING_BUF_MPMC_BUFFER_SIZE32(slots, max_size32) \
+    ((uint32_t) (slots) * RING_BUF_MPMC_SLOT_SIZE32(max_size32))
+
+/** @cond INTERNAL_HIDDEN */
+/* Fills the rest of the cache line of a 32-bit index. */
+#if RING_BUF_CACHE_LINE_SIZE > 4
+#define RING_BUF_MPMC_INDEX_PAD(name) uint8_t name[RING_BUF_CACHE_LINE_SIZE - sizeof(uint32_t)];
+#else
+#define RING_BUF_MPMC_INDEX_PAD(name)
+#endif
+/** @endcond */
+
+/**
+ * @brief A structure to represent a multi-producer/multi-consumer item
+ *        ring buffer.
+ *
+ * Items have the same shape as the ones of @ref ring_buf_item_put (an array
+ * of 32-bit words coupled with a 16-bit type identifier and an 8-bit
+ * integer value), but each one is stored in a fixed size slot guarded by its
+ * own sequence counter. Writers and readers only contend on a single
+ * compare-and-swap of their own index, so any number of threads may put and
+ * get items concurrently without a lock.
+ */
+struct ring_buf_mpmc {
+    /** @cond INTERNAL_HIDDEN */
+    uint32_t *buffer;
+    uint32_t mask;
+    uint32_t slot_size32;
+    uint8_t max_size32;
+    RING_BUF_CACHE_LINE_PAD(pad0)
+    uint32_t enqueue_pos;
+    RING_BUF_MPMC_INDEX_PAD(pad1)
+    uint32_t dequeue_pos;
+    RING_BUF_MPMC_INDEX_PAD(pad2)
+    /** @endcond */
+};
+
+/**
+ * @brief Initialize a MPMC item ring buffer.
+ *
+ * This routine initializes a ring buffer, prior to its first use.
+ *
+ * @param rb Address of ring buffer.
+ * @param slots Number of items the ring buffer can hold (must be a power
+ *              of two).
+ * @param max_size32 Largest data item size (number of 32-bit words).
+ * @param data Ring buffer data area
+ *             (uint32_t data[RING_BUF_MPMC_BUFFER_SIZE32(slots, max_size32)]).
+ */
+void ring_buf_mpmc_item_init(struct ring_buf_mpmc *rb, uint32_t slots,
+                             uint8_t max_size32, uint32_t *data);
+
+/**
+ * @brief Determine if a MPMC item ring buffer is empty.
+ *
+ * @note The result is only a snapshot when other threads are using the
+ *       ring buffer concurrently.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return true if the ring buffer is empty, or false if not.
+ */
+bool ring_buf_mpmc_is_empty(struct ring_buf_mpmc *rb);
+
+/**
+ * @brief Return MPMC item ring buffer capacity.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return Ring buffer capacity (in items).
+ */
+uint32_t ring_buf_mpmc_capacity_get(struct ring_buf_mpmc *rb);
+
+/**
+ * @brief Write a data item to a MPMC item ring buffer.
+ *
+ * This routine may be called concurrently from any number of threads.
+ *
+ * @param rb Address of ring buffer.
+ * @param type Data item's type identifier (application specific).
+ * @param value Data item's integer value (application specific).
+ * @param data Address of data item.
+ * @param size32 Data item size (number of 32-bit words).
+ *
+ * @retval 0 Data item was written.
+ * @retval -1 Data item is larger than the slot size of the ring buffer.
+ * @retval -2 Ring buffer is full.
+ */
+int32_t ring_buf_mpmc_item_put(struct ring_buf_mpmc *rb, uint16_t type,
+                               uint8_t value, const uint32_t *data,
+                               uint8_t size32);
+
+/**
+ * @brief Read a data item from a MPMC item ring buffer.
+ *
+ * This routine may be called concurrently from any number of threads.
+ *
+ * @param rb Address of ring buffer.
+ * @param type Area to store the data item's type identifier.
+ * @param value Area to store the data item's integer value.
+ * @param data Area to store the data item. Can be NULL to discard data.
+ * @param size32 Size of the data item storage area (number of 32-bit chunks).
+ *
+ * @retval 0 Data item was fetched; @a size32 now contains the number of
+ *         32-bit words read into data area @a data.
+ * @retval -1 Ring buffer is empty.
+ * @retval -2 Data area @a data is too small; @a size32 now contains
+ *         the number of 32-bit words needed. The item is left in the
+ *         ring buffer.
+ */
+int32_t ring_buf_mpmc_item_get(struct ring_buf_mpmc *rb, uint16_t *type,
+                               uint8_t *value, uint32_t *data,
+                               uint8_t *size32);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_BUFFER_MPMC_H */
@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include "ring_buffer_persist.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__linux__)
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define RING_BUF_PERSIST_MAGIC   0x46504252u /* "RBPF" */
+#define RING_BUF_PERSIST_VERSION 1u
+
+/*
+ * The file holds this header, padded to a page, followed by the storage.
+ * Each side packs its committed tail and base indices in a single 64-bit
+ * word, stored atomically, so a restart never finds one without the other.
+ *
+ * Pages of a shared mapping may be written back in any order, so unless
+ * flushing is left to the operating system, the producer indices are only
+ * stored once the data they cover was flushed. The consumer indices may
+ * then be ahead of them.
+ */
+struct ring_buf_persist_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    uint32_t header_size;
+    uint64_t put;
+    uint64_t get;
+};
+
+
+static uint32_t page_size_get(void);
+static int64_t now_ms(void);
+static uint64_t indices_pack(uint32_t tail, uint32_t base);
+static bool indices_restore(struct ring_buf *rb, uint64_t put, uint64_t get);
+static bool header_is_blank(const struct ring_buf_persist_header *header);
+static int32_t ring_buf_persist_put_commit(struct ring_buf_persist *prb, uint32_t size);
+static void ring_buf_persist_get_commit(struct ring_buf_persist *prb);
+
+
+int32_t ring_buf_persist_open(struct ring_buf_persist *prb, const char *path, uint32_t size,
+                              uint32_t policy, uint32_t threshold)
+{
+    uint32_t page_size = page_size_get();
+
+    if (path == NULL || size == 0 || size >= RING_BUFFER_MAX_SIZE ||
+        policy > RING_BUF_PERSIST_SYNC_TIME || page_size == 0) {
+        return -1;
+    }
+
+    size_t map_size = (size_t) page_size + size;
+    struct stat st;
+
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return -2;
+    }
+
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -2;
+    }
+
+    bool created = (st.st_size == 0);
+
+    if (created) {
+        if (ftruncate(fd, (off_t) map_size) != 0) {
+            close(fd);
+            return -2;
+        }
+    } else if ((size_t) st.st_size != map_size) {
+        close(fd);
+        return -1;
+    }
+
+    uint8_t *map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    /* the mapping keeps the file open */
+    close(fd);
+
+    if (map == MAP_FAILED) {
+        return -2;
+    }
+
+    struct ring_buf_persist_header *header = (struct ring_buf_persist_header *) map;
+
+    ring_buf_init(&prb->rb, size, map + page_size);
+
+    if (!created && header_is_blank(header)) {
+        /* the file was sized, but the first header flush never completed */
+        created = true;
+    }
+
+    if (created) {
+        header->magic = RING_BUF_PERSIST_MAGIC;
+        header->version = RING_BUF_PERSIST_VERSION;
+        header->size = size;
+        header->header_size = page_size;
+        header->put = indices_pack(0, 0);
+        header->get = indices_pack(0, 0);
+    } else if (header->magic != RING_BUF_PERSIST_MAGIC ||
+               header->version != RING_BUF_PERSIST_VERSION ||
+               header->size != size || header->header_size != page_size ||
+               !indices_restore(&prb->rb, header->put, header->get)) {
+        munmap(map, map_size);
+        return -1;
+    }
+
+    prb->header = header;
+    prb->map = map;
+    prb->map_size = map_size;
+    prb->policy = policy;
+    prb->threshold = threshold;
+    prb->unsynced = 0;
+    prb->last_sync_ms = now_ms();
+
+    if (created && ring_buf_persist_sync(prb) != 0) {
+        ring_buf_persist_close(prb);
+        return -2;
+    }
+
+    return 0;
+}
+
+void ring_buf_persist_close(struct ring_buf_persist *prb)
+{
+    if (prb->map != NULL) {
+        (void) ring_buf_persist_sync(prb);
+        munmap(prb->map, prb->map_size);
+    }
+
+    prb->header = NULL;
+    prb->map = NULL;
+    prb->rb.buffer = NULL;
+}
+
+int32_t ring_buf_persist_sync(struct ring_buf_persist *prb)
+{
+    struct ring_buf_persist_header *header = prb->header;
+    uint64_t put = indices_pack(prb->rb.put_tail, prb->rb.put_base);
+
+    /* data first, then the indices referring to it */
+    if (msync(prb->rb.buffer, prb->rb.size, MS_SYNC) != 0) {
+        return -2;
+    }
+
+    __atomic_store_n(&header->put, put, __ATOMIC_RELEASE);
+
+    prb->unsynced = 0;
+    prb->last_sync_ms = now_ms();
+
+    return (msync(prb->map, header->header_size, MS_SYNC) == 0) ? 0 : -2;
+}
+
+uint32_t ring_buf_persist_unsynced_get(struct ring_buf_persist *prb)
+{
+    return prb->unsynced;
+}
+
+int32_t ring_buf_persist_put_finish(struct ring_buf_persist *prb, uint32_t size)
+{
+    if (ring_buf_put_finish(&prb->rb, size) != 0) {
+        return -1;
+    }
+
+    return ring_buf_persist_put_commit(prb, size);
+}
+
+uint32_t ring_buf_persist_put(struct ring_buf_persist *prb, const uint8_t *data, uint32_t size)
+{
+    uint32_t written = ring_buf_put(&prb->rb, data, size);
+
+    (void) ring_buf_persist_put_commit(prb, written);
+
+    return written;
+}
+
+int32_t ring_buf_persist_get_finish(struct ring_buf_persist *prb, uint32_t size)
+{
+    if (ring_buf_get_finish(&prb->rb, size) != 0) {
+        return -1;
+    }
+
+    ring_buf_persist_get_commit(prb);
+
+    return 0;
+}
+
+uint32_t ring_buf_persist_get(struct ring_buf_persist *prb, uint8_t *data, uint32_t size)
+{
+    uint32_t read = ring_buf_get(&prb->rb, data, size);
+
+    ring_buf_persist_get_commit(prb);
+
+    return read;
+}
+
+static uint32_t page_size_get(void)
+{
+    long page_size = sysconf(_SC_PAGESIZE);
+
+    return (page_size > 0) ? (uint32_t) page_size : 0;
+}
+
+static int64_t now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (int64_t) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint64_t indices_pack(uint32_t tail, uint32_t base)
+{
+    return ((uint64_t) base << 32) | tail;
+}
+
+static bool header_is_blank(const struct ring_buf_persist_header *header)
+{
+    static const struct ring_buf_persist_header blank;
+
+    return memcmp(header, &blank, sizeof(blank)) == 0;
+}
+
+/*
+ * Rebuild the state struct ring_buf had when both indices were committed,
+ * after checking they describe a possible state: the data offsets of both
+ * sides must lie within the storage and be as far apart as the fill level.
+ */
+static bool indices_restore(struct ring_buf *rb, uint64_t put, uint64_t get)
+{
+    uint32_t put_tail = (uint32_t) put;
+    uint32_t put_base = (uint32_t) (put >> 32);
+    uint32_t get_tail = (uint32_t) get;
+    uint32_t get_base = (uint32_t) (get >> 32);
+    uint32_t used = put_tail - get_tail;
+
+    if (get_tail - put_tail <= rb->size) {
+        /* data read after the last flush: resume empty where reading stopped */
+        put_tail = get_tail;
+        put_base = get_base;
+        used = 0;
+    }
+
+    uint32_t put_offset = put_tail - put_base;
+    uint32_t get_offset = get_tail - get_base;
+
+    if (used > rb->size || put_offset >= rb->size || get_offset >= rb->size ||
+        (put_offset + rb->size - get_offset) % rb->size != used % rb->size) {
+        return false;
+    }
+
+    rb->put_head = put_tail;
+    rb->put_tail = put_tail;
+    rb->put_base = put_base;
+    rb->get_tail_cache = get_tail;
+    rb->get_head = get_tail;
+    rb->get_tail = get_tail;
+    rb->get_base = get_base;
+    rb->put_tail_cache = put_tail;
+
+    return true;
+}
+
+static int32_t ring_buf_persist_put_commit(struct ring_buf_persist *prb, uint32_t size)
+{
+    struct ring_buf_persist_header *header = prb->header;
+    bool sync;
+
+    if (size == 0) {
+        return 0;
+    }
+
+    prb->unsynced += size;
+
+    switch (prb->policy) {
+    case RING_BUF_PERSIST_SYNC_COMMIT:
+        sync = true;
+        break;
+    case RING_BUF_PERSIST_SYNC_BYTES:
+        sync = prb->unsynced >= prb->threshold;
+        break;
+    case RING_BUF_PERSIST_SYNC_TIME:
+        sync = now_ms() - prb->last_sync_ms >= (int64_t) prb->threshold;
+        break;
+    default:
+        /* a system crash may lose anything, only a restart has to be survived */
+        __atomic_store_n(&header->put, indices_pack(prb->rb.put_tail, prb->rb.put_base),
+                         __ATOMIC_RELEASE);
+        sync = false;
+        break;
+    }
+
+    return sync ? ring_buf_persist_sync(prb) : 0;
+}
+
+static void ring_buf_persist_get_commit(struct ring_buf_persist *prb)
+{
+    struct ring_buf_persist_header *header = prb->header;
+
+    __atomic_store_n(&header->get, indices_pack(prb->rb.get_tail, prb->rb.get_base),
+                     __ATOMIC_RELEASE);
+}
+
+#else /* !__linux__ */
+
+int32_t ring_buf_persist_open(struct ring_buf_persist *prb, const char *path, uint32_t size,
+                              uint32_t policy, uint32_t threshold)
+{
+    (void) prb;
+    (void) path;
+    (void) size;
+    (void) policy;
+    (void) threshold;
+
+    return -2;
+}
+
+void ring_buf_persist_close(struct ring_buf_persist *prb)
+{
+    prb->header = NULL;
+    prb->map = NULL;
+    prb->rb.buffer = NULL;
+}
+
+int32_t ring_buf_persist_sync(struct ring_buf_persist *prb)
+{
+    (void) prb;
+
+    return -2;
+}
+
+uint32_t ring_buf_persist_unsynced_get(struct ring_buf_persist *prb)
+{
+    (void) prb;
+
+    return 0;
+}
+
+int32_t ring_buf_persist_put_finish(struct ring_buf_persist *prb, uint32_t size)
+{
+    return ring_buf_put_finish(&prb->rb, size);
+}
+
+uint32_t ring_buf_persist_put(struct ring_buf_persist *prb, const uint8_t *data, uint32_t size)
+{
+    return ring_buf_put(&prb->rb, data, size);
+}
+
+int32_t ring_buf_persist_get_finish(struct ring_buf_persist *prb, uint32_t size)
+{
+    return ring_buf_get_finish(&prb->rb, size);
+}
+
+uint32_t ring_buf_persist_get(struct ring_buf_persist *prb, uint8_t *data, uint32_t size)
+{
+    return ring_buf_get(&prb->rb, data, size);
+}
+
+#endif /* __linux__ */
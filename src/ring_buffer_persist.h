@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef RING_BUFFER_PERSIST_H
+#define RING_BUFFER_PERSIST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Leave flushing to the operating system's writeback.
+ *
+ * Commits are recorded in the file as they happen: committed data survives
+ * a process restart, but not necessarily a system crash.
+ */
+#define RING_BUF_PERSIST_SYNC_NONE   0u
+
+/** @brief Flush to the file on every producer commit. */
+#define RING_BUF_PERSIST_SYNC_COMMIT 1u
+
+/** @brief Flush once at least @a threshold bytes were committed since the last flush. */
+#define RING_BUF_PERSIST_SYNC_BYTES  2u
+
+/**
+ * @brief Flush on a producer commit once at least @a threshold milliseconds
+ *        passed since the last flush.
+ */
+#define RING_BUF_PERSIST_SYNC_TIME   3u
+
+/**
+ * @brief A structure to represent a ring buffer backed by a file.
+ *
+ * The storage of @a rb and a header holding the committed indices are mapped
+ * from a file, so data committed by the producer is recovered when the file
+ * is opened again, e.g. after the process restarted.
+ *
+ * Claims and reads go through the regular ring_buf_ API on @a rb, but
+ * commits must go through ring_buf_persist_put_finish(),
+ * ring_buf_persist_put(), ring_buf_persist_get_finish() or
+ * ring_buf_persist_get() to be recorded in the file.
+ *
+ * Except with RING_BUF_PERSIST_SYNC_NONE, producer commits are only recorded
+ * by flushes, once the data they cover reached the file: data committed
+ * since the last flush is lost by a process restart as well as by a system
+ * crash. Only the producer commits trigger flushes: data read but not
+ * flushed yet may be read again after a system crash.
+ *
+ * One producer and one consumer may use it concurrently, as
+ * struct ring_buf.
+ */
+struct ring_buf_persist {
+    /** Ring buffer over the mapped storage. */
+    struct ring_buf rb;
+    /** @cond INTERNAL_HIDDEN */
+    void *header;
+    uint8_t *map;
+    size_t map_size;
+    uint32_t policy;
+    uint32_t threshold;
+    /* producer state */
+    uint32_t unsynced;
+    int64_t last_sync_ms;
+    /** @endcond */
+};
+
+/**
+ * @brief Open or create a file-backed ring buffer.
+ *
+ * A missing or empty file is created and initialized to an empty ring
+ * buffer of @a size bytes, and so is a file of the right size whose header
+ * is still blank (creation was interrupted before the header was flushed).
+ * Otherwise, the file must hold a ring buffer of the same size, whose
+ * committed data is recovered.
+ *
+ * @note Only available on Linux (mmap).
+ *
+ * @param prb Address of file-backed ring buffer.
+ * @param path Path of the file.
+ * @param size Ring buffer size (in bytes).
+ * @param policy One of the RING_BUF_PERSIST_SYNC_ policies.
+ * @param threshold Bytes (RING_BUF_PERSIST_SYNC_BYTES) or milliseconds
+ *                  (RING_BUF_PERSIST_SYNC_TIME) between flushes, unused
+ *                  otherwise.
+ *
+ * @retval 0 Ring buffer was opened.
+ * @retval -1 Invalid argument, or the file does not hold a ring buffer of
+ *            @a size bytes.
+ * @retval -2 The file could not be opened or mapped, or files are not
+ *            supported.
+ */
+int32_t ring_buf_persist_open(struct ring_buf_persist *prb, const char *path, uint32_t size,
+                              uint32_t policy, uint32_t threshold);
+
+/**
+ * @brief Flush and close a file-backed ring buffer.
+ *
+ * @param prb Address of file-backed ring buffer.
+ */
+void ring_buf_persist_close(struct ring_buf_persist *prb);
+
+/**
+ * @brief Flush committed data and indices to the file.
+ *
+ * Data is flushed before the producer indices are recorded, so indices found
+ * in the file never refer to data that did not reach it. Must be called by
+ * the producer.
+ *
+ * @param prb Address of file-backed ring buffer.
+ *
+ * @retval 0 Successful operation.
+ * @retval -2 Flushing failed. If the data could not be flushed, the commits
+ *         since the last flush are not recorded.
+ */
+int32_t ring_buf_persist_sync(struct ring_buf_persist *prb);
+
+/**
+ * @brief Determine the number of committed bytes not flushed yet.
+ *
+ * @param prb Address of file-backed ring buffer.
+ *
+ * @return Bytes committed by the producer since the last flush.
+ */
+uint32_t ring_buf_persist_unsynced_get(struct ring_buf_persist *prb);
+
+/**
+ * @brief Commit bytes written to buffers claimed with @ref ring_buf_put_claim.
+ *
+ * Same as @ref ring_buf_put_finish, and records the commit in the file
+ * according to the flush policy.
+ *
+ * @param prb Address of file-backed ring buffer.
+ * @param size Number of valid bytes in the allocated buffers.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 Provided @a size exceeds free space in the ring buffer.
+ * @retval -2 Data was committed, but flushing failed.
+ */
+int32_t ring_buf_persist_put_finish(struct ring_buf_persist *prb, uint32_t size);
+
+/**
+ * @brief Write (copy) data to a file-backed ring buffer and commit it.
+ *
+ * @param prb Address of file-backed ring buffer.
+ * @param data Address of data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written.
+ */
+uint32_t ring_buf_persist_put(struct ring_buf_persist *prb, const uint8_t *data, uint32_t size);
+
+/**
+ * @brief Free bytes read from buffers claimed with @ref ring_buf_get_claim.
+ *
+ * Same as @ref ring_buf_get_finish, and records the new read position in
+ * the file.
+ *
+ * @param prb Address of file-backed ring buffer.
+ * @param size Number of bytes that can be freed.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 Provided @a size exceeds valid bytes in the ring buffer.
+ */
+int32_t ring_buf_persist_get_finish(struct ring_buf_persist *prb, uint32_t size);
+
+/**
+ * @brief Read data from a file-backed ring buffer.
+ *
+ * @param prb Address of file-backed ring buffer.
+ * @param data Address of the output buffer. Can be NULL to discard data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes read.
+ */
+uint32_t ring_buf_persist_get(struct ring_buf_persist *prb, uint8_t *data, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_BUFFER_PERSIST_H */
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef RING_BUFFER_POW2_H
+#define RING_BUFFER_POW2_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Statically define and initialize a power-of-two sized byte ring
+ *        buffer.
+ *
+ * The capacity is a compile-time constant, so offsets are computed with a
+ * mask and the functions generated for the ring buffer are small enough to
+ * be inlined on the hot path. The following functions are defined, with the
+ * same semantics (including the single producer/single consumer guarantees)
+ * as their ring_buf_ counterparts:
+ *
+ * - name_is_empty(), name_size_get(), name_space_get(), name_reset()
+ * - name_put_claim(), name_put_finish(), name_put()
+ * - name_get_claim(), name_get_finish(), name_get(), name_peek()
+ *
+ * Must be used at file scope, followed by a semicolon.
+ *
+ * @param name Name of the ring buffer (prefix of the generated functions).
+ * @param size8 Ring buffer size in bytes (a power of two, at most 2^31).
+ */
+#define RING_BUF_DECLARE_POW2(name, size8)                                        \
+    _Static_assert((size8) != 0 && ((size8) & ((size8) - 1)) == 0 &&              \
+                   (size8) <= RING_BUFFER_MAX_SIZE,                               \
+                   "Ring buffer size must be a power of two");                    \
+    static uint8_t name##_buffer[size8];                                          \
+    static struct ring_buf_pow2 name;                                             \
+    static inline bool name##_is_empty(void)                                      \
+    {                                                                             \
+        return ring_buf_pow2_size_get(&name) == 0;                                \
+    }                                                                             \
+    static inline uint32_t name##_size_get(void)                                  \
+    {                                                                             \
+        return ring_buf_pow2_size_get(&name);                                     \
+    }                                                                             \
+    static inline uint32_t name##_space_get(void)                                 \
+    {                                                                             \
+        return ring_buf_pow2_space_get(&name, (size8));                           \
+    }                                                                             \
+    static inline void name##_reset(void)                                         \
+    {                                                                             \
+        ring_buf_pow2_reset(&name);                                               \
+    }                                                                             \
+    static inline uint32_t name##_put_claim(uint8_t **data, uint32_t size)       \
+    {                                                                             \
+        return ring_buf_pow2_put_claim(&name, name##_buffer, (size8), data, size); \
+    }                                                                             \
+    static inline int32_t name##_put_finish(uint32_t size)                       \
+    {                                                                             \
+        return ring_buf_pow2_put_finish(&name, size);                             \
+    }                                                                             \
+    static inline uint32_t name##_put(const uint8_t *data, uint32_t size)        \
+    {                                                                             \
+        return ring_buf_pow2_put(&name, name##_buffer, (size8), data, size);      \
+    }                                                                             \
+    static inline uint32_t name##_get_claim(uint8_t **data, uint32_t size)       \
+    {                                                                             \
+        return ring_buf_pow2_get_claim(&name, name##_buffer, (size8), data, size); \
+    }                                                                             \
+    static inline int32_t name##_get_finish(uint32_t size)                       \
+    {                                                                             \
+        return ring_buf_pow2_get_finish(&name, size);                             \
+    }                                                                             \
+    static inline uint32_t name##_get(uint8_t *data, uint32_t size)              \
+    {                                                                             \
+        return ring_buf_pow2_get(&name, name##_buffer, (size8), data, size);      \
+    }                                                                             \
+    static inline uint32_t name##_peek(uint8_t *data, uint32_t size)             \
+    {                                                                             \
+        return ring_buf_pow2_peek(&name, name##_buffer, (size8), data, size);     \
+    }                                                                             \
+    static struct ring_buf_pow2 name
+
+/** @cond INTERNAL_HIDDEN */
+
+/*
+ * Indices run freely over the whole uint32_t range: since the capacity
+ * divides 2^32, the storage offset of any index is its low bits and no base
+ * adjustment is needed when wrapping.
+ */
+struct ring_buf_pow2 {
+    uint32_t put_head;
+    uint32_t put_tail;
+    uint32_t get_head;
+    uint32_t get_tail;
+};
+
+static inline uint32_t ring_buf_pow2_min(uint32_t a, uint32_t b)
+{
+    return (a < b) ? a : b;
+}
+
+/*
+ * Copy sizes are bounded by the compile-time capacity, which makes GCC expand
+ * memcpy inline as "rep movs", slow to start up for short copies. Hiding the
+ * bound keeps the call to the library memcpy, as used by struct ring_buf.
+ */
+static inline void ring_buf_pow2_copy(void *dst, const void *src, uint32_t size)
+{
+#if defined(__GNUC__)
+    __asm__("" : "+r"(size));
+#endif
+    memcpy(dst, src, size);
+}
+
+static inline uint32_t ring_buf_pow2_size_get(struct ring_buf_pow2 *rb)
+{
+    return __atomic_load_n(&rb->put_tail, __ATOMIC_ACQUIRE) - rb->get_head;
+}
+
+static inline uint32_t ring_buf_pow2_space_get(struct ring_buf_pow2 *rb,
+                                               uint32_t capacity)
+{
+    return capacity - (rb->put_head - __atomic_load_n(&rb->get_tail, __ATOMIC_ACQUIRE));
+}
+
+static inline void ring_buf_pow2_reset(struct ring_buf_pow2 *rb)
+{
+    rb->put_head = 0;
+    rb->put_tail = 0;
+    rb->get_head = 0;
+    rb->get_tail = 0;
+}
+
+static inline uint32_t ring_buf_pow2_put_claim(struct ring_buf_pow2 *rb,
+                                               uint8_t *buffer, uint32_t capacity,
+                                               uint8_t **data, uint32_t size)
+{
+    uint32_t offset = rb->put_head & (capacity - 1);
+
+    size = ring_buf_pow2_min(size, ring_buf_pow2_space_get(rb, capacity));
+    size = ring_buf_pow2_min(size, capacity - offset);
+
+    *data = &buffer[offset];
+    rb->put_head += size;
+
+    return size;
+}
+
+static inline int32_t ring_buf_pow2_put_finish(struct ring_buf_pow2 *rb,
+                                               uint32_t size)
+{
+    if (size > rb->put_head - rb->put_tail) {
+        return -1;
+    }
+
+    uint32_t put_tail = rb->put_tail + size;
+
+    rb->put_head = put_tail;
+    __atomic_store_n(&rb->put_tail, put_tail, __ATOMIC_RELEASE);
+
+    return 0;
+}
+
+static inline uint32_t ring_buf_pow2_put(struct ring_buf_pow2 *rb,
+                                         uint8_t *buffer, uint32_t capacity,
+                                         const uint8_t *data, uint32_t size)
+{
+    uint32_t offset = rb->put_head & (capacity - 1);
+
+    size = ring_buf_pow2_min(size, ring_buf_pow2_space_get(rb, capacity));
+
+    uint32_t first = ring_buf_pow2_min(size, capacity - offset);
+
+    ring_buf_pow2_copy(&buffer[offset], data, first);
+    if (size > first) {
+        /* the rest continues at the beginning of the storage */
+        ring_buf_pow2_copy(buffer, data + first, size - first);
+    }
+
+    rb->put_head += size;
+    ring_buf_pow2_put_finish(rb, size);
+
+    return size;
+}
+
+static inline uint32_t ring_buf_pow2_get_claim(struct ring_buf_pow2 *rb,
+                                               uint8_t *buffer, uint32_t capacity,
+                                               uint8_t **data, uint32_t size)
+{
+    uint32_t offset = rb->get_head & (capacity - 1);
+
+    size = ring_buf_pow2_min(size, ring_buf_pow2_size_get(rb));
+    size = ring_buf_pow2_min(size, capacity - offset);
+
+    *data = &buffer[offset];
+    rb->get_head += size;
+
+    return size;
+}
+
+static inline int32_t ring_buf_pow2_get_finish(struct ring_buf_pow2 *rb,
+                                               uint32_t size)
+{
+    if (size > rb->get_head - rb->get_tail) {
+        return -1;
+    }
+
+    uint32_t get_tail = rb->get_tail + size;
+
+    rb->get_head = get_tail;
+    __atomic_store_n(&rb->get_tail, get_tail, __ATOMIC_RELEASE);
+
+    return 0;
+}
+
+static inline uint32_t ring_buf_pow2_read(struct ring_buf_pow2 *rb,
+                                          uint8_t *buffer, uint32_t capacity,
+                                          uint8_t *data, uint32_t size,
+                                          bool finish)
+{
+    uint32_t offset = rb->get_head & (capacity - 1);
+
+    size = ring_buf_pow2_min(size, ring_buf_pow2_size_get(rb));
+
+    if (data) {
+        uint32_t first = ring_buf_pow2_min(size, capacity - offset);
+
+        ring_buf_pow2_copy(data, &buffer[offset], first);
+        if (size > first) {
+            /* the rest continues at the beginning of the storage */
+            ring_buf_pow2_copy(data + first, buffer, size - first);
+        }
+    }
+
+    if (finish) {
+        rb->get_head += size;
+        ring_buf_pow2_get_finish(rb, size);
+    }
+
+    return size;
+}
+
+static inline uint32_t ring_buf_pow2_get(struct ring_buf_pow2 *rb,
+                                         uint8_t *buffer, uint32_t capacity,
+                                         uint8_t *data, uint32_t size)
+{
+    return ring_buf_pow2_read(rb, buffer, capacity, data, size, true);
+}
+
+static inline uint32_t ring_buf_pow2_peek(struct ring_buf_pow2 *rb,
+                                          uint8_t *buffer, uint32_t capacity,
+                                          uint8_t *data, uint32_t size)
+{
+    return ring_buf_pow2_read(rb, buffer, capacity, data, size, false);
+}
+
+/** @endcond */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_BUFFER_POW2_H */
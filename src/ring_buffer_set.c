@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ring_buffer_set.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Ready bits and summary bits are only changed with acquire/release
+ * read-modify-write operations. A producer sets the ready bit after
+ * publishing its data; the consumer clears it before checking the ring
+ * buffer again. Both operations hit the same word, so either the producer's
+ * bit survives the clear, or the consumer observes the data it covers.
+ *
+ * A summary bit may stay set for an all-clear word (it is cleared on the
+ * next scan), but is never left clear for a word holding ready bits.
+ */
+#define RING_BUF_SET_WORD(index) ((index) / 64u)
+#define RING_BUF_SET_BIT(index)  (UINT64_C(1) << ((index) % 64u))
+
+
+struct ring_buf_set_wait_arg {
+    struct ring_buf_set *set;
+    int32_t index;
+};
+
+static bool ring_buf_set_ready_set(struct ring_buf_set *set, uint32_t index);
+static void ring_buf_set_ready_clear(struct ring_buf_set *set, uint32_t index);
+static void ring_buf_set_summary_clear(struct ring_buf_set *set, uint32_t word);
+static bool ring_buf_set_has_data(void *arg);
+
+
+void ring_buf_set_init(struct ring_buf_set *set)
+{
+    for (uint32_t i = 0; i < RING_BUF_SET_MAX_RINGS; i++) {
+        set->rings[i] = NULL;
+    }
+
+    for (uint32_t i = 0; i < RING_BUF_SET_WORDS; i++) {
+        set->ready[i] = 0;
+    }
+
+    set->summary = 0;
+    ring_buf_waitq_init(&set->wq);
+}
+
+int32_t ring_buf_set_add(struct ring_buf_set *set, uint32_t index, struct ring_buf *rb)
+{
+    if (index >= RING_BUF_SET_MAX_RINGS || set->rings[index] != NULL) {
+        return -1;
+    }
+
+    set->rings[index] = rb;
+
+    /* data committed before the ring buffer joined is found by the next scan */
+    ring_buf_set_notify(set, index);
+
+    return 0;
+}
+
+void ring_buf_set_remove(struct ring_buf_set *set, uint32_t index)
+{
+    if (index >= RING_BUF_SET_MAX_RINGS) {
+        return;
+    }
+
+    ring_buf_set_ready_clear(set, index);
+    set->rings[index] = NULL;
+}
+
+void ring_buf_set_notify(struct ring_buf_set *set, uint32_t index)
+{
+    if (index >= RING_BUF_SET_MAX_RINGS) {
+        return;
+    }
+
+    if (ring_buf_set_ready_set(set, index)) {
+        ring_buf_wake(&set->wq);
+    }
+}
+
+int32_t ring_buf_set_next(struct ring_buf_set *set)
+{
+    for (;;) {
+        uint64_t summary = __atomic_load_n(&set->summary, __ATOMIC_ACQUIRE);
+
+        if (summary == 0) {
+            return -1;
+        }
+
+        uint32_t word = (uint32_t) __builtin_ctzll(summary);
+        uint64_t ready = __atomic_load_n(&set->ready[word], __ATOMIC_ACQUIRE);
+
+        if (ready == 0) {
+            ring_buf_set_summary_clear(set, word);
+            continue;
+        }
+
+        uint32_t index = word * 64u + (uint32_t) __builtin_ctzll(ready);
+        struct ring_buf *rb = set->rings[index];
+
+        if (rb != NULL && !ring_buf_is_empty(rb)) {
+            return (int32_t) index;
+        }
+
+        ring_buf_set_ready_clear(set, index);
+
+        /* data committed while the bit was cleared */
+        if (rb != NULL && !ring_buf_is_empty(rb)) {
+            (void) ring_buf_set_ready_set(set, index);
+
+            return (int32_t) index;
+        }
+    }
+}
+
+int32_t ring_buf_set_wait(struct ring_buf_set *set, int32_t timeout_ms)
+{
+    struct ring_buf_set_wait_arg arg = { .set = set, .index = -1 };
+
+    int32_t result = ring_buf_waitq_wait(&set->wq, ring_buf_set_has_data, &arg, timeout_ms);
+
+    return (result == 0) ? arg.index : result;
+}
+
+/* Set the ready bit of a slot, returns true if it was clear. */
+static bool ring_buf_set_ready_set(struct ring_buf_set *set, uint32_t index)
+{
+    uint32_t word = RING_BUF_SET_WORD(index);
+    uint64_t bit = RING_BUF_SET_BIT(index);
+    uint64_t old = __atomic_fetch_or(&set->ready[word], bit, __ATOMIC_ACQ_REL);
+
+    if (old & bit) {
+        return false;
+    }
+
+    if (old == 0) {
+        __atomic_fetch_or(&set->summary, UINT64_C(1) << word, __ATOMIC_ACQ_REL);
+    }
+
+    return true;
+}
+
+static void ring_buf_set_ready_clear(struct ring_buf_set *set, uint32_t index)
+{
+    uint32_t word = RING_BUF_SET_WORD(index);
+    uint64_t bit = RING_BUF_SET_BIT(index);
+    uint64_t old = __atomic_fetch_and(&set->ready[word], ~bit, __ATOMIC_ACQ_REL);
+
+    if ((old & ~bit) == 0) {
+        ring_buf_set_summary_clear(set, word);
+    }
+}
+
+static void ring_buf_set_summary_clear(struct ring_buf_set *set, uint32_t word)
+{
+    uint64_t bit = UINT64_C(1) << word;
+
+    __atomic_fetch_and(&set->summary, ~bit, __ATOMIC_ACQ_REL);
+
+    /* a producer set a ready bit of the word in the meantime */
+    if (__atomic_load_n(&set->ready[word], __ATOMIC_ACQUIRE) != 0) {
+        __atomic_fetch_or(&set->summary, bit, __ATOMIC_ACQ_REL);
+    }
+}
+
+static bool ring_buf_set_has_data(void *arg)
+{
+    struct ring_buf_set_wait_arg *wait_arg = arg;
+
+    wait_arg->index = ring_buf_set_next(wait_arg->set);
+
+    return wait_arg->index >= 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef RING_BUFFER_SET_H
+#define RING_BUFFER_SET_H
+
+#include <stdint.h>
+
+#include "ring_buffer.h"
+#include "ring_buffer_wait.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @cond INTERNAL_HIDDEN */
+/* Number of slots of a ring set: a multiple of 64, up to 4096. */
+#ifndef RING_BUF_SET_MAX_RINGS
+#define RING_BUF_SET_MAX_RINGS 256u
+#endif
+
+#define RING_BUF_SET_WORDS (RING_BUF_SET_MAX_RINGS / 64u)
+
+#if (RING_BUF_SET_MAX_RINGS % 64u) != 0 || RING_BUF_SET_MAX_RINGS == 0 || \
+    RING_BUF_SET_MAX_RINGS > 4096u
+#error "RING_BUF_SET_MAX_RINGS must be a multiple of 64, up to 4096"
+#endif
+/** @endcond */
+
+/**
+ * @brief A structure to represent a set of ring buffers drained by one
+ *        consumer.
+ *
+ * Each ring buffer of the set has a readiness bit, set by its producer with
+ * @ref ring_buf_set_notify after committing data. Ready bits are grouped in
+ * 64-bit words, themselves flagged in a summary word, so the consumer finds
+ * the next ring buffer holding data with two bit scans, whatever the number
+ * of idle ring buffers.
+ *
+ * Ring buffers are served by strict priority: the lowest slot index holding
+ * data comes first.
+ *
+ * Any number of producers (one per ring buffer) may notify concurrently, but
+ * a single consumer thread must call @ref ring_buf_set_next and
+ * @ref ring_buf_set_wait.
+ */
+struct ring_buf_set {
+    /** @cond INTERNAL_HIDDEN */
+    struct ring_buf *rings[RING_BUF_SET_MAX_RINGS];
+    uint64_t summary;
+    uint64_t ready[RING_BUF_SET_WORDS];
+    struct ring_buf_waitq wq;
+    /** @endcond */
+};
+
+/**
+ * @brief Initialize an empty ring set.
+ *
+ * @param set Address of ring set.
+ */
+void ring_buf_set_init(struct ring_buf_set *set);
+
+/**
+ * @brief Add a ring buffer to a ring set.
+ *
+ * The ring buffer is flagged ready at once if it already holds data.
+ *
+ * @warning
+ * Must not run concurrently with @ref ring_buf_set_next or
+ * @ref ring_buf_set_wait.
+ *
+ * @param set Address of ring set.
+ * @param index Slot of the ring buffer, which is also its priority (0 is
+ *              served first).
+ * @param rb Address of ring buffer.
+ *
+ * @retval 0 Ring buffer was added.
+ * @retval -1 @a index is out of range or already in use.
+ */
+int32_t ring_buf_set_add(struct ring_buf_set *set, uint32_t index, struct ring_buf *rb);
+
+/**
+ * @brief Remove a ring buffer from a ring set.
+ *
+ * @warning
+ * Must not run concurrently with any other call on the same slot, nor with
+ * @ref ring_buf_set_next or @ref ring_buf_set_wait.
+ *
+ * @param set Address of ring set.
+ * @param index Slot of the ring buffer.
+ */
+void ring_buf_set_remove(struct ring_buf_set *set, uint32_t index);
+
+/**
+ * @brief Flag a ring buffer of a ring set as holding data.
+ *
+ * Called by the producer of the ring buffer after committing data with
+ * @ref ring_buf_put_finish, @ref ring_buf_put or @ref ring_buf_item_put.
+ * Wakes the consumer when it waits in @ref ring_buf_set_wait. Costs one
+ * atomic operation when the ring buffer was already flagged.
+ *
+ * @param set Address of ring set.
+ * @param index Slot of the ring buffer.
+ */
+void ring_buf_set_notify(struct ring_buf_set *set, uint32_t index);
+
+/**
+ * @brief Find the ring buffer holding data with the highest priority.
+ *
+ * Flags of ring buffers found empty are cleared on the way. The flag of the
+ * returned ring buffer is kept: it is returned again until drained.
+ *
+ * @param set Address of ring set.
+ *
+ * @return Slot of the ring buffer, or -1 if no ring buffer holds data.
+ */
+int32_t ring_buf_set_next(struct ring_buf_set *set);
+
+/**
+ * @brief Wait until a ring buffer of a ring set holds data.
+ *
+ * @param set Address of ring set.
+ * @param timeout_ms Maximum waiting time in milliseconds, 0 to only check
+ *                   or RING_BUF_WAIT_FOREVER.
+ *
+ * @return Slot of the ring buffer holding data with the highest priority,
+ *         -1 if the timeout expired, or -2 if blocking is not supported on
+ *         this platform.
+ */
+int32_t ring_buf_set_wait(struct ring_buf_set *set, int32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_BUFFER_SET_H */
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef RING_BUFFER_TYPED_H
+#define RING_BUFFER_TYPED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ring_buffer.h"
+#include "ring_buffer_pow2.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Statically define and initialize a ring buffer of elements of a
+ *        given type.
+ *
+ * Elements are stored as an array of @a type, without any header, and are
+ * copied with structure assignment. The capacity is a compile-time constant,
+ * so small elements are moved with a few register operations. The following
+ * functions are defined, with the same single producer/single consumer
+ * guarantees as struct ring_buf:
+ *
+ * - name_is_empty(), name_size_get(), name_space_get(), name_reset()
+ *   (sizes are counted in elements)
+ * - int32_t name_push(type item): 0, or -2 if the ring buffer is full.
+ * - uint32_t name_push_n(const type *items, uint32_t count): number of
+ *   elements written.
+ * - type *name_front(void): oldest element, left in the ring buffer, or
+ *   NULL if the ring buffer is empty.
+ * - int32_t name_pop(type *item): 0, or -1 if the ring buffer is empty;
+ *   @a item can be NULL to discard the element.
+ * - uint32_t name_pop_n(type *items, uint32_t count): number of elements
+ *   read; @a items can be NULL to discard them.
+ *
+ * Must be used at file scope, followed by a semicolon.
+ *
+ * @param name Name of the ring buffer (prefix of the generated functions).
+ * @param type Element type.
+ * @param capacity Number of elements (a power of two, at most 2^31).
+ */
+#define RING_BUF_DEFINE_TYPED(name, type, capacity)                               \
+    _Static_assert((capacity) != 0 && ((capacity) & ((capacity) - 1)) == 0 &&     \
+                   (capacity) <= RING_BUFFER_MAX_SIZE,                            \
+                   "Ring buffer capacity must be a power of two");                \
+    static type name##_buffer[capacity];                                          \
+    static struct ring_buf_pow2 name;                                             \
+    static inline bool name##_is_empty(void)                                      \
+    {                                                                             \
+        return ring_buf_pow2_size_get(&name) == 0;                                \
+    }                                                                             \
+    static inline uint32_t name##_size_get(void)                                  \
+    {                                                                             \
+        return ring_buf_pow2_size_get(&name);                                     \
+    }                                                                             \
+    static inline uint32_t name##_space_get(void)                                 \
+    {                                                                             \
+        return ring_buf_pow2_space_get(&name, (capacity));                        \
+    }                                                                             \
+    static inline void name##_reset(void)                                         \
+    {                                                                             \
+        ring_buf_pow2_reset(&name);                                               \
+    }                                                                             \
+    static inline int32_t name##_push(type item)                                  \
+    {                                                                             \
+        uint32_t put = name.put_head;                                             \
+                                                                                  \
+        if (ring_buf_pow2_space_get(&name, (capacity)) == 0) {                    \
+            return -2;                                                            \
+        }                                                                         \
+                                                                                  \
+        name##_buffer[put & ((capacity) - 1)] = item;                             \
+        ring_buf_pow2_typed_put_publish(&name, put + 1);                          \
+                                                                                  \
+        return 0;                                                                 \
+    }                                                                             \
+    static inline uint32_t name##_push_n(const type *items, uint32_t count)       \
+    {                                                                             \
+        uint32_t put = name.put_head;                                             \
+        uint32_t space = ring_buf_pow2_space_get(&name, (capacity));              \
+                                                                                  \
+        count = ring_buf_pow2_min(count, space);                                  \
+                                                                                  \
+        for (uint32_t i = 0; i < count; i++) {                                    \
+            name##_buffer[(put + i) & ((capacity) - 1)] = items[i];               \
+        }                                                                         \
+                                                                                  \
+        ring_buf_pow2_typed_put_publish(&name, put + count);                      \
+                                                                                  \
+        return count;                                                             \
+    }                                                                             \
+    static inline type *name##_front(void)                                        \
+    {                                                                             \
+        if (ring_buf_pow2_size_get(&name) == 0) {                                 \
+            return NULL;                                                          \
+        }                                                                         \
+                                                                                  \
+        return &name##_buffer[name.get_head & ((capacity) - 1)];                  \
+    }                                                                             \
+    static inline int32_t name##_pop(type *item)                                  \
+    {                                                                             \
+        uint32_t get = name.get_head;                                             \
+                                                                                  \
+        if (ring_buf_pow2_size_get(&name) == 0) {                                 \
+            return -1;                                                            \
+        }                                                                         \
+                                                                                  \
+        if (item) {                                                               \
+            *item = name##_buffer[get & ((capacity) - 1)];                        \
+        }                                                                         \
+                                                                                  \
+        ring_buf_pow2_typed_get_publish(&name, get + 1);                          \
+                                                                                  \
+        return 0;                                                                 \
+    }                                                                             \
+    static inline uint32_t name##_pop_n(type *items, uint32_t count)              \
+    {                                                                             \
+        uint32_t get = name.get_head;                                             \
+                                                                                  \
+        count = ring_buf_pow2_min(count, ring_buf_pow2_size_get(&name));          \
+                                                                                  \
+        for (uint32_t i = 0; items && i < count; i++) {                           \
+            items[i] = name##_buffer[(get + i) & ((capacity) - 1)];               \
+        }                                                                         \
+                                                                                  \
+        ring_buf_pow2_typed_get_publish(&name, get + count);                      \
+                                                                                  \
+        return count;                                                             \
+    }                                                                             \
+    static struct ring_buf_pow2 name
+
+/** @cond INTERNAL_HIDDEN */
+
+/*
+ * Typed ring buffers reuse struct ring_buf_pow2, with indices counted in
+ * elements. Elements are never claimed, so each head always equals its tail.
+ */
+static inline void ring_buf_pow2_typed_put_publish(struct ring_buf_pow2 *rb,
+                                                   uint32_t put_tail)
+{
+    rb->put_head = put_tail;
+    __atomic_store_n(&rb->put_tail, put_tail, __ATOMIC_RELEASE);
+}
+
+static inline void ring_buf_pow2_typed_get_publish(struct ring_buf_pow2 *rb,
+                                                   uint32_t get_tail)
+{
+    rb->get_head = get_tail;
+    __atomic_store_n(&rb->get_tail, get_tail, __ATOMIC_RELEASE);
+}
+
+/** @endcond */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_BUFFER_TYPED_H */
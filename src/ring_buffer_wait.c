@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include "ring_buffer_wait.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(__linux__)
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+
+/* Argument of the data and space conditions. */
+struct ring_buf_wait_arg {
+    struct ring_buf *rb;
+    uint32_t size;
+};
+
+static bool has_data(void *arg);
+static bool has_space(void *arg);
+
+
+void ring_buf_waitq_init(struct ring_buf_waitq *wq)
+{
+    __atomic_store_n(&wq->seq, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&wq->waiters, 0, __ATOMIC_RELEASE);
+}
+
+int32_t ring_buf_wait_data(struct ring_buf *rb, struct ring_buf_waitq *wq,
+                           uint32_t size, int32_t timeout_ms)
+{
+    struct ring_buf_wait_arg arg = { .rb = rb, .size = size };
+
+    return ring_buf_waitq_wait(wq, has_data, &arg, timeout_ms);
+}
+
+int32_t ring_buf_wait_space(struct ring_buf *rb, struct ring_buf_waitq *wq,
+                            uint32_t size, int32_t timeout_ms)
+{
+    struct ring_buf_wait_arg arg = { .rb = rb, .size = size };
+
+    return ring_buf_waitq_wait(wq, has_space, &arg, timeout_ms);
+}
+
+static bool has_data(void *arg)
+{
+    struct ring_buf_wait_arg *wait_arg = arg;
+
+    return ring_buf_size_get(wait_arg->rb) >= wait_arg->size;
+}
+
+static bool has_space(void *arg)
+{
+    struct ring_buf_wait_arg *wait_arg = arg;
+
+    return ring_buf_space_get(wait_arg->rb) >= wait_arg->size;
+}
+
+#if defined(__linux__)
+
+static int64_t now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (int64_t) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+void ring_buf_wake(struct ring_buf_waitq *wq)
+{
+    /*
+     * Order the index published by the caller before the waiter check. The
+     * waiter registers itself before re-checking the index, so either it
+     * sees the new index or we see it registered.
+     */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&wq->waiters, __ATOMIC_RELAXED) == 0) {
+        return;
+    }
+
+    __atomic_add_fetch(&wq->seq, 1, __ATOMIC_RELEASE);
+    syscall(SYS_futex, &wq->seq, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+int32_t ring_buf_waitq_wait(struct ring_buf_waitq *wq, ring_buf_wait_cond cond, void *arg,
+                            int32_t timeout_ms)
+{
+    for (uint32_t i = 0; i < RING_BUF_WAIT_SPIN_COUNT; i++) {
+        if (cond(arg)) {
+            return 0;
+        }
+    }
+
+    if (timeout_ms == 0) {
+        return -1;
+    }
+
+    int64_t deadline = now_ms() + timeout_ms;
+
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&wq->seq, __ATOMIC_ACQUIRE);
+
+        __atomic_add_fetch(&wq->waiters, 1, __ATOMIC_SEQ_CST);
+
+        if (cond(arg)) {
+            __atomic_sub_fetch(&wq->waiters, 1, __ATOMIC_RELAXED);
+            return 0;
+        }
+
+        struct timespec ts;
+        struct timespec *timeout = NULL;
+
+        if (timeout_ms != RING_BUF_WAIT_FOREVER) {
+            int64_t remaining = deadline - now_ms();
+
+            if (remaining <= 0) {
+                __atomic_sub_fetch(&wq->waiters, 1, __ATOMIC_RELAXED);
+                return -1;
+            }
+
+            ts.tv_sec = (time_t) (remaining / 1000);
+            ts.tv_nsec = (long) ((remaining % 1000) * 1000000);
+            timeout = &ts;
+        }
+
+        /* returns at once if a wake happened since seq was read */
+        syscall(SYS_futex, &wq->seq, FUTEX_WAIT_PRIVATE, seq, timeout, NULL, 0);
+
+        __atomic_sub_fetch(&wq->waiters, 1, __ATOMIC_RELAXED);
+    }
+}
+
+#else /* !__linux__ */
+
+void ring_buf_wake(struct ring_buf_waitq *wq)
+{
+    (void) wq;
+}
+
+int32_t ring_buf_waitq_wait(struct ring_buf_waitq *wq, ring_buf_wait_cond cond, void *arg,
+                            int32_t timeout_ms)
+{
+    (void) wq;
+
+    for (uint32_t i = 0; i < RING_BUF_WAIT_SPIN_COUNT; i++) {
+        if (cond(arg)) {
+            return 0;
+        }
+    }
+
+    return (timeout_ms == 0) ? -1 : -2;
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef RING_BUFFER_WAIT_H
+#define RING_BUFFER_WAIT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @cond INTERNAL_HIDDEN */
+/* Condition checks done before parking the calling thread. */
+#ifndef RING_BUF_WAIT_SPIN_COUNT
+#define RING_BUF_WAIT_SPIN_COUNT 100u
+#endif
+/** @endcond */
+
+/**
+ * @brief Timeout value to wait without time limit.
+ */
+#define RING_BUF_WAIT_FOREVER (-1)
+
+/**
+ * @brief A structure to represent a queue of threads waiting on a ring
+ *        buffer.
+ *
+ * A ring buffer shared by a blocking producer and a blocking consumer uses
+ * two of them: one the consumer waits on for data (woken by the producer
+ * after committing data) and one the producer waits on for space (woken by
+ * the consumer after freeing data).
+ */
+struct ring_buf_waitq {
+    /** @cond INTERNAL_HIDDEN */
+    uint32_t seq;
+    uint32_t waiters;
+    /** @endcond */
+};
+
+/**
+ * @brief Initialize a wait queue.
+ *
+ * @param wq Address of wait queue.
+ */
+void ring_buf_waitq_init(struct ring_buf_waitq *wq);
+
+/**
+ * @brief Wake all threads waiting on a wait queue.
+ *
+ * Must be called after the data (or the space) that waiters may be waiting
+ * for has been committed with @ref ring_buf_put_finish, @ref ring_buf_put,
+ * @ref ring_buf_item_put (or the get counterparts). A system call is only
+ * issued when a thread is actually parked on @a wq.
+ *
+ * @param wq Address of wait queue.
+ */
+void ring_buf_wake(struct ring_buf_waitq *wq);
+
+/**
+ * @brief Condition checked by @ref ring_buf_waitq_wait.
+ *
+ * @param arg Argument given to @ref ring_buf_waitq_wait.
+ *
+ * @return true to stop waiting.
+ */
+typedef bool (*ring_buf_wait_cond)(void *arg);
+
+/**
+ * @brief Wait on a wait queue until a condition holds.
+ *
+ * The condition is checked a few times before the calling thread is parked
+ * (on a futex on Linux) until @ref ring_buf_wake is called on @a wq, then
+ * checked again on every wake. It must only depend on state published
+ * before the matching @ref ring_buf_wake.
+ *
+ * @param wq Wait queue.
+ * @param cond Condition to wait for.
+ * @param arg Argument passed to @a cond.
+ * @param timeout_ms Maximum waiting time in milliseconds, 0 to only check
+ *                   or RING_BUF_WAIT_FOREVER.
+ *
+ * @retval 0 The condition holds.
+ * @retval -1 Timeout expired.
+ * @retval -2 Blocking is not supported on this platform.
+ */
+int32_t ring_buf_waitq_wait(struct ring_buf_waitq *wq, ring_buf_wait_cond cond, void *arg,
+                            int32_t timeout_ms);
+
+/**
+ * @brief Wait until a ring buffer holds at least @a size bytes of data.
+ *
+ * The condition is checked a few times before the calling thread is parked
+ * (on a futex on Linux) until @ref ring_buf_wake is called on @a wq.
+ *
+ * @param rb Address of ring buffer.
+ * @param wq Wait queue woken by the producer.
+ * @param size Number of bytes to wait for (1 waits for any data).
+ * @param timeout_ms Maximum waiting time in milliseconds, 0 to only check
+ *                   or RING_BUF_WAIT_FOREVER.
+ *
+ * @retval 0 At least @a size bytes are available.
+ * @retval -1 Timeout expired.
+ * @retval -2 Blocking is not supported on this platform.
+ */
+int32_t ring_buf_wait_data(struct ring_buf *rb, struct ring_buf_waitq *wq,
+                           uint32_t size, int32_t timeout_ms);
+
+/**
+ * @brief Wait until a ring buffer has at least @a size bytes of free space.
+ *
+ * The condition is checked a few times before the calling thread is parked
+ * (on a futex on Linux) until @ref ring_buf_wake is called on @a wq.
+ *
+ * @param rb Address of ring buffer.
+ * @param wq Wait queue woken by the consumer.
+ * @param size Number of bytes to wait for.
+ * @param timeout_ms Maximum waiting time in milliseconds, 0 to only check
+ *                   or RING_BUF_WAIT_FOREVER.
+ *
+ * @retval 0 At least @a size bytes are free.
+ * @retval -1 Timeout expired.
+ * @retval -2 Blocking is not supported on this platform.
+ */
+int32_t ring_buf_wait_space(struct ring_buf *rb, struct ring_buf_waitq *wq,
+                            uint32_t size, int32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_BUFFER_WAIT_H */
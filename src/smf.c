@@ -6,6 +6,12 @@
 
 #include "smf.h"
 
+#ifdef SMF_TRACE
+#include "smf_trace.h"
+#else
+#define SMF_TRACE_POINT(ctx, kind, from, to, arg)
+#endif
+
 #include <stddef.h>
 
 
@@ -65,6 +71,92 @@ static const struct smf_state *get_lca_of(const struct smf_state *source,
     return NULL;
 }
 
+/**
+ * @brief Find the ancestry of a state in the table of a state machine
+ *
+ * @param ctx State machine context
+ * @param state State to look up
+ * @return Path of the state, or NULL if it is not in the table.
+ */
+static const struct smf_path *get_path_of(const struct smf_ctx *ctx,
+                                          const struct smf_state *state)
+{
+    const struct smf_ancestry *ancestry = ctx->ancestry;
+
+    if (ancestry == NULL || state == NULL) {
+        return NULL;
+    }
+
+    uintptr_t offset = (uintptr_t) state - (uintptr_t) ancestry->states;
+    uintptr_t index = offset / sizeof(*state);
+
+    if (index >= ancestry->count || offset % sizeof(*state) != 0) {
+        return NULL;
+    }
+
+    return &ancestry->paths[index];
+}
+
+/**
+ * @brief Number of leading states shared by two paths, which is the depth
+ *        of the state where exits stop and entries start
+ *
+ * The shared state is the destination when it is an ancestor of the source
+ * (or the source itself), the source when it is an ancestor of the
+ * destination, else their Least Common Ancestor.
+ *
+ * @param source transition source
+ * @param dest transition destination
+ * @return depth of the topmost state, 0 if the states have no LCA
+ */
+static uint32_t get_topmost_depth(const struct smf_path *source,
+                                  const struct smf_path *dest)
+{
+    uint32_t depth = (source->depth < dest->depth) ? source->depth : dest->depth;
+    uint32_t shared = 0;
+
+    while (shared < depth && source->chain[shared] == dest->chain[shared]) {
+        shared++;
+    }
+
+    return shared;
+}
+
+/**
+ * @brief Executes the entry actions of a path, below a given depth
+ *
+ * @param ctx State machine context
+ * @param path Path of the state we are transitioning to
+ * @param depth Depth of the topmost state, whose entry action is not executed
+ * @return true if the state machine should terminate, else false
+ */
+static bool smf_execute_path_entry_actions(struct smf_ctx *const ctx,
+                                           const struct smf_path *path,
+                                           uint32_t depth)
+{
+    struct internal_ctx *const internal = &ctx->internal;
+
+    for (uint32_t i = depth; i < path->depth; i++) {
+        const struct smf_state *to_execute = path->chain[i];
+
+        /* Keep track of the executing entry action in case it calls
+         * smf_set_state()
+         */
+        ctx->executing = to_execute;
+        if (to_execute->entry) {
+            SMF_TRACE_POINT(ctx, SMF_TRACE_ENTRY, NULL, to_execute, 0);
+            to_execute->entry(ctx);
+
+            /* No need to continue if terminate was set */
+            if (internal->terminate) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 /**
  * @brief Executes all entry actions from the direct child of topmost to the
  *        new state
@@ -94,6 +186,7 @@ static bool smf_execute_all_entry_actions(struct smf_ctx *const ctx,
         ctx->executing = to_execute;
         /* Execute every entry action EXCEPT that of the topmost state */
         if (to_execute->entry) {
+            SMF_TRACE_POINT(ctx, SMF_TRACE_ENTRY, NULL, to_execute, 0);
             to_execute->entry(ctx);
 
             /* No need to continue if terminate was set */
@@ -106,6 +199,7 @@ static bool smf_execute_all_entry_actions(struct smf_ctx *const ctx,
     /* and execute the new state entry action */
     ctx->executing = new_state;
     if (new_state->entry) {
+        SMF_TRACE_POINT(ctx, SMF_TRACE_ENTRY, NULL, new_state, 0);
         new_state->entry(ctx);
 
         /* No need to continue if terminate was set */
@@ -189,6 +283,7 @@ static bool smf_execute_all_exit_actions(struct smf_ctx *const ctx,
          to_execute != NULL && to_execute != topmost;
          to_execute = to_execute->parent) {
         if (to_execute->exit) {
+            SMF_TRACE_POINT(ctx, SMF_TRACE_EXIT, to_execute, NULL, 0);
             to_execute->exit(ctx);
 
             /* No need to continue if terminate was set in the exit action */
@@ -196,12 +291,22 @@ static bool smf_execute_all_exit_actions(struct smf_ctx *const ctx,
                 return true;
             }
         }
+
+        /* Let modules clean up after the state, e.g. cancel its timers */
+        if (ctx->exit_hook != NULL) {
+            ctx->exit_hook(ctx, to_execute);
+        }
     }
 
     return false;
 }
 
-void smf_set_initial(struct smf_ctx *ctx, const struct smf_state *init_state)
+/*
+ * Start the state machine in its initial state. Only the fields of the
+ * context used by every state machine are set, those of optional modules
+ * are left to the caller.
+ */
+static void smf_start(struct smf_ctx *ctx, const struct smf_state *init_state)
 {
     struct internal_ctx *const internal = &ctx->internal;
 
@@ -221,6 +326,8 @@ void smf_set_initial(struct smf_ctx *ctx, const struct smf_state *init_state)
     ctx->previous = NULL;
     ctx->terminate_val = 0;
 
+    SMF_TRACE_POINT(ctx, SMF_TRACE_INITIAL, NULL, init_state, 0);
+
     ctx->executing = init_state;
     const struct smf_state *topmost = get_last_of(init_state);
 
@@ -228,6 +335,7 @@ void smf_set_initial(struct smf_ctx *ctx, const struct smf_state *init_state)
      * smf_execute_all_entry_actions() doesn't
      */
     if (topmost->entry) {
+        SMF_TRACE_POINT(ctx, SMF_TRACE_ENTRY, NULL, topmost, 0);
         topmost->entry(ctx);
         if (internal->terminate) {
             /* No need to continue if terminate was set */
@@ -241,6 +349,62 @@ void smf_set_initial(struct smf_ctx *ctx, const struct smf_state *init_state)
     }
 }
 
+void smf_set_initial(struct smf_ctx *ctx, const struct smf_state *init_state)
+{
+    ctx->ancestry = NULL;
+    ctx->events = NULL;
+    ctx->event = NULL;
+    ctx->exit_hook = NULL;
+    ctx->timers = NULL;
+
+    smf_start(ctx, init_state);
+}
+
+void smf_restart(struct smf_ctx *ctx, const struct smf_state *init_state)
+{
+    /* Leave the states of the previous run, e.g. cancel their timers */
+    if (ctx->exit_hook != NULL) {
+        ctx->exit_hook(ctx, NULL);
+    }
+
+    smf_start(ctx, init_state);
+}
+
+int32_t smf_ancestry_init(struct smf_ancestry *ancestry, const struct smf_state *states,
+                          struct smf_path *paths, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        struct smf_path *path = &paths[i];
+        uint32_t depth = 0;
+
+        for (const struct smf_state *state = &states[i]; state != NULL;
+             state = state->parent) {
+            if (depth == SMF_MAX_DEPTH) {
+                return -1;
+            }
+            depth++;
+        }
+
+        /* fill the chain from the state up to the root */
+        path->depth = depth;
+        for (const struct smf_state *state = &states[i]; state != NULL;
+             state = state->parent) {
+            path->chain[--depth] = state;
+        }
+    }
+
+    ancestry->states = states;
+    ancestry->paths = paths;
+    ancestry->count = count;
+
+    return 0;
+}
+
+void smf_set_ancestry(struct smf_ctx *ctx, const struct smf_ancestry *ancestry)
+{
+    ctx->ancestry = ancestry;
+}
+
 void smf_set_state(struct smf_ctx *const ctx, const struct smf_state *new_state)
 {
     struct internal_ctx *const internal = &ctx->internal;
@@ -260,9 +424,18 @@ void smf_set_state(struct smf_ctx *const ctx, const struct smf_state *new_state)
         return;
     }
 
+    SMF_TRACE_POINT(ctx, SMF_TRACE_TRANSITION, ctx->current, new_state, 0);
+
+    const struct smf_path *source_path = get_path_of(ctx, ctx->executing);
+    const struct smf_path *dest_path = get_path_of(ctx, new_state);
     const struct smf_state *topmost;
+    uint32_t topmost_depth = 0;
 
-    if (share_paren(ctx->executing, new_state)) {
+    if (source_path != NULL && dest_path != NULL) {
+        /* both states are in the ancestry table */
+        topmost_depth = get_topmost_depth(source_path, dest_path);
+        topmost = (topmost_depth > 0) ? dest_path->chain[topmost_depth - 1] : NULL;
+    } else if (share_paren(ctx->executing, new_state)) {
         /* new state is a parent of where we are now*/
         topmost = new_state;
     } else if (share_paren(new_state, ctx->executing)) {
@@ -284,6 +457,7 @@ void smf_set_state(struct smf_ctx *const ctx, const struct smf_state *new_state)
 
     /* if self-transition, call the exit action */
     if ((ctx->executing == new_state) && (new_state->exit)) {
+        SMF_TRACE_POINT(ctx, SMF_TRACE_EXIT, new_state, NULL, 0);
         new_state->exit(ctx);
 
         /* No need to continue if terminate was set in the exit action */
@@ -292,10 +466,16 @@ void smf_set_state(struct smf_ctx *const ctx, const struct smf_state *new_state)
         }
     }
 
+    /* if self-transition, let modules clean up after the state */
+    if ((ctx->executing == new_state) && (ctx->exit_hook != NULL)) {
+        ctx->exit_hook(ctx, new_state);
+    }
+
     internal->is_exit = false;
 
     /* if self transition, call the entry action */
     if ((ctx->executing == new_state) && (new_state->entry)) {
+        SMF_TRACE_POINT(ctx, SMF_TRACE_ENTRY, NULL, new_state, 0);
         new_state->entry(ctx);
 
         /* No need to continue if terminate was set in the entry action */
@@ -316,8 +496,17 @@ void smf_set_state(struct smf_ctx *const ctx, const struct smf_state *new_state)
     ctx->previous = ctx->current;
     ctx->current = new_state;
 
-    /* call all entry actions (except those of topmost) */
-    if (smf_execute_all_entry_actions(ctx, new_state, topmost)) {
+    /* call all entry actions (except those of topmost), the depth of topmost
+     * is only known when both states are in the ancestry table */
+    const struct smf_path *leaf_path = (source_path != NULL && dest_path != NULL) ?
+                                       get_path_of(ctx, new_state) : NULL;
+
+    if (leaf_path != NULL) {
+        if (smf_execute_path_entry_actions(ctx, leaf_path, topmost_depth)) {
+            /* No need to continue if terminate was set in the entry action */
+            return;
+        }
+    } else if (smf_execute_all_entry_actions(ctx, new_state, topmost)) {
         /* No need to continue if terminate was set in the entry action */
         return;
     }
@@ -329,6 +518,13 @@ void smf_set_terminate(struct smf_ctx *ctx, int32_t val)
 
     internal->terminate = true;
     ctx->terminate_val = val;
+
+    /* The state machine will not run again: leave all its states */
+    if (ctx->exit_hook != NULL) {
+        ctx->exit_hook(ctx, NULL);
+    }
+
+    SMF_TRACE_POINT(ctx, SMF_TRACE_TERMINATE, NULL, ctx->current, (uint32_t) val);
 }
 
 void smf_set_handled(struct smf_ctx *ctx)
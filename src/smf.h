@@ -38,6 +38,14 @@
  */
 #define SMF_CTX(o) ((struct smf_ctx *)o)
 
+/**
+ * @brief Maximum number of nesting levels of a state hierarchy described by
+ *        an ancestry table, see @ref smf_ancestry_init.
+ */
+#ifndef SMF_MAX_DEPTH
+#define SMF_MAX_DEPTH 16
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -49,6 +57,18 @@ extern "C" {
  */
 typedef void (*state_execution)(void *obj);
 
+struct smf_ctx;
+struct smf_state;
+
+/**
+ * @brief Function pointer called as states exit, see smf_ctx::exit_hook
+ *
+ * @param ctx   State machine context
+ * @param state State that exits, or NULL when all states are left at once
+ *              because the state machine restarts or terminates
+ */
+typedef void (*smf_exit_hook)(struct smf_ctx *ctx, const struct smf_state *state);
+
 /** Private structure used to track state machine context. */
 struct internal_ctx {
     bool new_state;
@@ -89,6 +109,35 @@ struct smf_state {
     const struct smf_state *initial;
 };
 
+/** Ancestors of a state, computed by @ref smf_ancestry_init. */
+struct smf_path {
+    /** Number of states from the root to this state, both included */
+    uint32_t depth;
+
+    /** States from the root (index 0) down to this state (index depth - 1) */
+    const struct smf_state *chain[SMF_MAX_DEPTH];
+};
+
+/**
+ * Ancestry table of an array of states, so transitions between them find
+ * their Least Common Ancestor and entry path in O(depth) without walking
+ * parent chains.
+ */
+struct smf_ancestry {
+    /** States of the table */
+    const struct smf_state *states;
+
+    /** Ancestors of each state, in the order of @ref states */
+    const struct smf_path *paths;
+
+    /** Number of states */
+    uint32_t count;
+};
+
+struct ring_buf;
+struct smf_event;
+struct smf_timer;
+
 /** Defines the current context of the state machine. */
 struct smf_ctx {
     /** Current state the state machine is executing. */
@@ -110,16 +159,81 @@ struct smf_ctx {
 
     /** It's used to track state machine context */
     struct internal_ctx internal;
+
+    /** Optional ancestry table of the states, set by smf_set_ancestry */
+    const struct smf_ancestry *ancestry;
+
+    /** Optional event queue, see smf_set_event_queue in smf_event.h */
+    struct ring_buf *events;
+
+    /** Event being dispatched, NULL outside of smf_dispatch */
+    const struct smf_event *event;
+
+    /**
+     * Optional hook called as states exit, so modules such as the timers
+     * of smf_timer.h clean up after them without the framework linking
+     * them. Installed by those modules, kept by smf_restart.
+     */
+    smf_exit_hook exit_hook;
+
+    /** Timers armed by the active states, see smf_timer_arm */
+    struct smf_timer *timers;
 };
 
+/**
+ * @brief Computes the ancestry table of an array of states.
+ *
+ * States with a parent outside of the array are supported, their whole
+ * parent chain is recorded.
+ *
+ * @param ancestry Ancestry table to initialize
+ * @param states   Array of states, usually the one of the state machine
+ * @param paths    Array of @p count paths, filled by this function
+ * @param count    Number of states
+ *
+ * @retval 0 Ancestry table was computed.
+ * @retval -1 A state is nested deeper than SMF_MAX_DEPTH levels.
+ */
+int32_t smf_ancestry_init(struct smf_ancestry *ancestry, const struct smf_state *states,
+                          struct smf_path *paths, uint32_t count);
+
+/**
+ * @brief Makes a state machine use an ancestry table for its transitions.
+ *
+ * Transitions between states of the table cost O(depth) instead of
+ * O(depth²). Transitions involving other states use parent chains, as
+ * without a table.
+ *
+ * @param ctx      State machine context
+ * @param ancestry Ancestry table, or NULL to stop using one
+ */
+void smf_set_ancestry(struct smf_ctx *ctx, const struct smf_ancestry *ancestry);
+
 /**
  * @brief Initializes the state machine and sets its initial state.
  *
+ * The whole context is initialized, whatever it held before, so the
+ * ancestry table, event queue and timers of optional modules are set up
+ * after the state machine is first started. A running state machine is
+ * restarted with smf_restart instead, which keeps them.
+ *
  * @param ctx        State machine context
  * @param init_state Initial state the state machine starts in.
  */
 void smf_set_initial(struct smf_ctx *ctx, const struct smf_state *init_state);
 
+/**
+ * @brief Restarts a state machine in a given state.
+ *
+ * All states are left first, see smf_ctx::exit_hook, but their exit actions
+ * do not run. The ancestry table, event queue and exit hook of the context
+ * are kept.
+ *
+ * @param ctx        State machine context, started with smf_set_initial
+ * @param init_state Initial state the state machine restarts in.
+ */
+void smf_restart(struct smf_ctx *ctx, const struct smf_state *init_state);
+
 /**
  * @brief Changes a state machines state. This handles exiting the previous
  *        state and entering the target state. For HSMs the entry and exit
@@ -133,6 +247,9 @@ void smf_set_state(struct smf_ctx *ctx, const struct smf_state *new_state);
 /**
  * @brief Terminate a state machine
  *
+ * All states are left, see smf_ctx::exit_hook, but their exit actions do
+ * not run.
+ *
  * @param ctx  State machine context
  * @param val  Non-Zero termination value that's returned by the smf_run_state
  *             function.
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include "smf_engine.h"
+
+#include <stddef.h>
+
+#define SMF_ENGINE_WORD(id) ((id) / 64u)
+#define SMF_ENGINE_BIT(id)  (UINT64_C(1) << ((id) % 64u))
+
+
+struct smf_engine_wait_arg {
+    struct smf_engine *engine;
+    uint32_t generation;
+};
+
+static uint16_t state_index_of(const struct smf_engine *engine, const struct smf_state *state);
+static uint32_t batch_collect(struct smf_engine *engine);
+static void batch_run(struct smf_engine *engine, uint32_t worker);
+static void instance_run(struct smf_engine *engine, uint32_t id);
+#if defined(__linux__)
+static void *worker_main(void *arg);
+static bool worker_has_batch(void *arg);
+static bool batch_is_done(void *arg);
+#endif
+
+
+int32_t smf_engine_init(struct smf_engine *engine, const struct smf_ancestry *ancestry)
+{
+    if (ancestry != NULL && ancestry->count > SMF_ENGINE_MAX_STATES) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < SMF_ENGINE_WORDS; i++) {
+        engine->pending[i] = 0;
+        engine->batch[i] = 0;
+        engine->done[i] = 0;
+    }
+
+    engine->ancestry = ancestry;
+    engine->count = 0;
+    engine->batch_size = 0;
+    engine->worker_count = 0;
+    engine->generation = 0;
+    engine->remaining = 0;
+    engine->stop = false;
+    ring_buf_waitq_init(&engine->start_wq);
+    ring_buf_waitq_init(&engine->done_wq);
+
+    return 0;
+}
+
+int32_t smf_engine_add(struct smf_engine *engine, struct smf_ctx *ctx)
+{
+    if (engine->count == SMF_ENGINE_MAX_INSTANCES) {
+        return -1;
+    }
+
+    uint32_t id = engine->count++;
+
+    if (engine->ancestry != NULL) {
+        smf_set_ancestry(ctx, engine->ancestry);
+    }
+
+    engine->instances[id] = ctx;
+    engine->state[id] = state_index_of(engine, ctx->current);
+    engine->result[id] = 0;
+
+    /* events posted before the instance joined are found by the next batch */
+    if (smf_event_pending(ctx)) {
+        smf_engine_wake(engine, id);
+    }
+
+    return (int32_t) id;
+}
+
+void smf_engine_wake(struct smf_engine *engine, uint32_t id)
+{
+    if (id >= engine->count) {
+        return;
+    }
+
+    __atomic_fetch_or(&engine->pending[SMF_ENGINE_WORD(id)], SMF_ENGINE_BIT(id),
+                      __ATOMIC_RELEASE);
+}
+
+int32_t smf_engine_post(struct smf_engine *engine, uint32_t id, uint16_t event,
+                        uint8_t value, const uint32_t *data, uint8_t size32)
+{
+    if (id >= engine->count) {
+        return -1;
+    }
+
+    int32_t result = smf_post_event(engine->instances[id], event, value, data, size32);
+
+    if (result == 0) {
+        smf_engine_wake(engine, id);
+    }
+
+    return result;
+}
+
+uint32_t smf_engine_run(struct smf_engine *engine)
+{
+    uint32_t size = batch_collect(engine);
+
+    if (size == 0) {
+        return 0;
+    }
+
+#if defined(__linux__)
+    if (engine->worker_count > 0) {
+        __atomic_store_n(&engine->remaining, engine->worker_count, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&engine->generation, 1, __ATOMIC_RELEASE);
+        ring_buf_wake(&engine->start_wq);
+
+        batch_run(engine, 0);
+
+        (void) ring_buf_waitq_wait(&engine->done_wq, batch_is_done, engine,
+                                   RING_BUF_WAIT_FOREVER);
+
+        return size;
+    }
+#endif
+
+    batch_run(engine, 0);
+
+    return size;
+}
+
+int32_t smf_engine_result(struct smf_engine *engine, uint32_t id)
+{
+    if (id >= engine->count) {
+        return 0;
+    }
+
+    return __atomic_load_n(&engine->result[id], __ATOMIC_ACQUIRE);
+}
+
+#if defined(__linux__)
+
+int32_t smf_engine_workers_start(struct smf_engine *engine, uint32_t workers)
+{
+    if (workers == 0 || workers > SMF_ENGINE_MAX_WORKERS || engine->worker_count != 0) {
+        return -1;
+    }
+
+    engine->stop = false;
+
+    for (uint32_t i = 0; i < workers; i++) {
+        struct smf_engine_worker *worker = &engine->workers[i];
+
+        worker->engine = engine;
+        worker->index = i + 1;
+        worker->generation = engine->generation;
+
+        if (pthread_create(&worker->thread, NULL, worker_main, worker) != 0) {
+            engine->worker_count = i;
+            smf_engine_workers_stop(engine);
+            return -2;
+        }
+    }
+
+    engine->worker_count = workers;
+
+    return 0;
+}
+
+void smf_engine_workers_stop(struct smf_engine *engine)
+{
+    __atomic_store_n(&engine->stop, true, __ATOMIC_RELEASE);
+    ring_buf_wake(&engine->start_wq);
+
+    for (uint32_t i = 0; i < engine->worker_count; i++) {
+        pthread_join(engine->workers[i].thread, NULL);
+    }
+
+    engine->worker_count = 0;
+}
+
+#else /* !__linux__ */
+
+int32_t smf_engine_workers_start(struct smf_engine *engine, uint32_t workers)
+{
+    (void) engine;
+
+    return (workers == 0 || workers > SMF_ENGINE_MAX_WORKERS) ? -1 : -2;
+}
+
+void smf_engine_workers_stop(struct smf_engine *engine)
+{
+    engine->worker_count = 0;
+}
+
+#endif /* __linux__ */
+
+/* Index of a state in the ancestry table, or the number of states if it is
+ * not in the table. */
+static uint16_t state_index_of(const struct smf_engine *engine, const struct smf_state *state)
+{
+    const struct smf_ancestry *ancestry = engine->ancestry;
+
+    if (ancestry == NULL) {
+        return 0;
+    }
+
+    uintptr_t offset = (uintptr_t) state - (uintptr_t) ancestry->states;
+    uintptr_t index = offset / sizeof(*state);
+
+    if (index >= ancestry->count || offset % sizeof(*state) != 0) {
+        return (uint16_t) ancestry->count;
+    }
+
+    return (uint16_t) index;
+}
+
+/*
+ * Take the scheduled instances out of the pending bitmap and sort them by
+ * state into the order array, with a counting sort over the state indices.
+ */
+static uint32_t batch_collect(struct smf_engine *engine)
+{
+    uint32_t states = (engine->ancestry != NULL) ? engine->ancestry->count + 1u : 1u;
+    uint32_t *buckets = engine->buckets;
+    uint32_t words = (engine->count + 63u) / 64u;
+    uint32_t size = 0;
+
+    for (uint32_t s = 0; s <= states; s++) {
+        buckets[s] = 0;
+    }
+
+    for (uint32_t w = 0; w < words; w++) {
+        uint64_t bits = 0;
+
+        if (__atomic_load_n(&engine->pending[w], __ATOMIC_RELAXED) != 0) {
+            bits = __atomic_exchange_n(&engine->pending[w], 0, __ATOMIC_ACQUIRE);
+            bits &= ~engine->done[w];
+        }
+
+        engine->batch[w] = bits;
+
+        for (; bits != 0; bits &= bits - 1u) {
+            uint32_t id = w * 64u + (uint32_t) __builtin_ctzll(bits);
+
+            buckets[engine->state[id] + 1u]++;
+            size++;
+        }
+    }
+
+    if (size == 0) {
+        return 0;
+    }
+
+    for (uint32_t s = 1; s <= states; s++) {
+        buckets[s] += buckets[s - 1u];
+    }
+
+    for (uint32_t w = 0; w < words; w++) {
+        for (uint64_t bits = engine->batch[w]; bits != 0; bits &= bits - 1u) {
+            uint32_t id = w * 64u + (uint32_t) __builtin_ctzll(bits);
+
+            engine->order[buckets[engine->state[id]]++] = id;
+        }
+    }
+
+    engine->batch_size = size;
+
+    return size;
+}
+
+/* Run the share of the batch of a worker, 0 being the calling thread. */
+static void batch_run(struct smf_engine *engine, uint32_t worker)
+{
+    uint32_t shares = engine->worker_count + 1u;
+    uint32_t size = engine->batch_size;
+    uint32_t start = (uint32_t) (((uint64_t) size * worker) / shares);
+    uint32_t end = (uint32_t) (((uint64_t) size * (worker + 1u)) / shares);
+
+    for (uint32_t i = start; i < end; i++) {
+        instance_run(engine, engine->order[i]);
+    }
+}
+
+static void instance_run(struct smf_engine *engine, uint32_t id)
+{
+    struct smf_ctx *ctx = engine->instances[id];
+    int32_t result = 0;
+
+    if (smf_event_pending(ctx)) {
+        for (uint32_t i = 0; i < SMF_ENGINE_EVENT_BUDGET && result == 0; i++) {
+            result = smf_dispatch(ctx);
+
+            if (!smf_event_pending(ctx)) {
+                break;
+            }
+        }
+    } else {
+        result = smf_run_state(ctx);
+    }
+
+    engine->state[id] = state_index_of(engine, ctx->current);
+
+    if (result != 0) {
+        /* instances sharing a word may run on other workers */
+        __atomic_fetch_or(&engine->done[SMF_ENGINE_WORD(id)], SMF_ENGINE_BIT(id),
+                          __ATOMIC_RELAXED);
+        __atomic_store_n(&engine->result[id], result, __ATOMIC_RELEASE);
+    } else if (smf_event_pending(ctx)) {
+        smf_engine_wake(engine, id);
+    }
+}
+
+#if defined(__linux__)
+
+static void *worker_main(void *arg)
+{
+    struct smf_engine_worker *worker = arg;
+    struct smf_engine *engine = worker->engine;
+
+    for (;;) {
+        struct smf_engine_wait_arg wait_arg = {
+            .engine = engine,
+            .generation = worker->generation,
+        };
+
+        (void) ring_buf_waitq_wait(&engine->start_wq, worker_has_batch, &wait_arg,
+                                   RING_BUF_WAIT_FOREVER);
+
+        if (__atomic_load_n(&engine->stop, __ATOMIC_ACQUIRE)) {
+            return NULL;
+        }
+
+        worker->generation++;
+        batch_run(engine, worker->index);
+
+        if (__atomic_sub_fetch(&engine->remaining, 1, __ATOMIC_ACQ_REL) == 0) {
+            ring_buf_wake(&engine->done_wq);
+        }
+    }
+}
+
+static bool worker_has_batch(void *arg)
+{
+    struct smf_engine_wait_arg *wait_arg = arg;
+
+    return __atomic_load_n(&wait_arg->engine->stop, __ATOMIC_ACQUIRE) ||
+           __atomic_load_n(&wait_arg->engine->generation, __ATOMIC_ACQUIRE) !=
+           wait_arg->generation;
+}
+
+static bool batch_is_done(void *arg)
+{
+    struct smf_engine *engine = arg;
+
+    return __atomic_load_n(&engine->remaining, __ATOMIC_ACQUIRE) == 0;
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SMF_ENGINE_H
+#define SMF_ENGINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+#include "smf.h"
+#include "smf_event.h"
+#include "ring_buffer_wait.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @cond INTERNAL_HIDDEN */
+/* Number of instances of an engine: a multiple of 64. */
+#ifndef SMF_ENGINE_MAX_INSTANCES
+#define SMF_ENGINE_MAX_INSTANCES 1024u
+#endif
+
+/* Number of states of the ancestry table of an engine, up to 65535. */
+#ifndef SMF_ENGINE_MAX_STATES
+#define SMF_ENGINE_MAX_STATES 255u
+#endif
+
+/* Events dispatched to an instance per batch, so busy instances do not
+ * starve the others. */
+#ifndef SMF_ENGINE_EVENT_BUDGET
+#define SMF_ENGINE_EVENT_BUDGET 8u
+#endif
+
+/* Worker threads of an engine, besides the thread calling smf_engine_run. */
+#ifndef SMF_ENGINE_MAX_WORKERS
+#define SMF_ENGINE_MAX_WORKERS 8u
+#endif
+
+#define SMF_ENGINE_WORDS (SMF_ENGINE_MAX_INSTANCES / 64u)
+
+#if (SMF_ENGINE_MAX_INSTANCES % 64u) != 0 || SMF_ENGINE_MAX_INSTANCES == 0
+#error "SMF_ENGINE_MAX_INSTANCES must be a non-zero multiple of 64"
+#endif
+
+#if SMF_ENGINE_MAX_STATES > 65535u
+#error "SMF_ENGINE_MAX_STATES must be up to 65535"
+#endif
+
+struct smf_engine;
+
+struct smf_engine_worker {
+    struct smf_engine *engine;
+    uint32_t index;
+    uint32_t generation;
+#if defined(__linux__)
+    pthread_t thread;
+#endif
+};
+/** @endcond */
+
+/**
+ * @brief A structure to run many state machine instances in batches.
+ *
+ * Instances are kept in a structure-of-arrays layout: a batch scans the
+ * pending bitmap and the state index array, and only touches the context of
+ * instances that have work to do, either queued events (see
+ * @ref smf_dispatch) or an explicit wake-up (see @ref smf_engine_wake).
+ *
+ * The instances of a batch are ordered by current state, so instances in
+ * the same state run back to back and their actions stay hot in caches and
+ * branch predictors. Grouping needs the ancestry table of the states (see
+ * @ref smf_ancestry_init); it also speeds up the transitions of every
+ * instance.
+ *
+ * Any thread may wake instances or post events concurrently with a batch,
+ * as long as each instance's event queue has a single producer at a time.
+ * Batches themselves must be run by a single thread.
+ */
+struct smf_engine {
+    /** @cond INTERNAL_HIDDEN */
+    struct smf_ctx *instances[SMF_ENGINE_MAX_INSTANCES];
+    uint16_t state[SMF_ENGINE_MAX_INSTANCES];
+    int32_t result[SMF_ENGINE_MAX_INSTANCES];
+    uint32_t order[SMF_ENGINE_MAX_INSTANCES];
+    uint64_t pending[SMF_ENGINE_WORDS];
+    uint64_t batch[SMF_ENGINE_WORDS];
+    uint64_t done[SMF_ENGINE_WORDS];
+    uint32_t buckets[SMF_ENGINE_MAX_STATES + 2u];
+    const struct smf_ancestry *ancestry;
+    uint32_t count;
+    uint32_t batch_size;
+
+    struct smf_engine_worker workers[SMF_ENGINE_MAX_WORKERS];
+    uint32_t worker_count;
+    uint32_t generation;
+    uint32_t remaining;
+    bool stop;
+    struct ring_buf_waitq start_wq;
+    struct ring_buf_waitq done_wq;
+    /** @endcond */
+};
+
+/**
+ * @brief Initialize an empty engine.
+ *
+ * @param engine Address of engine.
+ * @param ancestry Ancestry table of the states of the instances, or NULL to
+ *                 run batches in instance order.
+ *
+ * @retval 0 Engine was initialized.
+ * @retval -1 The ancestry table holds more than SMF_ENGINE_MAX_STATES
+ *            states.
+ */
+int32_t smf_engine_init(struct smf_engine *engine, const struct smf_ancestry *ancestry);
+
+/**
+ * @brief Add a state machine instance to an engine.
+ *
+ * The instance must have been started with @ref smf_set_initial. It is
+ * given the ancestry table of the engine, and is scheduled at once if its
+ * event queue already holds events. Instances restart with
+ * @ref smf_restart, which keeps the ancestry table and the event queue.
+ *
+ * @warning
+ * Must not run concurrently with @ref smf_engine_run.
+ *
+ * @param engine Address of engine.
+ * @param ctx State machine context of the instance.
+ *
+ * @return Identifier of the instance, or -1 if the engine is full.
+ */
+int32_t smf_engine_add(struct smf_engine *engine, struct smf_ctx *ctx);
+
+/**
+ * @brief Schedule an instance for the next batch.
+ *
+ * An instance woken without queued events runs once, as with
+ * @ref smf_run_state. Waking an instance already scheduled costs one
+ * atomic operation.
+ *
+ * @param engine Address of engine.
+ * @param id Identifier of the instance.
+ */
+void smf_engine_wake(struct smf_engine *engine, uint32_t id);
+
+/**
+ * @brief Post an event to an instance and schedule it.
+ *
+ * @param engine Address of engine.
+ * @param id Identifier of the instance.
+ * @param event Event identifier.
+ * @param value Event integer value.
+ * @param data Event payload, or NULL if @p size32 is 0.
+ * @param size32 Payload size in 32-bit words.
+ *
+ * @return Same values as @ref smf_post_event.
+ */
+int32_t smf_engine_post(struct smf_engine *engine, uint32_t id, uint16_t event,
+                        uint8_t value, const uint32_t *data, uint8_t size32);
+
+/**
+ * @brief Run one batch of the scheduled instances.
+ *
+ * Each scheduled instance dispatches up to SMF_ENGINE_EVENT_BUDGET queued
+ * events, or runs once if it has none. Instances with events left are
+ * scheduled again. Terminated instances are never run again, see
+ * @ref smf_engine_result.
+ *
+ * When worker threads are started, the batch is split between them and
+ * the calling thread, which returns once all instances have run.
+ *
+ * @param engine Address of engine.
+ *
+ * @return Number of instances run.
+ */
+uint32_t smf_engine_run(struct smf_engine *engine);
+
+/**
+ * @brief Get the termination value of an instance.
+ *
+ * @param engine Address of engine.
+ * @param id Identifier of the instance.
+ *
+ * @return The non-zero value the instance terminated with, or 0 while it
+ *         runs.
+ */
+int32_t smf_engine_result(struct smf_engine *engine, uint32_t id);
+
+/**
+ * @brief Start worker threads sharing the batches of an engine.
+ *
+ * Actions of instances run by different workers run concurrently: they
+ * must not share unprotected data, and may only post events to their own
+ * instance.
+ *
+ * @param engine Address of engine.
+ * @param workers Number of worker threads, up to SMF_ENGINE_MAX_WORKERS.
+ *
+ * @retval 0 Workers were started.
+ * @retval -1 @a workers is out of range or workers are already started.
+ * @retval -2 Threads are not supported on this platform or could not be
+ *            created.
+ */
+int32_t smf_engine_workers_start(struct smf_engine *engine, uint32_t workers);
+
+/**
+ * @brief Stop the worker threads of an engine.
+ *
+ * Must not run concurrently with @ref smf_engine_run.
+ *
+ * @param engine Address of engine.
+ */
+void smf_engine_workers_stop(struct smf_engine *engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SMF_ENGINE_H */
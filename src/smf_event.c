@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "smf_event.h"
+
+#ifdef SMF_TRACE
+#include "smf_trace.h"
+#else
+#define SMF_TRACE_POINT(ctx, kind, from, to, arg)
+#endif
+
+#include <stddef.h>
+
+
+void smf_set_event_queue(struct smf_ctx *ctx, struct ring_buf *queue)
+{
+    ctx->events = queue;
+}
+
+int32_t smf_post_event(struct smf_ctx *ctx, uint16_t id, uint8_t value,
+                       const uint32_t *data, uint8_t size32)
+{
+    if (ctx->events == NULL || size32 > SMF_EVENT_MAX_SIZE32) {
+        return -1;
+    }
+
+    uint32_t payload[SMF_EVENT_MAX_SIZE32 + 1];
+
+    for (uint8_t i = 0; i < size32; i++) {
+        payload[i] = data[i];
+    }
+
+    return (ring_buf_item_put(ctx->events, id, value, payload, size32) == 0) ? 0 : -2;
+}
+
+bool smf_event_pending(struct smf_ctx *ctx)
+{
+    return ctx->events != NULL && !ring_buf_is_empty(ctx->events);
+}
+
+const struct smf_event *smf_get_event(const struct smf_ctx *ctx)
+{
+    return ctx->event;
+}
+
+int32_t smf_dispatch(struct smf_ctx *const ctx)
+{
+    struct smf_event event;
+
+    /* No need to continue if terminate was set */
+    if (ctx->internal.terminate) {
+        return ctx->terminate_val;
+    }
+
+    if (ctx->events == NULL) {
+        return 0;
+    }
+
+    for (;;) {
+        event.size32 = SMF_EVENT_MAX_SIZE32;
+
+        int32_t result = ring_buf_item_get(ctx->events, &event.id, &event.value,
+                                           event.data, &event.size32);
+
+        if (result == 0) {
+            break;
+        }
+
+        if (result == -1) {
+            return 0;
+        }
+
+        /* drop events that are too big or failed their integrity check */
+        if (result == -2) {
+            (void) ring_buf_item_get(ctx->events, &event.id, &event.value, NULL,
+                                     &event.size32);
+        }
+        LOG_ERR("Dropping invalid event");
+    }
+
+    SMF_TRACE_POINT(ctx, SMF_TRACE_EVENT, NULL, ctx->current, event.id);
+
+    /* the run actions handle the event as in any other iteration */
+    ctx->event = &event;
+
+    int32_t result = smf_run_state(ctx);
+
+    ctx->event = NULL;
+
+    return result;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SMF_EVENT_H
+#define SMF_EVENT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "smf.h"
+#include "ring_buffer.h"
+
+/**
+ * @brief Maximum payload of an event, in 32-bit words, see
+ *        @ref smf_post_event.
+ */
+#ifndef SMF_EVENT_MAX_SIZE32
+#define SMF_EVENT_MAX_SIZE32 4
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Event delivered to a state machine by @ref smf_dispatch. */
+struct smf_event {
+    /** Event identifier (application specific) */
+    uint16_t id;
+
+    /** Event integer value (application specific) */
+    uint8_t value;
+
+    /** Number of 32-bit words of payload */
+    uint8_t size32;
+
+    /** Payload */
+    uint32_t data[SMF_EVENT_MAX_SIZE32];
+};
+
+/**
+ * @brief Gives a state machine an event queue.
+ *
+ * State machines without a queue do not need this module, nor the ring
+ * buffer it is built on.
+ *
+ * @param ctx   State machine context
+ * @param queue Ring buffer initialized in item mode (see ring_buf_item_init),
+ *              or NULL to stop using a queue
+ */
+void smf_set_event_queue(struct smf_ctx *ctx, struct ring_buf *queue);
+
+/**
+ * @brief Posts an event to a state machine.
+ *
+ * The event is queued and delivered later by @ref smf_dispatch, so this
+ * function may be called from any action of the state machine itself.
+ *
+ * @warning
+ * The queue is a single-producer ring buffer: callers posting from several
+ * threads must serialize their calls.
+ *
+ * @param ctx    State machine context
+ * @param id     Event identifier
+ * @param value  Event integer value
+ * @param data   Event payload, or NULL if @p size32 is 0
+ * @param size32 Payload size in 32-bit words, up to SMF_EVENT_MAX_SIZE32
+ *
+ * @retval 0 Event was queued.
+ * @retval -1 The state machine has no queue, or the payload is too big.
+ * @retval -2 The queue is full.
+ */
+int32_t smf_post_event(struct smf_ctx *ctx, uint16_t id, uint8_t value,
+                       const uint32_t *data, uint8_t size32);
+
+/**
+ * @brief Checks whether a state machine has events waiting to be
+ *        dispatched.
+ *
+ * @param ctx State machine context
+ * @return true if @ref smf_dispatch would deliver an event
+ */
+bool smf_event_pending(struct smf_ctx *ctx);
+
+/**
+ * @brief Returns the event being dispatched.
+ *
+ * @param ctx State machine context
+ * @return The event, valid until the action returns, or NULL when the
+ *         action does not run from @ref smf_dispatch.
+ */
+const struct smf_event *smf_get_event(const struct smf_ctx *ctx);
+
+/**
+ * @brief Delivers the oldest queued event to a state machine.
+ *
+ * The event runs to completion: the run action of the current state and
+ * then those of its ancestors handle it, as in @ref smf_run_state, until a
+ * state calls @ref smf_set_handled or @ref smf_set_state. Events posted
+ * meanwhile are queued and delivered by later calls. Nothing runs when the
+ * queue is empty, so idle state machines cost a single check.
+ *
+ * @param ctx  State machine context
+ * @return	   A non-zero value should terminate the state machine, as with
+ *			   @ref smf_run_state. 0 is also returned when no event was
+ *			   queued.
+ */
+int32_t smf_dispatch(struct smf_ctx *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SMF_EVENT_H */
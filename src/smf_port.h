@@ -18,4 +18,10 @@
  */
 void smf_port_log(const char *fmt, ...);
 
+/**
+ * @brief Logs an error of the state machine framework through
+ *        @ref smf_port_log.
+ */
+#define LOG_ERR(...) smf_port_log(__VA_ARGS__)
+
 #endif /* SMF_PORT_H */
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "smf_timer.h"
+
+#include <stddef.h>
+
+#define SMF_TIMER_SLOT_MASK (SMF_TIMER_SLOTS - 1u)
+
+
+static void wheel_insert(struct smf_timer_wheel *wheel, struct smf_timer *timer);
+static void wheel_remove(struct smf_timer *timer);
+static void wheel_cascade(struct smf_timer_wheel *wheel, uint32_t level);
+static void wheel_expire(struct smf_timer_wheel *wheel, struct smf_timer *timer);
+static void ctx_unlink(struct smf_timer *timer);
+
+
+void smf_timer_wheel_init(struct smf_timer_wheel *wheel, uint64_t now,
+                          smf_timer_notify notify, void *arg)
+{
+    for (uint32_t level = 0; level < SMF_TIMER_LEVELS; level++) {
+        for (uint32_t slot = 0; slot < SMF_TIMER_SLOTS; slot++) {
+            wheel->slots[level][slot] = NULL;
+        }
+    }
+
+    wheel->now = now;
+    wheel->notify = notify;
+    wheel->arg = arg;
+}
+
+uint32_t smf_timer_wheel_advance(struct smf_timer_wheel *wheel, uint64_t now)
+{
+    uint32_t expired = 0;
+
+    while (wheel->now < now) {
+        uint64_t tick = ++wheel->now;
+
+        /* a lower level wrapped: bring the timers of the next slot down */
+        for (uint32_t level = 1; level < SMF_TIMER_LEVELS; level++) {
+            if ((tick & ((UINT64_C(1) << (level * SMF_TIMER_SLOT_BITS)) - 1u)) != 0) {
+                break;
+            }
+
+            wheel_cascade(wheel, level);
+        }
+
+        struct smf_timer **slot = &wheel->slots[0][tick & SMF_TIMER_SLOT_MASK];
+
+        while (*slot != NULL) {
+            wheel_expire(wheel, *slot);
+            expired++;
+        }
+    }
+
+    return expired;
+}
+
+void smf_timer_init(struct smf_timer *timer, struct smf_timer_wheel *wheel, uint16_t event)
+{
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->ctx_next = NULL;
+    timer->ctx_pprev = NULL;
+    timer->wheel = wheel;
+    timer->ctx = NULL;
+    timer->state = NULL;
+    timer->expiry = 0;
+    timer->event = event;
+    timer->seq = 0;
+    timer->armed = false;
+}
+
+int32_t smf_timer_arm(struct smf_ctx *ctx, struct smf_timer *timer, uint32_t ticks)
+{
+    if (ticks == 0 || ticks > SMF_TIMER_MAX_TICKS) {
+        return -1;
+    }
+
+    smf_timer_cancel(timer);
+
+    timer->ctx = ctx;
+    timer->state = ctx->executing;
+    ctx->exit_hook = smf_timer_state_exit;
+    timer->expiry = timer->wheel->now + ticks;
+    timer->armed = true;
+
+    timer->ctx_next = ctx->timers;
+    timer->ctx_pprev = &ctx->timers;
+    if (ctx->timers != NULL) {
+        ctx->timers->ctx_pprev = &timer->ctx_next;
+    }
+    ctx->timers = timer;
+
+    wheel_insert(timer->wheel, timer);
+
+    return 0;
+}
+
+void smf_timer_cancel(struct smf_timer *timer)
+{
+    if (timer->armed) {
+        wheel_remove(timer);
+        timer->armed = false;
+    }
+
+    ctx_unlink(timer);
+
+    /* an expiry event still queued is now stale */
+    timer->seq++;
+}
+
+bool smf_timer_is_expiry(const struct smf_timer *timer, const struct smf_event *event)
+{
+    return event != NULL && !timer->armed && timer->ctx_pprev != NULL &&
+           event->id == timer->event && event->size32 == 1 && event->data[0] == timer->seq;
+}
+
+void smf_timer_state_exit(struct smf_ctx *ctx, const struct smf_state *state)
+{
+    struct smf_timer *timer = ctx->timers;
+
+    while (timer != NULL) {
+        struct smf_timer *next = timer->ctx_next;
+
+        if (state == NULL || timer->state == state) {
+            smf_timer_cancel(timer);
+        }
+
+        timer = next;
+    }
+}
+
+/*
+ * Link a timer in the slot of its expiry tick, at the lowest level where
+ * that tick is less than a whole level ahead.
+ */
+static void wheel_insert(struct smf_timer_wheel *wheel, struct smf_timer *timer)
+{
+    uint64_t delta = timer->expiry - wheel->now;
+    uint32_t level = 0;
+
+    while (level < SMF_TIMER_LEVELS - 1u &&
+           delta >= (UINT64_C(1) << ((level + 1u) * SMF_TIMER_SLOT_BITS))) {
+        level++;
+    }
+
+    uint32_t slot = (uint32_t) (timer->expiry >> (level * SMF_TIMER_SLOT_BITS)) &
+                    SMF_TIMER_SLOT_MASK;
+    struct smf_timer **head = &wheel->slots[level][slot];
+
+    timer->next = *head;
+    timer->pprev = head;
+    if (*head != NULL) {
+        (*head)->pprev = &timer->next;
+    }
+    *head = timer;
+}
+
+static void wheel_remove(struct smf_timer *timer)
+{
+    *timer->pprev = timer->next;
+    if (timer->next != NULL) {
+        timer->next->pprev = timer->pprev;
+    }
+
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+/* Move the timers of the current slot of a level to lower levels. */
+static void wheel_cascade(struct smf_timer_wheel *wheel, uint32_t level)
+{
+    uint32_t slot = (uint32_t) (wheel->now >> (level * SMF_TIMER_SLOT_BITS)) &
+                    SMF_TIMER_SLOT_MASK;
+    struct smf_timer *timer = wheel->slots[level][slot];
+
+    wheel->slots[level][slot] = NULL;
+
+    while (timer != NULL) {
+        struct smf_timer *next = timer->next;
+
+        wheel_insert(wheel, timer);
+        timer = next;
+    }
+}
+
+static void wheel_expire(struct smf_timer_wheel *wheel, struct smf_timer *timer)
+{
+    wheel_remove(timer);
+    timer->armed = false;
+
+    /* the timer stays linked to its state, so its expiry can be recognized */
+    if (smf_post_event(timer->ctx, timer->event, 0, &timer->seq, 1) != 0) {
+        LOG_ERR("Dropping expiry of timer %p", (void *) timer);
+    }
+
+    if (wheel->notify != NULL) {
+        wheel->notify(timer->ctx, wheel->arg);
+    }
+}
+
+static void ctx_unlink(struct smf_timer *timer)
+{
+    if (timer->ctx_pprev == NULL) {
+        return;
+    }
+
+    *timer->ctx_pprev = timer->ctx_next;
+    if (timer->ctx_next != NULL) {
+        timer->ctx_next->ctx_pprev = timer->ctx_pprev;
+    }
+
+    timer->ctx_next = NULL;
+    timer->ctx_pprev = NULL;
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SMF_TIMER_H
+#define SMF_TIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "smf.h"
+#include "smf_event.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @cond INTERNAL_HIDDEN */
+#define SMF_TIMER_LEVELS    4u
+#define SMF_TIMER_SLOT_BITS 6u
+#define SMF_TIMER_SLOTS     (1u << SMF_TIMER_SLOT_BITS)
+
+#if SMF_EVENT_MAX_SIZE32 < 1
+#error "SMF timers need SMF_EVENT_MAX_SIZE32 of at least 1"
+#endif
+/** @endcond */
+
+/**
+ * @brief Longest timeout of a timer, in ticks.
+ */
+#define SMF_TIMER_MAX_TICKS ((1u << (SMF_TIMER_LEVELS * SMF_TIMER_SLOT_BITS)) - 1u)
+
+/**
+ * @brief Function called when a timer expired, after its event was posted.
+ *
+ * Typically wakes the state machine, e.g. with @ref smf_engine_wake.
+ *
+ * @param ctx State machine context of the timer.
+ * @param arg Argument given to @ref smf_timer_wheel_init.
+ */
+typedef void (*smf_timer_notify)(struct smf_ctx *ctx, void *arg);
+
+/**
+ * @brief A timeout of a state machine, owned by the state that armed it.
+ */
+struct smf_timer {
+    /** @cond INTERNAL_HIDDEN */
+    struct smf_timer *next;
+    struct smf_timer **pprev;
+    struct smf_timer *ctx_next;
+    struct smf_timer **ctx_pprev;
+    struct smf_timer_wheel *wheel;
+    struct smf_ctx *ctx;
+    const struct smf_state *state;
+    uint64_t expiry;
+    uint32_t seq;
+    uint16_t event;
+    bool armed;
+    /** @endcond */
+};
+
+/**
+ * @brief A hierarchical timing wheel driving the timers of state machines.
+ *
+ * Each of the SMF_TIMER_LEVELS levels has SMF_TIMER_SLOTS slots, each slot
+ * covering as many ticks as a whole lower level. A timer is linked in the
+ * slot of its expiry tick at the lowest level that reaches it, and moved
+ * down a level whenever the lower level wraps. Arming and cancelling are
+ * O(1), and each timer moves at most SMF_TIMER_LEVELS - 1 times before it
+ * expires, whatever the number of timers.
+ *
+ * The wheel, its timers and their state machines must be driven from a
+ * single thread.
+ */
+struct smf_timer_wheel {
+    /** @cond INTERNAL_HIDDEN */
+    struct smf_timer *slots[SMF_TIMER_LEVELS][SMF_TIMER_SLOTS];
+    uint64_t now;
+    smf_timer_notify notify;
+    void *arg;
+    /** @endcond */
+};
+
+/**
+ * @brief Initialize a timing wheel without timers.
+ *
+ * @param wheel Address of timing wheel.
+ * @param now Current tick, in any unit the caller keeps using.
+ * @param notify Function called for each expired timer, or NULL.
+ * @param arg Argument passed to @p notify.
+ */
+void smf_timer_wheel_init(struct smf_timer_wheel *wheel, uint64_t now,
+                          smf_timer_notify notify, void *arg);
+
+/**
+ * @brief Move a timing wheel to a later tick, expiring timers on the way.
+ *
+ * The event of each expired timer is posted to its state machine (see
+ * @ref smf_post_event), in expiry order.
+ *
+ * @param wheel Address of timing wheel.
+ * @param now Current tick. Nothing happens if it is not later than the
+ *            last one.
+ *
+ * @return Number of timers that expired.
+ */
+uint32_t smf_timer_wheel_advance(struct smf_timer_wheel *wheel, uint64_t now);
+
+/**
+ * @brief Initialize a timer.
+ *
+ * @param timer Address of timer.
+ * @param wheel Timing wheel running the timer.
+ * @param event Identifier of the event posted when the timer expires.
+ */
+void smf_timer_init(struct smf_timer *timer, struct smf_timer_wheel *wheel, uint16_t event);
+
+/**
+ * @brief Arm a timer on behalf of the executing state.
+ *
+ * Usually called from an entry action. The timer is cancelled when the
+ * state that armed it exits, including on self-transitions, and when the
+ * state machine restarts or terminates. Arming an armed timer restarts it.
+ *
+ * The timers take over the exit hook of the state machine, see
+ * smf_ctx::exit_hook.
+ *
+ * @param ctx State machine context, which needs an event queue.
+ * @param timer Address of timer.
+ * @param ticks Timeout in ticks, from 1 to SMF_TIMER_MAX_TICKS.
+ *
+ * @retval 0 Timer was armed.
+ * @retval -1 @a ticks is out of range.
+ */
+int32_t smf_timer_arm(struct smf_ctx *ctx, struct smf_timer *timer, uint32_t ticks);
+
+/**
+ * @brief Cancel a timer.
+ *
+ * An expiry event already queued for the timer becomes stale, see
+ * @ref smf_timer_is_expiry.
+ *
+ * @param timer Address of timer.
+ */
+void smf_timer_cancel(struct smf_timer *timer);
+
+/**
+ * @brief Check whether an event is the current expiry of a timer.
+ *
+ * Expiry events are queued: one may be dispatched after the timer was
+ * cancelled or restarted, e.g. after its state exited. Actions should use
+ * this function rather than compare event identifiers.
+ *
+ * Expiry events carry a 32-bit sequence number as their payload, so a stale
+ * expiry is only mistaken for the current one after 2^32 cancellations
+ * while it is queued.
+ *
+ * @param timer Address of timer.
+ * @param event Event being dispatched, see @ref smf_get_event.
+ *
+ * @return true if @p event is the expiry of the timer since it was last
+ *         armed.
+ */
+bool smf_timer_is_expiry(const struct smf_timer *timer, const struct smf_event *event);
+
+/** @cond INTERNAL_HIDDEN */
+/* Cancel the timers armed by a state of a state machine as it exits, or all
+ * its timers when state is NULL. Exit hook of the state machine. */
+void smf_timer_state_exit(struct smf_ctx *ctx, const struct smf_state *state);
+/** @endcond */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SMF_TIMER_H */
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include "smf_trace.h"
+#include "ring_buffer_io.h"
+
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SMF_TRACE_RECORD_SIZE ((uint32_t) sizeof(struct smf_trace_record))
+
+#define SMF_TRACE_CALIBRATION_NS 10000000u
+
+
+static _Thread_local struct smf_trace_buffer *thread_buffer;
+
+static bool record_put(struct smf_trace_buffer *buf, const struct smf_trace_record *record);
+static uint64_t monotonic_ns(void);
+static uint32_t timestamp_khz_get(void);
+static int32_t write_all(int fd, const void *data, size_t size);
+
+
+void smf_trace_thread_init(struct smf_trace_buffer *buf, uint16_t thread,
+                           uint8_t *storage, uint32_t size)
+{
+    /* records never straddle the end of the storage */
+    ring_buf_init(&buf->rb, size - size % SMF_TRACE_RECORD_SIZE, storage);
+    buf->dropped = 0;
+    buf->thread = thread;
+
+    thread_buffer = buf;
+}
+
+void smf_trace_thread_stop(void)
+{
+    thread_buffer = NULL;
+}
+
+void smf_trace_record(const struct smf_ctx *ctx, uint16_t kind, const struct smf_state *from,
+                      const struct smf_state *to, uint32_t arg)
+{
+    struct smf_trace_buffer *buf = thread_buffer;
+
+    if (buf == NULL) {
+        return;
+    }
+
+    struct smf_trace_record record = {
+        .timestamp = SMF_TRACE_TIMESTAMP(),
+        .ctx = (uintptr_t) ctx,
+        .from = (uintptr_t) from,
+        .to = (uintptr_t) to,
+        .kind = kind,
+        .thread = buf->thread,
+        .arg = arg,
+    };
+
+    if (buf->dropped != 0) {
+        /* mark the gap first, it needs room for both records */
+        if (ring_buf_space_get(&buf->rb) < 2u * SMF_TRACE_RECORD_SIZE) {
+            buf->dropped++;
+            return;
+        }
+
+        struct smf_trace_record gap = {
+            .timestamp = record.timestamp,
+            .kind = SMF_TRACE_DROPPED,
+            .thread = buf->thread,
+            .arg = buf->dropped,
+        };
+
+        (void) record_put(buf, &gap);
+        buf->dropped = 0;
+    }
+
+    if (!record_put(buf, &record)) {
+        buf->dropped++;
+    }
+}
+
+uint64_t smf_trace_timestamp(void)
+{
+#if defined(__x86_64__)
+    return __builtin_ia32_rdtsc();
+#else
+    return monotonic_ns();
+#endif
+}
+
+int32_t smf_trace_header_write(int fd, const struct smf_state *states,
+                               const char *const names[], uint32_t count)
+{
+    struct smf_trace_file_header header = {
+        .magic = SMF_TRACE_MAGIC,
+        .version = SMF_TRACE_VERSION,
+        .record_size = SMF_TRACE_RECORD_SIZE,
+        .name_count = count,
+        .timestamp_khz = timestamp_khz_get(),
+    };
+
+    if (write_all(fd, &header, sizeof(header)) != 0) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t address = (uintptr_t) &states[i];
+        uint32_t length = (uint32_t) strlen(names[i]);
+
+        if (write_all(fd, &address, sizeof(address)) != 0 ||
+            write_all(fd, &length, sizeof(length)) != 0 ||
+            write_all(fd, names[i], length) != 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+ssize_t smf_trace_drain(struct smf_trace_buffer *buf, int fd)
+{
+    uint32_t size = ring_buf_size_get(&buf->rb);
+
+    size -= size % SMF_TRACE_RECORD_SIZE;
+
+    /* keep going after short writes, so records from other buffers are
+     * never interleaved with a partial one */
+    for (uint32_t left = size; left > 0; ) {
+        ssize_t written = ring_buf_write_fd(&buf->rb, fd, left);
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+
+        if (written == 0) {
+            size -= left;
+            break;
+        }
+
+        left -= (uint32_t) written;
+    }
+
+    return (ssize_t) (size / SMF_TRACE_RECORD_SIZE);
+}
+
+static bool record_put(struct smf_trace_buffer *buf, const struct smf_trace_record *record)
+{
+    uint8_t *dst;
+
+    if (ring_buf_put_claim(&buf->rb, &dst, SMF_TRACE_RECORD_SIZE) != SMF_TRACE_RECORD_SIZE) {
+        ring_buf_put_finish(&buf->rb, 0);
+        return false;
+    }
+
+    memcpy(dst, record, SMF_TRACE_RECORD_SIZE);
+    ring_buf_put_finish(&buf->rb, SMF_TRACE_RECORD_SIZE);
+
+    return true;
+}
+
+static uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+/* Rate of SMF_TRACE_TIMESTAMP(), measured against the monotonic clock. */
+static uint32_t timestamp_khz_get(void)
+{
+    struct timespec delay = { .tv_sec = 0, .tv_nsec = SMF_TRACE_CALIBRATION_NS };
+    uint64_t start_ns = monotonic_ns();
+    uint64_t start = SMF_TRACE_TIMESTAMP();
+
+    nanosleep(&delay, NULL);
+
+    uint64_t ticks = SMF_TRACE_TIMESTAMP() - start;
+    uint64_t ns = monotonic_ns() - start_ns;
+
+    return (ns != 0) ? (uint32_t) ((ticks * 1000000u) / ns) : 0;
+}
+
+static int32_t write_all(int fd, const void *data, size_t size)
+{
+    const uint8_t *src = data;
+
+    while (size > 0) {
+        ssize_t written = write(fd, src, size);
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+
+        src += written;
+        size -= (size_t) written;
+    }
+
+    return 0;
+}
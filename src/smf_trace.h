@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SMF_TRACE_H
+#define SMF_TRACE_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "smf.h"
+#include "ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @cond INTERNAL_HIDDEN */
+/*
+ * Define SMF_TRACE (for every translation unit) to have the state machine
+ * framework record its transitions and actions, see smf_trace_thread_init().
+ * Without it the trace points compile to nothing.
+ */
+#ifdef SMF_TRACE
+#define SMF_TRACE_POINT(ctx, kind, from, to, arg) smf_trace_record(ctx, kind, from, to, arg)
+#else
+#define SMF_TRACE_POINT(ctx, kind, from, to, arg)
+#endif
+
+/* Source of the record timestamps, may be overridden for every translation
+ * unit. Its rate is measured by smf_trace_header_write(). */
+#ifndef SMF_TRACE_TIMESTAMP
+#define SMF_TRACE_TIMESTAMP() smf_trace_timestamp()
+#endif
+
+#define SMF_TRACE_MAGIC   0x54464d53u /* "SMFT" */
+#define SMF_TRACE_VERSION 1u
+/** @endcond */
+
+/**
+ * @name Kinds of trace records
+ * @{
+ */
+/** smf_set_initial or smf_restart: @a to is the initial leaf state */
+#define SMF_TRACE_INITIAL    0u
+/** smf_set_state: @a from is the current state, @a to the requested one */
+#define SMF_TRACE_TRANSITION 1u
+/** Entry action of state @a to */
+#define SMF_TRACE_ENTRY      2u
+/** Exit action of state @a from */
+#define SMF_TRACE_EXIT       3u
+/** smf_dispatch: @a to is the current state, @a arg the event identifier */
+#define SMF_TRACE_EVENT      4u
+/** smf_set_terminate: @a arg is the termination value */
+#define SMF_TRACE_TERMINATE  5u
+/** Records were lost because the buffer was full: @a arg is their number */
+#define SMF_TRACE_DROPPED    6u
+/** @} */
+
+/**
+ * @brief A trace record, as stored in trace buffers and trace files.
+ *
+ * State machine contexts and states are identified by their address.
+ */
+struct smf_trace_record {
+    /** Timestamp, in ticks of SMF_TRACE_TIMESTAMP() */
+    uint64_t timestamp;
+
+    /** Address of the state machine context */
+    uint64_t ctx;
+
+    /** Address of the source state, or 0 */
+    uint64_t from;
+
+    /** Address of the destination state, or 0 */
+    uint64_t to;
+
+    /** Kind of record, SMF_TRACE_INITIAL to SMF_TRACE_DROPPED */
+    uint16_t kind;
+
+    /** Identifier of the thread that recorded it */
+    uint16_t thread;
+
+    /** Argument, depending on the kind of record */
+    uint32_t arg;
+};
+
+/**
+ * @brief Header of a trace file.
+ *
+ * It is followed by one entry per named state (its address as a 64-bit
+ * word, the 32-bit length of its name and the name without terminator),
+ * then by records up to the end of the file. Everything is in the byte
+ * order of the traced system.
+ */
+struct smf_trace_file_header {
+    /** SMF_TRACE_MAGIC */
+    uint32_t magic;
+
+    /** SMF_TRACE_VERSION */
+    uint16_t version;
+
+    /** Size of struct smf_trace_record */
+    uint16_t record_size;
+
+    /** Number of named states */
+    uint32_t name_count;
+
+    /** Rate of the record timestamps, in kHz */
+    uint32_t timestamp_khz;
+};
+
+/**
+ * @brief A per-thread buffer of trace records.
+ *
+ * The thread owning the buffer records into it; a single other thread may
+ * drain it to a file concurrently with @ref smf_trace_drain. When the
+ * buffer is full new records are dropped, and a SMF_TRACE_DROPPED record
+ * marks the gap once space is available again.
+ */
+struct smf_trace_buffer {
+    /** @cond INTERNAL_HIDDEN */
+    struct ring_buf rb;
+    uint32_t dropped;
+    uint16_t thread;
+    /** @endcond */
+};
+
+/**
+ * @brief Initialize a trace buffer and make it the one of the calling
+ *        thread.
+ *
+ * State machines run by threads without a trace buffer are not traced.
+ *
+ * @param buf Address of trace buffer.
+ * @param thread Identifier of the thread, stored in its records.
+ * @param storage Storage of the buffer, 8-byte aligned.
+ * @param size Size of @p storage in bytes; only a whole number of records
+ *             is used.
+ */
+void smf_trace_thread_init(struct smf_trace_buffer *buf, uint16_t thread,
+                           uint8_t *storage, uint32_t size);
+
+/**
+ * @brief Stop tracing the state machines run by the calling thread.
+ */
+void smf_trace_thread_stop(void);
+
+/**
+ * @brief Record an event in the trace buffer of the calling thread.
+ *
+ * Called by the trace points of the state machine framework.
+ *
+ * @param ctx State machine context.
+ * @param kind Kind of record.
+ * @param from Source state, or NULL.
+ * @param to Destination state, or NULL.
+ * @param arg Argument, depending on @p kind.
+ */
+void smf_trace_record(const struct smf_ctx *ctx, uint16_t kind, const struct smf_state *from,
+                      const struct smf_state *to, uint32_t arg);
+
+/**
+ * @brief Default timestamp of trace records.
+ *
+ * Reads the time stamp counter on x86-64, which costs a fraction of a
+ * clock_gettime() call, and the monotonic clock elsewhere.
+ *
+ * @return Timestamp in ticks: CPU cycles on x86-64, else nanoseconds.
+ */
+uint64_t smf_trace_timestamp(void);
+
+/**
+ * @brief Write the header of a trace file.
+ *
+ * The header names the states, so the decoder can resolve the addresses
+ * found in records, and holds the rate of the timestamps, measured against
+ * the monotonic clock for 10 ms. It is followed by the records written
+ * with @ref smf_trace_drain.
+ *
+ * @param fd File descriptor of the trace file.
+ * @param states Array of states of the state machines.
+ * @param names Name of each state.
+ * @param count Number of states.
+ *
+ * @retval 0 Header was written.
+ * @retval -1 Write error, with errno set by write().
+ */
+int32_t smf_trace_header_write(int fd, const struct smf_state *states,
+                               const char *const names[], uint32_t count);
+
+/**
+ * @brief Move the records of a trace buffer to a trace file.
+ *
+ * Only whole records are written. Buffers of several threads may be
+ * drained to the same file, one at a time.
+ *
+ * @param buf Address of trace buffer.
+ * @param fd File descriptor of the trace file.
+ *
+ * @return Number of records written, or -1 on error, with errno set by
+ *         writev().
+ */
+ssize_t smf_trace_drain(struct smf_trace_buffer *buf, int fd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SMF_TRACE_H */
@@ -278,6 +278,46 @@ void test_crc_ieee_802_3_case_5_fast(void)
     TEST_ASSERT_EQUAL_HEX32(0xffffffff, crc);
 }
 
+/**
+ * Test case IEEE 802.3 CRC (copy)
+ * 
+ * Description:
+ * - This test ensures that the IEEE 802.3 CRC computed while copying
+ *   matches the expected CRC and that the data is copied.
+ * 
+ * Steps:
+ * - Initialize the CRC context with crc_ieee_802_3_init.
+ * - Call crc_ieee_802_3_update_copy with input bytes, in two parts.
+ * - Repeat with the 9 bytes "123456789" in one call.
+ * - Finalize the CRC with crc_ieee_802_3_final.
+ *  
+ * Expected result:
+ * - Check if the result is correct and the copy matches the input.
+ */
+void test_crc_ieee_802_3_copy(void)
+{
+    struct crc_ieee_802_3_ctx ctx;
+    uint8_t data[] = {0x12, 0x34, 0x56, 0x78, 0x90, 0xab, 0xcd, 0xef};
+    uint8_t copy[sizeof(data)] = {0};
+
+    crc_ieee_802_3_init(&ctx);
+    crc_ieee_802_3_update_copy(&ctx, copy, data, 4);
+    crc_ieee_802_3_update_copy(&ctx, &copy[4], &data[4], 4);
+    uint32_t crc = crc_ieee_802_3_final(&ctx);
+
+    TEST_ASSERT_EQUAL_HEX32(0x32692d55, crc);
+    TEST_ASSERT_EQUAL_MEMORY(data, copy, sizeof(data));
+
+    uint8_t check[9];
+
+    crc_ieee_802_3_init(&ctx);
+    crc_ieee_802_3_update_copy(&ctx, check, "123456789", sizeof(check));
+    crc = crc_ieee_802_3_final(&ctx);
+
+    TEST_ASSERT_EQUAL_HEX32(0xcbf43926, crc);
+    TEST_ASSERT_EQUAL_MEMORY("123456789", check, sizeof(check));
+}
+
 /**
  * Test case 1 Modbus
  * 
@@ -10,6 +10,9 @@
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <sched.h>
 
 
 /**
@@ -1192,6 +1195,198 @@ void test_stress_test_with_randomized_operations(void)
     TEST_ASSERT_EQUAL_UINT32(0, ring_buf_size_get(&rb));
 }
 
+/**
+ * Overwrite the oldest bytes when full
+ *
+ * Description:
+ * - This test verifies that ring_buf_put_overwrite makes room by dropping
+ *   the oldest bytes and counts them.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 8 bytes.
+ * - Write 6 bytes, then write 5 more bytes with ring_buf_put_overwrite.
+ * - Read the whole ring buffer.
+ *
+ * Expected result:
+ * - ring_buf_put_overwrite returns 5 and 3 bytes are reported dropped, but
+ *   no items.
+ * - The ring buffer holds the last 8 bytes written, in order.
+ */
+void test_put_overwrite_drops_oldest_bytes(void)
+{
+    struct ring_buf rb;
+    uint8_t buff[8];
+    uint8_t data[11] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    uint8_t read[8] = {0};
+
+    ring_buf_init(&rb, sizeof(buff), buff);
+
+    TEST_ASSERT_EQUAL_UINT32(6, ring_buf_put_overwrite(&rb, data, 6));
+    TEST_ASSERT_EQUAL_UINT32(0, ring_buf_dropped_get(&rb));
+    TEST_ASSERT_EQUAL_UINT32(5, ring_buf_put_overwrite(&rb, &data[6], 5));
+    TEST_ASSERT_EQUAL_UINT32(3, ring_buf_dropped_get(&rb));
+    TEST_ASSERT_EQUAL_UINT32(0, ring_buf_item_dropped_get(&rb));
+
+    TEST_ASSERT_EQUAL_UINT32(8, ring_buf_get(&rb, read, sizeof(read)));
+    TEST_ASSERT_EQUAL_MEMORY(&data[3], read, sizeof(read));
+}
+
+/**
+ * Overwrite with more than capacity
+ *
+ * Description:
+ * - This test verifies that writing more than the capacity keeps only the
+ *   newest bytes of the input.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 4 bytes and write 2 bytes.
+ * - Write 6 bytes with ring_buf_put_overwrite.
+ * - Read the whole ring buffer.
+ *
+ * Expected result:
+ * - ring_buf_put_overwrite returns 4 and 4 bytes are reported dropped (the
+ *   2 stored bytes and the first 2 bytes of the input).
+ * - The ring buffer holds the last 4 bytes of the input.
+ */
+void test_put_overwrite_more_than_capacity(void)
+{
+    struct ring_buf rb;
+    uint8_t buff[4];
+    uint8_t data[6] = {1, 2, 3, 4, 5, 6};
+    uint8_t read[4] = {0};
+
+    ring_buf_init(&rb, sizeof(buff), buff);
+
+    TEST_ASSERT_EQUAL_UINT32(2, ring_buf_put(&rb, data, 2));
+    TEST_ASSERT_EQUAL_UINT32(4, ring_buf_put_overwrite(&rb, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT32(4, ring_buf_dropped_get(&rb));
+
+    TEST_ASSERT_EQUAL_UINT32(4, ring_buf_get(&rb, read, sizeof(read)));
+    TEST_ASSERT_EQUAL_MEMORY(&data[2], read, sizeof(read));
+
+    ring_buf_reset(&rb);
+    TEST_ASSERT_EQUAL_UINT32(0, ring_buf_dropped_get(&rb));
+}
+
+/**
+ * Detect a claim overrun by an overwriting put
+ *
+ * Description:
+ * - This test verifies that, with ring_buf_overwrite_enable, a drop made by
+ *   ring_buf_put_overwrite while data is claimed is reported to the
+ *   consumer, which then resumes from the oldest data left.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 8 bytes, enable concurrent overwrites and
+ *   write 6 bytes.
+ * - Claim 4 bytes, then write 5 bytes with ring_buf_put_overwrite.
+ * - Finish the claim, then read the whole ring buffer.
+ *
+ * Expected result:
+ * - 3 bytes are reported dropped and the finish returns -2.
+ * - The read returns the last 8 bytes written, in order, and the ring
+ *   buffer is empty afterwards.
+ */
+void test_put_overwrite_concurrent_claim_overrun(void)
+{
+    struct ring_buf rb;
+    uint8_t buff[8];
+    uint8_t data[11] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    uint8_t read[8] = {0};
+    uint8_t *src;
+
+    ring_buf_init(&rb, sizeof(buff), buff);
+    ring_buf_overwrite_enable(&rb);
+
+    TEST_ASSERT_EQUAL_UINT32(6, ring_buf_put_overwrite(&rb, data, 6));
+    TEST_ASSERT_EQUAL_UINT32(4, ring_buf_get_claim(&rb, &src, 4));
+    TEST_ASSERT_EQUAL_UINT32(5, ring_buf_put_overwrite(&rb, &data[6], 5));
+    TEST_ASSERT_EQUAL_UINT32(3, ring_buf_dropped_get(&rb));
+    TEST_ASSERT_EQUAL_INT32(-2, ring_buf_get_finish(&rb, 4));
+
+    TEST_ASSERT_EQUAL_UINT32(8, ring_buf_get(&rb, read, sizeof(read)));
+    TEST_ASSERT_EQUAL_MEMORY(&data[3], read, sizeof(read));
+    TEST_ASSERT_TRUE(ring_buf_is_empty(&rb));
+}
+
+/**
+ * Find bytes across the wrap point
+ *
+ * Description:
+ * - This test verifies that ring_buf_find_byte searches the readable data in
+ *   place, on both sides of the wrap point, and that the offset it returns
+ *   delimits a frame which can be read directly.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 8 bytes and move its read position to 5.
+ * - Write "ab\ncd\nxy" (wrapping after 3 bytes).
+ * - Search '\n' from 0, then from past the first match, then 'z'.
+ * - Read the first frame.
+ *
+ * Expected result:
+ * - '\n' is found at offsets 2 and 5, 'z' is not found (-1).
+ * - The frame read is "ab\n" and the next search finds '\n' at offset 2.
+ */
+void test_find_byte_across_wrap(void)
+{
+    struct ring_buf rb;
+    uint8_t buff[8];
+    uint8_t frame[3];
+
+    ring_buf_init(&rb, sizeof(buff), buff);
+    TEST_ASSERT_EQUAL_UINT32(5, ring_buf_put(&rb, (const uint8_t *) "-----", 5));
+    TEST_ASSERT_EQUAL_UINT32(5, ring_buf_get(&rb, NULL, 5));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_find_byte(&rb, '-', 0));
+
+    TEST_ASSERT_EQUAL_UINT32(8, ring_buf_put(&rb, (const uint8_t *) "ab\ncd\nxy", 8));
+
+    TEST_ASSERT_EQUAL_INT32(2, ring_buf_find_byte(&rb, '\n', 0));
+    TEST_ASSERT_EQUAL_INT32(5, ring_buf_find_byte(&rb, '\n', 3));
+    TEST_ASSERT_EQUAL_INT32(6, ring_buf_find_byte(&rb, 'x', 6));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_find_byte(&rb, 'z', 0));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_find_byte(&rb, 'a', 9));
+
+    TEST_ASSERT_EQUAL_UINT32(3, ring_buf_get(&rb, frame, 3));
+    TEST_ASSERT_EQUAL_MEMORY("ab\n", frame, 3);
+    TEST_ASSERT_EQUAL_INT32(2, ring_buf_find_byte(&rb, '\n', 0));
+}
+
+/**
+ * Find sequences across the wrap point
+ *
+ * Description:
+ * - This test verifies that ring_buf_find_seq finds sequences lying on
+ *   either side of the wrap point or spanning it, and skips partial matches.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 8 bytes and move its read position to 6.
+ * - Write "SxSYNCSY" (wrapping after 2 bytes).
+ * - Search "SYNC", "CS", "SY" from 1, "SYNCX" and the empty sequence.
+ *
+ * Expected result:
+ * - "SYNC" is found at offset 2 (spanning the wrap point), "CS" at 5, "SY"
+ *   from 3 at 6; "SYNCX" is not found; the empty sequence is found at the
+ *   start offset.
+ */
+void test_find_seq_across_wrap(void)
+{
+    struct ring_buf rb;
+    uint8_t buff[8];
+
+    ring_buf_init(&rb, sizeof(buff), buff);
+    TEST_ASSERT_EQUAL_UINT32(6, ring_buf_put(&rb, (const uint8_t *) "------", 6));
+    TEST_ASSERT_EQUAL_UINT32(6, ring_buf_get(&rb, NULL, 6));
+
+    TEST_ASSERT_EQUAL_UINT32(8, ring_buf_put(&rb, (const uint8_t *) "SxSYNCSY", 8));
+
+    TEST_ASSERT_EQUAL_INT32(2, ring_buf_find_seq(&rb, (const uint8_t *) "SYNC", 4, 0));
+    TEST_ASSERT_EQUAL_INT32(5, ring_buf_find_seq(&rb, (const uint8_t *) "CS", 2, 0));
+    TEST_ASSERT_EQUAL_INT32(6, ring_buf_find_seq(&rb, (const uint8_t *) "SY", 2, 3));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_find_seq(&rb, (const uint8_t *) "SYNCX", 5, 0));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_find_seq(&rb, (const uint8_t *) "SY", 2, 7));
+    TEST_ASSERT_EQUAL_INT32(3, ring_buf_find_seq(&rb, (const uint8_t *) "", 0, 3));
+}
+
 /**
  * Test cases for item mode functions.
  */
@@ -1391,3 +1586,992 @@ void test_stress_test_with_randomized_operations_for_item_mode(void)
     TEST_ASSERT_EQUAL_UINT8(9, read_len);
     TEST_ASSERT_EQUAL_MEMORY(data_2, read, sizeof(data_2));
 }
+
+
+/**
+ * Overwrite the oldest items when full for item mode
+ *
+ * Description:
+ * - This test verifies that ring_buf_item_put_overwrite drops whole items,
+ *   oldest first, until the new item fits, and counts them.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 10 32-bit words.
+ * - Write 3 items of 2 32-bit words (9 words used).
+ * - Write 1 item of 4 32-bit words with ring_buf_item_put_overwrite.
+ * - Read all items.
+ * - Attempt to write an item of 10 32-bit words.
+ *
+ * Expected result:
+ * - The first two items are dropped and reported, the third one and the
+ *   new one are read back intact. No bytes are reported dropped.
+ * - The oversized item is rejected with -2.
+ */
+void test_item_put_overwrite_drops_oldest_items(void)
+{
+    struct ring_buf rb;
+    uint32_t buff[10];
+    uint32_t data[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    uint32_t read[4] = {0};
+    uint16_t type = 0;
+    uint8_t value = 0;
+    uint8_t read_len;
+
+    ring_buf_item_init(&rb, sizeof(buff) / sizeof(uint32_t), buff);
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put(&rb, 1, 10, &data[0], 2));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put(&rb, 2, 20, &data[2], 2));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put(&rb, 3, 30, &data[4], 2));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put_overwrite(&rb, 4, 40, &data[6], 4));
+    TEST_ASSERT_EQUAL_UINT32(2, ring_buf_item_dropped_get(&rb));
+    TEST_ASSERT_EQUAL_UINT32(0, ring_buf_dropped_get(&rb));
+
+    read_len = 4;
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_get(&rb, &type, &value, read, &read_len));
+    TEST_ASSERT_EQUAL_UINT16(3, type);
+    TEST_ASSERT_EQUAL_UINT8(30, value);
+    TEST_ASSERT_EQUAL_UINT8(2, read_len);
+    TEST_ASSERT_EQUAL_MEMORY(&data[4], read, 2 * sizeof(uint32_t));
+
+    read_len = 4;
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_get(&rb, &type, &value, read, &read_len));
+    TEST_ASSERT_EQUAL_UINT16(4, type);
+    TEST_ASSERT_EQUAL_UINT8(40, value);
+    TEST_ASSERT_EQUAL_UINT8(4, read_len);
+    TEST_ASSERT_EQUAL_MEMORY(&data[6], read, 4 * sizeof(uint32_t));
+
+    TEST_ASSERT_TRUE(ring_buf_is_empty(&rb));
+    TEST_ASSERT_EQUAL_INT32(-2, ring_buf_item_put_overwrite(&rb, 5, 50, data, 10));
+}
+
+/**
+ * Write and read checked items across the wrap point
+ *
+ * Description:
+ * - This test verifies that items of a ring buffer initialized with
+ *   ring_buf_item_checked_init take one more 32-bit word and are read back
+ *   intact, including when they wrap.
+ *
+ * Steps:
+ * - Initialize a checked ring buffer of 10 32-bit words.
+ * - Write 3 items of 2 32-bit words.
+ * - Repeat 20 times: read one item, then write one item.
+ *
+ * Expected result:
+ * - The third item does not fit (each item takes 4 words).
+ * - Every item is read back intact and in order.
+ */
+void test_item_checked_put_and_get(void)
+{
+    struct ring_buf rb;
+    uint32_t buff[10];
+    uint32_t data[2];
+    uint32_t read[2];
+    uint16_t type;
+    uint8_t value;
+    uint8_t read_len;
+
+    ring_buf_item_checked_init(&rb, sizeof(buff) / sizeof(uint32_t), buff);
+
+    for (uint32_t i = 0; i < 2; i++) {
+        data[0] = i;
+        data[1] = ~i;
+        TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put(&rb, (uint16_t) i, (uint8_t) i, data, 2));
+    }
+    TEST_ASSERT_EQUAL_INT32(-2, ring_buf_item_put(&rb, 2, 2, data, 2));
+
+    for (uint32_t i = 0; i < 20; i++) {
+        read_len = 2;
+        TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_get(&rb, &type, &value, read, &read_len));
+        TEST_ASSERT_EQUAL_UINT16(i, type);
+        TEST_ASSERT_EQUAL_UINT8(i, value);
+        TEST_ASSERT_EQUAL_UINT8(2, read_len);
+        TEST_ASSERT_EQUAL_UINT32(i, read[0]);
+        TEST_ASSERT_EQUAL_UINT32(~i, read[1]);
+
+        data[0] = i + 2;
+        data[1] = ~(i + 2);
+        TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put(&rb, (uint16_t) (i + 2), (uint8_t) (i + 2),
+                                                     data, 2));
+    }
+}
+
+/**
+ * Detect corrupted checked items
+ *
+ * Description:
+ * - This test verifies that ring_buf_item_get reports items of a checked
+ *   ring buffer whose storage was altered, and that reading goes on with
+ *   the next item.
+ *
+ * Steps:
+ * - Initialize a checked ring buffer of 16 32-bit words.
+ * - Write 3 items of 1 32-bit word.
+ * - Flip one bit in the data of the first item and one bit in the header of
+ *   the second item.
+ * - Read the first item, discard the second one, read the third one.
+ *
+ * Expected result:
+ * - The first two reads return -3, the third one returns 0 with intact data.
+ */
+void test_item_checked_detects_corruption(void)
+{
+    struct ring_buf rb;
+    uint32_t buff[16];
+    uint32_t data = 0x12345678;
+    uint32_t read;
+    uint16_t type;
+    uint8_t value;
+    uint8_t read_len;
+
+    ring_buf_item_checked_init(&rb, sizeof(buff) / sizeof(uint32_t), buff);
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put(&rb, 1, 1, &data, 1));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put(&rb, 2, 2, &data, 1));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put(&rb, 3, 3, &data, 1));
+
+    buff[1] ^= 0x100;
+    buff[3] ^= 0x10000;
+
+    read_len = 1;
+    TEST_ASSERT_EQUAL_INT32(-3, ring_buf_item_get(&rb, &type, &value, &read, &read_len));
+    TEST_ASSERT_EQUAL_UINT32(0x12345778, read);
+
+    read_len = 1;
+    TEST_ASSERT_EQUAL_INT32(-3, ring_buf_item_get(&rb, &type, &value, NULL, &read_len));
+
+    read_len = 1;
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_get(&rb, &type, &value, &read, &read_len));
+    TEST_ASSERT_EQUAL_UINT16(3, type);
+    TEST_ASSERT_EQUAL_UINT32(0x12345678, read);
+    TEST_ASSERT_TRUE(ring_buf_is_empty(&rb));
+}
+
+/**
+ * Iterate over items in place and consume up to a chosen one
+ *
+ * Description:
+ * - This test verifies that the item iterator returns the items in order,
+ *   with their data in place (split when it wraps), without removing them,
+ *   and that consuming removes the items returned so far only.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 10 32-bit words, write and read an item of
+ *   3 words.
+ * - Write items of 2, 4 and 0 words; the second one wraps.
+ * - Iterate over the items, then consume after the second one.
+ * - Iterate again, then read the last item.
+ *
+ * Expected result:
+ * - The iterator returns the 3 items, the second one in two segments of
+ *   8 bytes, then -1.
+ * - Consuming removes 2 items; the iterator restarts with the third one,
+ *   which ring_buf_item_get then returns.
+ */
+void test_item_iter_walks_in_place(void)
+{
+    struct ring_buf rb;
+    struct ring_buf_item_iter it;
+    struct ring_buf_item_view item;
+    uint32_t buff[10];
+    uint32_t data[4] = {1, 2, 3, 4};
+    uint16_t type;
+    uint8_t value;
+    uint8_t read_len = 0;
+
+    ring_buf_item_init(&rb, sizeof(buff) / sizeof(uint32_t), buff);
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put(&rb, 0, 0, data, 3));
+    read_len = 3;
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_get(&rb, &type, &value, NULL, &read_len));
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put(&rb, 1, 10, data, 2));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put(&rb, 2, 20, data, 4));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put(&rb, 3, 30, data, 0));
+
+    ring_buf_item_iter_init(&it, &rb);
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_iter_next(&it, &item));
+    TEST_ASSERT_EQUAL_UINT16(1, item.type);
+    TEST_ASSERT_EQUAL_UINT8(10, item.value);
+    TEST_ASSERT_EQUAL_UINT8(2, item.size32);
+    TEST_ASSERT_EQUAL_UINT32(8, item.data_size[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, item.data_size[1]);
+    TEST_ASSERT_EQUAL_MEMORY(data, item.data[0], 8);
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_iter_next(&it, &item));
+    TEST_ASSERT_EQUAL_UINT16(2, item.type);
+    TEST_ASSERT_EQUAL_UINT8(4, item.size32);
+    TEST_ASSERT_EQUAL_UINT32(8, item.data_size[0]);
+    TEST_ASSERT_EQUAL_UINT32(8, item.data_size[1]);
+    TEST_ASSERT_EQUAL_PTR(buff, item.data[1]);
+    TEST_ASSERT_EQUAL_MEMORY(data, item.data[0], 8);
+    TEST_ASSERT_EQUAL_MEMORY(&data[2], item.data[1], 8);
+
+    TEST_ASSERT_EQUAL_UINT32(2, ring_buf_item_iter_consume(&it));
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_iter_next(&it, &item));
+    TEST_ASSERT_EQUAL_UINT16(3, item.type);
+    TEST_ASSERT_EQUAL_UINT8(0, item.size32);
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_item_iter_next(&it, &item));
+
+    read_len = 0;
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_get(&rb, &type, &value, NULL, &read_len));
+    TEST_ASSERT_EQUAL_UINT16(3, type);
+    TEST_ASSERT_EQUAL_UINT8(30, value);
+    TEST_ASSERT_TRUE(ring_buf_is_empty(&rb));
+}
+
+/**
+ * Peek at items by position
+ *
+ * Description:
+ * - This test verifies that ring_buf_item_peek returns the item at a given
+ *   position without removing anything, and checks items of checked ring
+ *   buffers.
+ *
+ * Steps:
+ * - Initialize a checked ring buffer of 32 32-bit words.
+ * - Write 4 items of 1 word, with types 0 to 3.
+ * - Peek at positions 2 and 4.
+ * - Corrupt the data of the second item and peek at positions 1 and 3.
+ *
+ * Expected result:
+ * - Position 2 holds type 2; position 4 returns -1; nothing is removed.
+ * - Position 1 returns -3, position 3 still returns type 3.
+ */
+void test_item_peek_by_position(void)
+{
+    struct ring_buf rb;
+    struct ring_buf_item_view item;
+    uint32_t buff[32];
+    uint32_t data;
+
+    ring_buf_item_checked_init(&rb, sizeof(buff) / sizeof(uint32_t), buff);
+
+    for (uint16_t i = 0; i < 4; i++) {
+        data = 100u + i;
+        TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put(&rb, i, 0, &data, 1));
+    }
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_peek(&rb, 2, &item));
+    TEST_ASSERT_EQUAL_UINT16(2, item.type);
+    memcpy(&data, item.data[0], sizeof(data));
+    TEST_ASSERT_EQUAL_UINT32(102, data);
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_item_peek(&rb, 4, &item));
+    TEST_ASSERT_EQUAL_UINT32(4 * 3 * sizeof(uint32_t), ring_buf_size_get(&rb));
+
+    buff[4] ^= 1;
+    TEST_ASSERT_EQUAL_INT32(-3, ring_buf_item_peek(&rb, 1, &item));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_peek(&rb, 3, &item));
+    TEST_ASSERT_EQUAL_UINT16(3, item.type);
+}
+
+/**
+ * Test cases for record mode functions.
+ */
+
+/**
+ * Write and read records larger than an item
+ *
+ * Description:
+ * - This test verifies that records longer than the 1020 bytes allowed for
+ *   items are written and read back with their exact byte length.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 1024 32-bit words.
+ * - Write 1 record of 2001 bytes and 1 record of 3 bytes.
+ * - Read both records.
+ *
+ * Expected result:
+ * - Both records are read back intact, in order, with their length.
+ * - The ring buffer is empty afterwards.
+ */
+void test_record_put_and_get_large_records(void)
+{
+    struct ring_buf rb;
+    static uint32_t buff[1024];
+    static uint8_t data[2001];
+    static uint8_t read[2001];
+    uint32_t read_len;
+
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t) (i * 7u);
+    }
+
+    ring_buf_record_init(&rb, sizeof(buff) / sizeof(uint32_t), buff);
+
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_record_get(&rb, read, &read_len));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_put(&rb, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_put(&rb, data, 3));
+
+    read_len = 16;
+    TEST_ASSERT_EQUAL_INT32(-2, ring_buf_record_get(&rb, read, &read_len));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(data), read_len);
+
+    read_len = sizeof(read);
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_get(&rb, read, &read_len));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(data), read_len);
+    TEST_ASSERT_EQUAL_MEMORY(data, read, sizeof(data));
+
+    read_len = sizeof(read);
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_get(&rb, read, &read_len));
+    TEST_ASSERT_EQUAL_UINT32(3, read_len);
+    TEST_ASSERT_EQUAL_MEMORY(data, read, 3);
+
+    TEST_ASSERT_TRUE(ring_buf_is_empty(&rb));
+}
+
+/**
+ * Keep records contiguous across the wrap point
+ *
+ * Description:
+ * - This test verifies that a record which does not fit before the end of
+ *   the storage is placed at its beginning, and that the skipped bytes are
+ *   reclaimed when the record is read.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 16 32-bit words.
+ * - Repeatedly claim a record of 20 bytes, fill it in place, commit it,
+ *   then peek and release it.
+ *
+ * Expected result:
+ * - Every claimed and peeked record lies entirely within the storage.
+ * - Every record is read back intact and the ring buffer ends up empty.
+ */
+void test_record_claim_wraps_contiguously(void)
+{
+    struct ring_buf rb;
+    uint32_t buff[16];
+    uint8_t *uint8_buff = (uint8_t *) buff;
+
+    ring_buf_record_init(&rb, sizeof(buff) / sizeof(uint32_t), buff);
+
+    for (uint32_t i = 0; i < 20; i++) {
+        uint8_t *dst;
+        uint8_t *src;
+        uint32_t len;
+
+        TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_claim(&rb, &dst, 20));
+        TEST_ASSERT_TRUE(dst >= uint8_buff && dst + 20 <= uint8_buff + sizeof(buff));
+        memset(dst, (int) i, 20);
+        TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_commit(&rb, 20));
+
+        TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_peek(&rb, &src, &len));
+        TEST_ASSERT_EQUAL_PTR(dst, src);
+        TEST_ASSERT_EQUAL_UINT32(20, len);
+        TEST_ASSERT_EACH_EQUAL_UINT8(i, src, 20);
+        TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_release(&rb));
+        TEST_ASSERT_TRUE(ring_buf_is_empty(&rb));
+    }
+}
+
+/**
+ * Shrink a claimed record on commit
+ *
+ * Description:
+ * - This test verifies that a record can be claimed with a worst case size
+ *   and committed with its actual size, returning the surplus to the free
+ *   space.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 16 32-bit words.
+ * - Claim a record of 28 bytes and commit 5 bytes.
+ * - Attempt to commit again (which should fail).
+ * - Peek the record and release it twice (the second release should fail).
+ *
+ * Expected result:
+ * - The record is read back with a length of 5 bytes.
+ * - Only the header and the aligned 5 bytes were used.
+ */
+void test_record_commit_shrinks_claim(void)
+{
+    struct ring_buf rb;
+    uint32_t buff[16];
+    uint8_t *dst;
+    uint8_t *src;
+    uint32_t len;
+
+    ring_buf_record_init(&rb, sizeof(buff) / sizeof(uint32_t), buff);
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_claim(&rb, &dst, 28));
+    memcpy(dst, "hello", 5);
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_record_commit(&rb, 29));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_commit(&rb, 5));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_record_commit(&rb, 5));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(uint32_t) + 8, ring_buf_size_get(&rb));
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_peek(&rb, &src, &len));
+    TEST_ASSERT_EQUAL_UINT32(5, len);
+    TEST_ASSERT_EQUAL_MEMORY("hello", src, 5);
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_release(&rb));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_record_release(&rb));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_record_peek(&rb, &src, &len));
+}
+
+/**
+ * Peek a record twice
+ *
+ * Description:
+ * - This test verifies that peeking again before releasing returns the same
+ *   record.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 16 32-bit words and write 1 record.
+ * - Peek twice.
+ * - Write a second record, release the first one and peek again.
+ *
+ * Expected result:
+ * - Both peeks return the first record, the peek after the release returns
+ *   the second one.
+ */
+void test_record_peek_twice(void)
+{
+    struct ring_buf rb;
+    uint32_t buff[16];
+    uint8_t *src;
+    uint32_t len;
+
+    ring_buf_record_init(&rb, sizeof(buff) / sizeof(uint32_t), buff);
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_put(&rb, (const uint8_t *) "first", 5));
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_peek(&rb, &src, &len));
+    TEST_ASSERT_EQUAL_UINT32(5, len);
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_peek(&rb, &src, &len));
+    TEST_ASSERT_EQUAL_UINT32(5, len);
+    TEST_ASSERT_EQUAL_MEMORY("first", src, 5);
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_put(&rb, (const uint8_t *) "second", 6));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_release(&rb));
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_peek(&rb, &src, &len));
+    TEST_ASSERT_EQUAL_UINT32(6, len);
+    TEST_ASSERT_EQUAL_MEMORY("second", src, 6);
+}
+
+/**
+ * Reject records that do not fit
+ *
+ * Description:
+ * - This test verifies the errors reported for records that can never fit
+ *   and for records that do not fit yet.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 16 32-bit words.
+ * - Attempt to write a record of 33 bytes (which should fail).
+ * - Write 3 records of 16 bytes, then attempt a fourth one (which should
+ *   fail).
+ * - Read 1 record and write the fourth one again.
+ *
+ * Expected result:
+ * - The 33 byte record is rejected with -1.
+ * - The fourth record is rejected with -2 while the buffer is full, and
+ *   accepted once a record has been read.
+ */
+void test_record_put_rejects_when_full_or_too_big(void)
+{
+    struct ring_buf rb;
+    uint32_t buff[16];
+    uint8_t data[33] = {0};
+
+    ring_buf_record_init(&rb, sizeof(buff) / sizeof(uint32_t), buff);
+
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_record_put(&rb, data, 33));
+
+    for (uint32_t i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_put(&rb, data, 16));
+    }
+
+    TEST_ASSERT_EQUAL_INT32(-2, ring_buf_record_put(&rb, data, 16));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_get(&rb, NULL, &(uint32_t) {0}));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_record_put(&rb, data, 16));
+}
+
+/**
+ * Test cases for statistics.
+ */
+
+/**
+ * Count byte traffic, shortages and wraps
+ *
+ * Description:
+ * - This test verifies that byte puts and gets are counted along with short
+ *   puts, empty gets, claims cut by the wrap point and fill levels once
+ *   statistics are enabled; and that the snapshot reports -2 before.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 8 bytes and take a snapshot.
+ * - Enable statistics.
+ * - Write 6 bytes, then attempt to write 4 bytes (only 2 fit).
+ * - Read 5 bytes, then 10 bytes (only 3 available), then 1 byte.
+ * - Write 6 bytes and read them; write 4 bytes across the wrap point and
+ *   read them.
+ * - Reset the statistics.
+ *
+ * Expected result:
+ * - The first snapshot reports -2 and zeroes.
+ * - 18 bytes in and out, 1 short put, 1 empty get, 1 put and 1 get claim
+ *   cut by the wrap point, a high-water mark of 8 and an average fill of 6.
+ * - All counters are zero after the reset.
+ */
+void test_stats_count_bytes_shortages_and_wraps(void)
+{
+    struct ring_buf rb;
+    struct ring_buf_counters counters;
+    uint8_t buff[8];
+    uint8_t data[10] = {0};
+    struct ring_buf_stats stats;
+
+    ring_buf_init(&rb, sizeof(buff), buff);
+
+    TEST_ASSERT_EQUAL_INT32(-2, ring_buf_stats_get(&rb, &stats));
+    TEST_ASSERT_EQUAL_UINT64(0, stats.bytes_in);
+
+    ring_buf_stats_enable(&rb, &counters);
+
+#ifdef RING_BUF_NO_STATS
+    TEST_ASSERT_EQUAL_INT32(-2, ring_buf_stats_get(&rb, &stats));
+    TEST_IGNORE();
+#endif
+
+    TEST_ASSERT_EQUAL_UINT32(6, ring_buf_put(&rb, data, 6));
+    TEST_ASSERT_EQUAL_UINT32(2, ring_buf_put(&rb, data, 4));
+    TEST_ASSERT_EQUAL_UINT32(5, ring_buf_get(&rb, data, 5));
+    TEST_ASSERT_EQUAL_UINT32(3, ring_buf_get(&rb, data, 10));
+    TEST_ASSERT_EQUAL_UINT32(0, ring_buf_get(&rb, data, 1));
+    TEST_ASSERT_EQUAL_UINT32(6, ring_buf_put(&rb, data, 6));
+    TEST_ASSERT_EQUAL_UINT32(6, ring_buf_get(&rb, data, 6));
+    TEST_ASSERT_EQUAL_UINT32(4, ring_buf_put(&rb, data, 4));
+    TEST_ASSERT_EQUAL_UINT32(4, ring_buf_get(&rb, data, 4));
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_stats_get(&rb, &stats));
+    TEST_ASSERT_EQUAL_UINT64(18, stats.bytes_in);
+    TEST_ASSERT_EQUAL_UINT64(18, stats.bytes_out);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.items_in);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.items_out);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.put_full);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.get_empty);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.put_wrap);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.get_wrap);
+    TEST_ASSERT_EQUAL_UINT32(8, stats.high_water);
+    TEST_ASSERT_EQUAL_UINT32(6, stats.fill_avg);
+
+    ring_buf_stats_reset(&rb);
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_stats_get(&rb, &stats));
+    TEST_ASSERT_EQUAL_UINT64(0, stats.bytes_in);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.put_full);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.high_water);
+}
+
+/**
+ * Count items
+ *
+ * Description:
+ * - This test verifies that item puts and gets are counted, along with puts
+ *   refused for lack of space and gets finding the ring buffer empty.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 6 32-bit words and enable statistics.
+ * - Write 2 items of 2 32-bit words, then attempt a third one.
+ * - Read 3 items.
+ *
+ * Expected result:
+ * - 2 items in and out, 1 full put and 1 empty get.
+ */
+void test_stats_count_items(void)
+{
+    struct ring_buf rb;
+    struct ring_buf_counters counters;
+    uint32_t buff[6];
+    uint32_t data[2] = {1, 2};
+    struct ring_buf_stats stats;
+    uint16_t type;
+    uint8_t value;
+    uint8_t size32;
+
+#ifdef RING_BUF_NO_STATS
+    TEST_IGNORE();
+#endif
+
+    ring_buf_item_init(&rb, sizeof(buff) / sizeof(uint32_t), buff);
+    ring_buf_stats_enable(&rb, &counters);
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put(&rb, 1, 1, data, 2));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put(&rb, 1, 1, data, 2));
+    TEST_ASSERT_EQUAL_INT32(-2, ring_buf_item_put(&rb, 1, 1, data, 2));
+
+    for (uint32_t i = 0; i < 2; i++) {
+        size32 = 2;
+        TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_get(&rb, &type, &value, data, &size32));
+    }
+
+    size32 = 2;
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_item_get(&rb, &type, &value, data, &size32));
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_stats_get(&rb, &stats));
+    TEST_ASSERT_EQUAL_UINT32(2, stats.items_in);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.items_out);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.put_full);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.get_empty);
+    TEST_ASSERT_EQUAL_UINT64(24, stats.bytes_in);
+    TEST_ASSERT_EQUAL_UINT64(24, stats.bytes_out);
+}
+
+/**
+ * Sample the fill level of a drained ring buffer
+ *
+ * Description:
+ * - This test verifies that fill levels follow the consumer even though the
+ *   producer never runs out of space, and so never refreshes its view of the
+ *   consumer position to make room.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 64 bytes and enable statistics.
+ * - 1000 times, write 1 byte and read it.
+ *
+ * Expected result:
+ * - The fill level is overestimated by at most the bytes read during
+ *   RING_BUF_STATS_FILL_PERIOD - 1 commits: the high-water mark is at most
+ *   RING_BUF_STATS_FILL_PERIOD bytes, and the average fill level about half
+ *   of it.
+ */
+void test_stats_fill_level_drained(void)
+{
+    struct ring_buf rb;
+    struct ring_buf_counters counters;
+    uint8_t buff[64];
+    uint8_t data = 0;
+    struct ring_buf_stats stats;
+
+#ifdef RING_BUF_NO_STATS
+    TEST_IGNORE();
+#endif
+
+    ring_buf_init(&rb, sizeof(buff), buff);
+    ring_buf_stats_enable(&rb, &counters);
+
+    for (uint32_t i = 0; i < 1000; i++) {
+        TEST_ASSERT_EQUAL_UINT32(1, ring_buf_put(&rb, &data, 1));
+        TEST_ASSERT_EQUAL_UINT32(1, ring_buf_get(&rb, &data, 1));
+    }
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_stats_get(&rb, &stats));
+    TEST_ASSERT_EQUAL_UINT64(1000, stats.bytes_in);
+    TEST_ASSERT_EQUAL_UINT32(RING_BUF_STATS_FILL_PERIOD, stats.high_water);
+    TEST_ASSERT_TRUE(stats.fill_avg <= RING_BUF_STATS_FILL_PERIOD / 2u + 1u);
+}
+
+/**
+ * Test cases for concurrent single producer/single consumer usage.
+ */
+
+/**
+ * Validate producer and consumer state layout
+ *
+ * Description:
+ * - This test verifies that the indices written by the producer and the
+ *   ones written by the consumer can never share a cache line.
+ *
+ * Steps:
+ * - Compare the offsets of the producer and consumer fields.
+ *
+ * Expected result:
+ * - At least RING_BUF_CACHE_LINE_SIZE bytes separate the last producer
+ *   field from the first consumer field, and the read-mostly fields from
+ *   the producer fields (ignored when the padding is compiled out).
+ */
+void test_concurrent_layout_separates_cache_lines(void)
+{
+#if RING_BUF_CACHE_LINE_SIZE == 0
+    TEST_IGNORE();
+#else
+    size_t producer_start = offsetof(struct ring_buf, put_head);
+    size_t producer_end = offsetof(struct ring_buf, dropped_items) + sizeof(uint32_t);
+    size_t consumer_start = offsetof(struct ring_buf, get_head);
+    size_t shared_end = offsetof(struct ring_buf, flags) + sizeof(uint32_t);
+
+    TEST_ASSERT_TRUE(consumer_start - producer_end >= RING_BUF_CACHE_LINE_SIZE);
+    TEST_ASSERT_TRUE(producer_start - shared_end >= RING_BUF_CACHE_LINE_SIZE);
+#endif
+}
+
+#define SPSC_STRESS_BYTES (4u * 1024u * 1024u)
+#define SPSC_STRESS_ITEMS (200000u)
+
+static uint8_t spsc_pattern(uint32_t index)
+{
+    return (uint8_t) ((index * 7u) ^ (index >> 8));
+}
+
+static void *spsc_byte_producer(void *arg)
+{
+    struct ring_buf *rb = arg;
+    uint32_t sent = 0;
+    uint32_t chunk = 1;
+
+    while (sent < SPSC_STRESS_BYTES) {
+        uint32_t size = SPSC_STRESS_BYTES - sent;
+        uint32_t written;
+
+        size = (size < chunk) ? size : chunk;
+
+        if (chunk & 1u) {
+            uint8_t data[64];
+
+            for (uint32_t i = 0; i < size; i++) {
+                data[i] = spsc_pattern(sent + i);
+            }
+
+            written = ring_buf_put(rb, data, size);
+        } else {
+            uint8_t *dst;
+
+            written = ring_buf_put_claim(rb, &dst, size);
+            for (uint32_t i = 0; i < written; i++) {
+                dst[i] = spsc_pattern(sent + i);
+            }
+
+            ring_buf_put_finish(rb, written);
+        }
+
+        if (written == 0) {
+            sched_yield();
+        }
+
+        sent += written;
+        chunk = (chunk % 63u) + 1u;
+    }
+
+    return NULL;
+}
+
+static void *spsc_item_producer(void *arg)
+{
+    struct ring_buf *rb = arg;
+    uint32_t data[8];
+
+    for (uint32_t seq = 0; seq < SPSC_STRESS_ITEMS; ) {
+        uint8_t size32 = (uint8_t) (seq % 8u);
+
+        for (uint8_t i = 0; i < size32; i++) {
+            data[i] = seq + i;
+        }
+
+        if (ring_buf_item_put(rb, (uint16_t) seq, (uint8_t) (seq >> 16),
+                              data, size32) == 0) {
+            seq++;
+        } else {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Lock-free single producer/single consumer stress test for byte mode
+ *
+ * Description:
+ * - This test verifies that one producer thread and one consumer thread can
+ *   use the byte mode API concurrently without any locking.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 61 bytes (so that transfers wrap at
+ *   varying offsets).
+ * - Start a producer thread that writes a known byte pattern, alternating
+ *   between ring_buf_put and ring_buf_put_claim/ring_buf_put_finish with
+ *   chunk sizes from 1 to 63 bytes.
+ * - On the test thread, read the stream back, alternating between
+ *   ring_buf_get and ring_buf_get_claim/ring_buf_get_finish.
+ *
+ * Expected result:
+ * - Every byte is received exactly once, in order and uncorrupted.
+ * - The ring buffer is empty once the producer has finished.
+ */
+void test_spsc_concurrent_byte_stream(void)
+{
+    struct ring_buf rb;
+    uint8_t buff[61];
+    pthread_t producer;
+    uint32_t received = 0;
+    uint32_t errors = 0;
+    uint32_t chunk = 1;
+
+    ring_buf_init(&rb, sizeof(buff), buff);
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&producer, NULL, spsc_byte_producer, &rb));
+
+    while (received < SPSC_STRESS_BYTES) {
+        uint32_t read;
+
+        if (chunk & 1u) {
+            uint8_t data[64];
+
+            read = ring_buf_get(&rb, data, chunk);
+            for (uint32_t i = 0; i < read; i++) {
+                errors += (data[i] != spsc_pattern(received + i));
+            }
+        } else {
+            uint8_t *src;
+
+            read = ring_buf_get_claim(&rb, &src, chunk);
+            for (uint32_t i = 0; i < read; i++) {
+                errors += (src[i] != spsc_pattern(received + i));
+            }
+
+            ring_buf_get_finish(&rb, read);
+        }
+
+        if (read == 0) {
+            sched_yield();
+        }
+
+        received += read;
+        chunk = (chunk % 63u) + 1u;
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(producer, NULL));
+
+    TEST_ASSERT_EQUAL_UINT32(0, errors);
+    TEST_ASSERT_EQUAL_UINT32(SPSC_STRESS_BYTES, received);
+    TEST_ASSERT_TRUE(ring_buf_is_empty(&rb));
+}
+
+/**
+ * Lock-free single producer/single consumer stress test for item mode
+ *
+ * Description:
+ * - This test verifies that one producer thread and one consumer thread can
+ *   exchange items concurrently without any locking.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 23 32-bit words.
+ * - Start a producer thread that writes items of 0 to 7 words, each tagged
+ *   with a sequence number.
+ * - On the test thread, read every item back with ring_buf_item_get.
+ *
+ * Expected result:
+ * - Items are received in order with the expected type, value, length and
+ *   payload.
+ */
+void test_spsc_concurrent_item_stream(void)
+{
+    struct ring_buf rb;
+    uint32_t buff[23];
+    pthread_t producer;
+    uint32_t errors = 0;
+
+    ring_buf_item_init(&rb, sizeof(buff) / sizeof(uint32_t), buff);
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&producer, NULL, spsc_item_producer, &rb));
+
+    for (uint32_t seq = 0; seq < SPSC_STRESS_ITEMS; ) {
+        uint32_t data[8];
+        uint16_t type;
+        uint8_t value;
+        uint8_t size32 = 8;
+
+        if (ring_buf_item_get(&rb, &type, &value, data, &size32) != 0) {
+            sched_yield();
+            continue;
+        }
+
+        errors += (type != (uint16_t) seq);
+        errors += (value != (uint8_t) (seq >> 16));
+        errors += (size32 != seq % 8u);
+        for (uint8_t i = 0; i < size32; i++) {
+            errors += (data[i] != seq + i);
+        }
+
+        seq++;
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(producer, NULL));
+
+    TEST_ASSERT_EQUAL_UINT32(0, errors);
+    TEST_ASSERT_TRUE(ring_buf_is_empty(&rb));
+}
+
+static void *overwrite_item_producer(void *arg)
+{
+    struct ring_buf *rb = arg;
+    uint32_t data[8];
+
+    for (uint32_t seq = 0; seq < SPSC_STRESS_ITEMS; seq++) {
+        uint8_t size32 = (uint8_t) (seq % 8u);
+
+        for (uint8_t i = 0; i < size32; i++) {
+            data[i] = seq + i;
+        }
+
+        (void) ring_buf_item_put_overwrite(rb, (uint16_t) seq, (uint8_t) (seq >> 16),
+                                           data, size32);
+    }
+
+    return NULL;
+}
+
+/**
+ * Overwriting producer racing with a consumer in item mode
+ *
+ * Description:
+ * - This test verifies that, with ring_buf_overwrite_enable, a producer
+ *   writing with ring_buf_item_put_overwrite never waits for the consumer
+ *   and that the consumer only ever reads whole, uncorrupted items.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 23 32-bit words and enable concurrent
+ *   overwrites.
+ * - Start a producer thread that writes items of 0 to 7 words, each tagged
+ *   with a sequence number, with ring_buf_item_put_overwrite.
+ * - On the test thread, read items with ring_buf_item_get until the last
+ *   one arrives.
+ *
+ * Expected result:
+ * - Items are received in increasing order, with the length and payload
+ *   matching their sequence number.
+ * - Received and dropped items add up to the number of items written.
+ */
+void test_overwrite_concurrent_item_stream(void)
+{
+    struct ring_buf rb;
+    uint32_t buff[23];
+    pthread_t producer;
+    uint32_t errors = 0;
+    uint32_t received = 0;
+    uint32_t next = 0;
+
+    ring_buf_item_init(&rb, sizeof(buff) / sizeof(uint32_t), buff);
+    ring_buf_overwrite_enable(&rb);
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&producer, NULL, overwrite_item_producer, &rb));
+
+    while (next < SPSC_STRESS_ITEMS) {
+        uint32_t data[8];
+        uint16_t type;
+        uint8_t value;
+        uint8_t size32 = 8;
+
+        if (ring_buf_item_get(&rb, &type, &value, data, &size32) != 0) {
+            sched_yield();
+            continue;
+        }
+
+        uint32_t seq = ((uint32_t) value << 16) | type;
+
+        errors += (seq < next);
+        errors += (size32 != seq % 8u);
+        for (uint8_t i = 0; i < size32; i++) {
+            errors += (data[i] != seq + i);
+        }
+
+        received++;
+        next = seq + 1;
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(producer, NULL));
+
+    TEST_ASSERT_EQUAL_UINT32(0, errors);
+    TEST_ASSERT_EQUAL_UINT32(SPSC_STRESS_ITEMS, received + ring_buf_item_dropped_get(&rb));
+    TEST_ASSERT_TRUE(ring_buf_is_empty(&rb));
+}
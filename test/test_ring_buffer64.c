@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "unity.h"
+#include "ring_buffer64.h"
+
+#include <string.h>
+
+
+/**
+ * Write and read over several laps
+ *
+ * Description:
+ * - This test verifies that a 64-bit index ring buffer behaves as
+ *   struct ring_buf for put, peek and get, across the wrap point.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 13 bytes.
+ * - Repeat 50 times: write 5 bytes, peek them, then read them back.
+ * - Write 20 bytes.
+ *
+ * Expected result:
+ * - Every put and get moves 5 bytes and the data matches.
+ * - Only 13 bytes of the last write fit.
+ */
+void test_ring_buf64_put_get_wraparound(void)
+{
+    struct ring_buf64 rb;
+    uint8_t buff[13];
+    uint8_t data[20];
+    uint8_t read[20];
+
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t) i;
+    }
+
+    ring_buf64_init(&rb, sizeof(buff), buff);
+    TEST_ASSERT_TRUE(ring_buf64_is_empty(&rb));
+    TEST_ASSERT_EQUAL_UINT64(13, ring_buf64_capacity_get(&rb));
+
+    for (uint32_t lap = 0; lap < 50; lap++) {
+        TEST_ASSERT_EQUAL_UINT64(5, ring_buf64_put(&rb, &data[lap % 10], 5));
+        TEST_ASSERT_EQUAL_UINT64(5, ring_buf64_size_get(&rb));
+        TEST_ASSERT_EQUAL_UINT64(5, ring_buf64_peek(&rb, read, sizeof(read)));
+        TEST_ASSERT_EQUAL_MEMORY(&data[lap % 10], read, 5);
+
+        memset(read, 0, sizeof(read));
+        TEST_ASSERT_EQUAL_UINT64(5, ring_buf64_get(&rb, read, sizeof(read)));
+        TEST_ASSERT_EQUAL_MEMORY(&data[lap % 10], read, 5);
+        TEST_ASSERT_TRUE(ring_buf64_is_empty(&rb));
+    }
+
+    TEST_ASSERT_EQUAL_UINT64(13, ring_buf64_put(&rb, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT64(0, ring_buf64_space_get(&rb));
+    TEST_ASSERT_EQUAL_UINT64(13, ring_buf64_get(&rb, read, sizeof(read)));
+    TEST_ASSERT_EQUAL_MEMORY(data, read, 13);
+}
+
+/**
+ * Claims stop at the wrap point
+ *
+ * Description:
+ * - This test verifies that claims stop at the end of the storage and that
+ *   finishing more than claimed is rejected.
+ *
+ * Steps:
+ * - Write and read 6 bytes on a ring buffer of 8 bytes.
+ * - Claim 5 bytes for writing twice, then finish 6 bytes and 5 bytes.
+ * - Claim 6 bytes for reading twice, then finish 6 bytes and 5 bytes.
+ *
+ * Expected result:
+ * - Claims return 2 then 3 bytes, the second one at the start of storage.
+ * - Finishing 6 bytes returns -1, finishing 5 bytes returns 0.
+ */
+void test_ring_buf64_claims_stop_at_wrap(void)
+{
+    struct ring_buf64 rb;
+    uint8_t buff[8];
+    uint8_t data[6] = {0};
+    uint8_t *first;
+    uint8_t *second;
+
+    ring_buf64_init(&rb, sizeof(buff), buff);
+    TEST_ASSERT_EQUAL_UINT64(6, ring_buf64_put(&rb, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT64(6, ring_buf64_get(&rb, NULL, sizeof(data)));
+
+    TEST_ASSERT_EQUAL_UINT64(2, ring_buf64_put_claim(&rb, &first, 5));
+    TEST_ASSERT_EQUAL_UINT64(3, ring_buf64_put_claim(&rb, &second, 3));
+    TEST_ASSERT_EQUAL_PTR(buff, second);
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf64_put_finish(&rb, 6));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf64_put_finish(&rb, 5));
+
+    TEST_ASSERT_EQUAL_UINT64(2, ring_buf64_get_claim(&rb, &first, 6));
+    TEST_ASSERT_EQUAL_UINT64(3, ring_buf64_get_claim(&rb, &second, 6));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf64_get_finish(&rb, 6));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf64_get_finish(&rb, 5));
+
+    TEST_ASSERT_TRUE(ring_buf64_is_empty(&rb));
+}
+
+/**
+ * Claimed data counts as read
+ *
+ * Description:
+ * - This test verifies that, as for struct ring_buf, the ring buffer is
+ *   empty once the consumer claimed all committed data, before it finishes.
+ *
+ * Steps:
+ * - Write 4 bytes on a ring buffer of 8 bytes and claim them for reading.
+ * - Write 1 more byte, finish the 4 claimed bytes, then claim the last one.
+ *
+ * Expected result:
+ * - The ring buffer is empty after the first claim, not after the second
+ *   write nor after the finish, and empty again after the last claim.
+ */
+void test_ring_buf64_is_empty_after_claim(void)
+{
+    struct ring_buf64 rb;
+    uint8_t buff[8];
+    uint8_t data[5] = {0};
+    uint8_t *ptr;
+
+    ring_buf64_init(&rb, sizeof(buff), buff);
+    TEST_ASSERT_EQUAL_UINT64(4, ring_buf64_put(&rb, data, 4));
+    TEST_ASSERT_EQUAL_UINT64(4, ring_buf64_get_claim(&rb, &ptr, 4));
+    TEST_ASSERT_TRUE(ring_buf64_is_empty(&rb));
+
+    TEST_ASSERT_EQUAL_UINT64(1, ring_buf64_put(&rb, &data[4], 1));
+    TEST_ASSERT_FALSE(ring_buf64_is_empty(&rb));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf64_get_finish(&rb, 4));
+    TEST_ASSERT_FALSE(ring_buf64_is_empty(&rb));
+
+    TEST_ASSERT_EQUAL_UINT64(1, ring_buf64_get_claim(&rb, &ptr, 1));
+    TEST_ASSERT_TRUE(ring_buf64_is_empty(&rb));
+}
+
+/**
+ * Indices go past 32 bits
+ *
+ * Description:
+ * - This test verifies that more than 4 GiB can stream through a ring
+ *   buffer without the indices wrapping as 32-bit values would.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 1 MiB + 3 bytes.
+ * - Claim and finish 5 GiB in chunks of up to 1 MiB, reading each chunk
+ *   back with claim and finish.
+ *
+ * Expected result:
+ * - Every claim returns data, and the ring buffer is empty at the end.
+ */
+void test_ring_buf64_indices_past_32_bits(void)
+{
+    static uint8_t buff[(1u << 20) + 3];
+    struct ring_buf64 rb;
+    uint64_t total = 5ull << 30;
+    uint64_t moved = 0;
+
+    ring_buf64_init(&rb, sizeof(buff), buff);
+
+    while (moved < total) {
+        uint8_t *ptr;
+        uint64_t size = ring_buf64_put_claim(&rb, &ptr, 1u << 20);
+
+        TEST_ASSERT_TRUE(size > 0);
+        TEST_ASSERT_EQUAL_INT32(0, ring_buf64_put_finish(&rb, size));
+        TEST_ASSERT_EQUAL_UINT64(size, ring_buf64_get_claim(&rb, &ptr, size));
+        TEST_ASSERT_EQUAL_INT32(0, ring_buf64_get_finish(&rb, size));
+        moved += size;
+    }
+
+    TEST_ASSERT_TRUE(ring_buf64_is_empty(&rb));
+    TEST_ASSERT_EQUAL_UINT64(sizeof(buff), ring_buf64_space_get(&rb));
+}
+
+/**
+ * Allocate storage bigger than 4 GiB
+ *
+ * Description:
+ * - This test verifies that ring_buf64_alloc maps storage larger than what
+ *   32-bit indices can address, that a single claim can cover it, and that
+ *   invalid arguments are rejected.
+ *
+ * Steps:
+ * - Allocate a ring buffer of 0 bytes and one with both huge page flags.
+ * - Allocate a ring buffer of 6 GiB with transparent huge pages (skipped
+ *   when the system refuses the mapping).
+ * - Claim 6 GiB for writing, touch both ends, then finish.
+ *
+ * Expected result:
+ * - Invalid allocations return -1.
+ * - The claim covers the whole 6 GiB and the ring buffer reports it used.
+ */
+void test_ring_buf64_alloc_beyond_4gib(void)
+{
+    struct ring_buf64 rb;
+    uint64_t size = 6ull << 30;
+    uint8_t *ptr;
+
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf64_alloc(&rb, 0, 0));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf64_alloc(&rb, 4096, RING_BUF64_ALLOC_HUGETLB |
+                                                 RING_BUF64_ALLOC_THP));
+
+    if (ring_buf64_alloc(&rb, size, RING_BUF64_ALLOC_THP) != 0) {
+        TEST_IGNORE_MESSAGE("cannot map 6 GiB");
+    }
+
+    TEST_ASSERT_EQUAL_UINT64(size, ring_buf64_put_claim(&rb, &ptr, UINT64_MAX));
+    ptr[0] = 1;
+    ptr[size - 1] = 2;
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf64_put_finish(&rb, size));
+    TEST_ASSERT_EQUAL_UINT64(size, ring_buf64_size_get(&rb));
+    TEST_ASSERT_EQUAL_UINT64(0, ring_buf64_space_get(&rb));
+
+    ring_buf64_free(&rb);
+    TEST_ASSERT_NULL(rb.buffer);
+}
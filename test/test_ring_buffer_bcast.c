@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "unity.h"
+#include "ring_buffer_bcast.h"
+
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+
+/**
+ * Every reader receives every byte
+ *
+ * Description:
+ * - This test ensures that data written once to a broadcast ring buffer is
+ *   read back in full by each attached reader.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 16 bytes and attach 3 readers.
+ * - Write 10 bytes.
+ * - Read them with each reader.
+ *
+ * Expected result:
+ * - Each reader reads the 10 bytes written.
+ * - The free space is only returned once the last reader has read them.
+ */
+void test_bcast_every_reader_receives_every_byte(void)
+{
+    struct ring_buf_bcast rb;
+    struct ring_buf_bcast_reader readers[3];
+    uint8_t buff[16];
+    uint8_t data[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+
+    ring_buf_bcast_init(&rb, sizeof(buff), buff);
+
+    for (uint32_t i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_INT32(0, ring_buf_bcast_reader_add(&rb, &readers[i]));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(10, ring_buf_bcast_put(&rb, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT32(6, ring_buf_bcast_space_get(&rb));
+
+    for (uint32_t i = 0; i < 3; i++) {
+        uint8_t read[10] = {0};
+
+        TEST_ASSERT_EQUAL_UINT32(10, ring_buf_bcast_size_get(&readers[i]));
+        TEST_ASSERT_EQUAL_UINT32(10, ring_buf_bcast_get(&readers[i], read, sizeof(read)));
+        TEST_ASSERT_EQUAL_MEMORY(data, read, sizeof(data));
+        TEST_ASSERT_EQUAL_UINT32(0, ring_buf_bcast_size_get(&readers[i]));
+        TEST_ASSERT_EQUAL_UINT32(i < 2 ? 6 : 16, ring_buf_bcast_space_get(&rb));
+    }
+}
+
+/**
+ * Slowest reader governs the producer
+ *
+ * Description:
+ * - This test verifies that the producer cannot overwrite data a reader has
+ *   not read yet, and that detaching that reader releases the space.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 8 bytes and attach 2 readers.
+ * - Write 8 bytes; read them with the first reader only.
+ * - Attempt to write 4 more bytes.
+ * - Detach the second reader and write 4 more bytes again.
+ *
+ * Expected result:
+ * - The write is refused while the second reader lags behind.
+ * - The write succeeds and wraps once the second reader is detached, and
+ *   the first reader reads the new bytes.
+ */
+void test_bcast_slowest_reader_governs_space(void)
+{
+    struct ring_buf_bcast rb;
+    struct ring_buf_bcast_reader fast;
+    struct ring_buf_bcast_reader slow;
+    uint8_t buff[8];
+    uint8_t data[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint8_t read[8] = {0};
+
+    ring_buf_bcast_init(&rb, sizeof(buff), buff);
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_bcast_reader_add(&rb, &fast));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_bcast_reader_add(&rb, &slow));
+
+    TEST_ASSERT_EQUAL_UINT32(8, ring_buf_bcast_put(&rb, data, 8));
+    TEST_ASSERT_EQUAL_UINT32(8, ring_buf_bcast_get(&fast, read, 8));
+    TEST_ASSERT_EQUAL_UINT32(0, ring_buf_bcast_put(&rb, data, 4));
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_bcast_reader_remove(&slow));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_bcast_reader_remove(&slow));
+    TEST_ASSERT_EQUAL_UINT32(4, ring_buf_bcast_put(&rb, &data[4], 4));
+    TEST_ASSERT_EQUAL_UINT32(4, ring_buf_bcast_get(&fast, read, 8));
+    TEST_ASSERT_EQUAL_MEMORY(&data[4], read, 4);
+}
+
+/**
+ * Attach readers late and beyond the limit
+ *
+ * Description:
+ * - This test verifies that a reader only sees data written after it was
+ *   attached, and that no more than RING_BUF_BCAST_MAX_READERS readers can
+ *   be attached.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 8 bytes and write 3 bytes with no reader.
+ * - Attach RING_BUF_BCAST_MAX_READERS readers, then one more.
+ * - Write 2 bytes and read them with the last attached reader.
+ *
+ * Expected result:
+ * - The bytes written without readers are dropped.
+ * - The extra reader is refused with -1.
+ * - The last attached reader only reads the 2 new bytes.
+ */
+void test_bcast_late_readers_and_reader_limit(void)
+{
+    struct ring_buf_bcast rb;
+    struct ring_buf_bcast_reader readers[RING_BUF_BCAST_MAX_READERS + 1];
+    uint8_t buff[8];
+    uint8_t data[3] = {7, 8, 9};
+    uint8_t read[8] = {0};
+
+    ring_buf_bcast_init(&rb, sizeof(buff), buff);
+
+    TEST_ASSERT_EQUAL_UINT32(3, ring_buf_bcast_put(&rb, data, 3));
+    TEST_ASSERT_EQUAL_UINT32(8, ring_buf_bcast_space_get(&rb));
+
+    for (uint32_t i = 0; i < RING_BUF_BCAST_MAX_READERS; i++) {
+        TEST_ASSERT_EQUAL_INT32(0, ring_buf_bcast_reader_add(&rb, &readers[i]));
+    }
+
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_bcast_reader_add(&rb, &readers[RING_BUF_BCAST_MAX_READERS]));
+
+    TEST_ASSERT_EQUAL_UINT32(2, ring_buf_bcast_put(&rb, &data[1], 2));
+    TEST_ASSERT_EQUAL_UINT32(2, ring_buf_bcast_get(&readers[RING_BUF_BCAST_MAX_READERS - 1], read, 8));
+    TEST_ASSERT_EQUAL_MEMORY(&data[1], read, 2);
+}
+
+#define BCAST_READERS    3u
+#define BCAST_TEST_BYTES (1u << 20)
+
+static struct ring_buf_bcast bcast_rb;
+static uint8_t bcast_buff[64];
+
+struct bcast_reader_ctx {
+    struct ring_buf_bcast_reader reader;
+    uint32_t errors;
+};
+
+static void *bcast_producer(void *arg)
+{
+    (void) arg;
+
+    for (uint32_t sent = 0; sent < BCAST_TEST_BYTES; ) {
+        uint8_t *dst;
+        uint32_t len = ring_buf_bcast_put_claim(&bcast_rb, &dst, 13);
+
+        for (uint32_t i = 0; i < len; i++) {
+            dst[i] = (uint8_t) (sent + i);
+        }
+
+        ring_buf_bcast_put_finish(&bcast_rb, len);
+        sent += len;
+
+        if (len == 0) {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void *bcast_reader(void *arg)
+{
+    struct bcast_reader_ctx *ctx = arg;
+
+    for (uint32_t received = 0; received < BCAST_TEST_BYTES; ) {
+        uint8_t read[17];
+        uint32_t len = ring_buf_bcast_get(&ctx->reader, read, sizeof(read));
+
+        for (uint32_t i = 0; i < len; i++) {
+            ctx->errors += (read[i] != (uint8_t) (received + i));
+        }
+
+        received += len;
+
+        if (len == 0) {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Concurrent producer and readers
+ *
+ * Description:
+ * - This test verifies that one producer thread and several reader threads
+ *   can share a broadcast ring buffer without locking.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 64 bytes and attach 3 readers.
+ * - Start a producer thread writing 1 MiB of a known byte pattern.
+ * - Start one thread per reader, each reading the whole stream.
+ *
+ * Expected result:
+ * - Every reader receives the full stream in order and without corruption.
+ */
+void test_bcast_concurrent_producer_and_readers(void)
+{
+    static struct bcast_reader_ctx ctx[BCAST_READERS];
+    pthread_t readers[BCAST_READERS];
+    pthread_t producer;
+
+    ring_buf_bcast_init(&bcast_rb, sizeof(bcast_buff), bcast_buff);
+
+    for (uint32_t i = 0; i < BCAST_READERS; i++) {
+        ctx[i].errors = 0;
+        TEST_ASSERT_EQUAL_INT32(0, ring_buf_bcast_reader_add(&bcast_rb, &ctx[i].reader));
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&readers[i], NULL, bcast_reader, &ctx[i]));
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&producer, NULL, bcast_producer, NULL));
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(producer, NULL));
+
+    for (uint32_t i = 0; i < BCAST_READERS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_join(readers[i], NULL));
+        TEST_ASSERT_EQUAL_UINT32(0, ctx[i].errors);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(sizeof(bcast_buff), ring_buf_bcast_space_get(&bcast_rb));
+}
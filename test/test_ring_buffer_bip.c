@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "unity.h"
+#include "ring_buffer_bip.h"
+
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+
+/**
+ * Claims are never cut at the end of the storage
+ *
+ * Description:
+ * - This test verifies that a claim which does not fit before the end of the
+ *   storage is granted whole at its beginning, where struct ring_buf would
+ *   return a truncated span.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 16 bytes, write and read 10 bytes.
+ * - Claim 8 bytes for writing and finish them.
+ * - Claim 16 bytes for reading.
+ *
+ * Expected result:
+ * - The write claim returns 8 bytes at the start of the storage.
+ * - The read claim returns the same 8 bytes from the start of the storage.
+ */
+void test_ring_buf_bip_claim_is_contiguous(void)
+{
+    struct ring_buf_bip rb;
+    uint8_t buff[16];
+    uint8_t *ptr;
+
+    ring_buf_bip_init(&rb, sizeof(buff), buff);
+    TEST_ASSERT_TRUE(ring_buf_bip_is_empty(&rb));
+
+    TEST_ASSERT_EQUAL_UINT32(10, ring_buf_bip_put_claim(&rb, &ptr, 10));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_bip_put_finish(&rb, 10));
+    TEST_ASSERT_EQUAL_UINT32(10, ring_buf_bip_get_claim(&rb, &ptr, 16));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_bip_get_finish(&rb, 10));
+    TEST_ASSERT_TRUE(ring_buf_bip_is_empty(&rb));
+
+    TEST_ASSERT_EQUAL_UINT32(8, ring_buf_bip_put_claim(&rb, &ptr, 8));
+    TEST_ASSERT_EQUAL_PTR(buff, ptr);
+    memset(ptr, 0xa5, 8);
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_bip_put_finish(&rb, 8));
+    TEST_ASSERT_EQUAL_UINT32(8, ring_buf_bip_size_get(&rb));
+
+    TEST_ASSERT_EQUAL_UINT32(8, ring_buf_bip_get_claim(&rb, &ptr, 16));
+    TEST_ASSERT_EQUAL_PTR(buff, ptr);
+    TEST_ASSERT_EACH_EQUAL_UINT8(0xa5, ptr, 8);
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_bip_get_finish(&rb, 8));
+    TEST_ASSERT_TRUE(ring_buf_bip_is_empty(&rb));
+}
+
+/**
+ * Data held in two regions is read in order
+ *
+ * Description:
+ * - This test verifies that once the producer restarts from the beginning
+ *   of the storage, the older region is read before the newer one.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 16 bytes, write 12 bytes and read 6.
+ * - Write 5 bytes, then claim 1 more.
+ * - Read with claims of 16 bytes until empty.
+ *
+ * Expected result:
+ * - The 5 bytes are placed at the start of the storage, after which no free
+ *   space is left.
+ * - Reads return the 6 older bytes first, then the 5 newer ones.
+ */
+void test_ring_buf_bip_two_regions(void)
+{
+    struct ring_buf_bip rb;
+    uint8_t buff[16];
+    uint8_t *ptr;
+
+    ring_buf_bip_init(&rb, sizeof(buff), buff);
+
+    TEST_ASSERT_EQUAL_UINT32(12, ring_buf_bip_put_claim(&rb, &ptr, 12));
+    for (uint32_t i = 0; i < 12; i++) {
+        ptr[i] = (uint8_t) i;
+    }
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_bip_put_finish(&rb, 12));
+    TEST_ASSERT_EQUAL_UINT32(6, ring_buf_bip_get_claim(&rb, &ptr, 6));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_bip_get_finish(&rb, 6));
+
+    TEST_ASSERT_EQUAL_UINT32(5, ring_buf_bip_put_claim(&rb, &ptr, 5));
+    TEST_ASSERT_EQUAL_PTR(buff, ptr);
+    for (uint32_t i = 0; i < 5; i++) {
+        ptr[i] = (uint8_t) (12 + i);
+    }
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_bip_put_finish(&rb, 5));
+    TEST_ASSERT_EQUAL_UINT32(11, ring_buf_bip_size_get(&rb));
+    TEST_ASSERT_EQUAL_UINT32(0, ring_buf_bip_space_get(&rb));
+    TEST_ASSERT_EQUAL_UINT32(0, ring_buf_bip_put_claim(&rb, &ptr, 1));
+
+    TEST_ASSERT_EQUAL_UINT32(6, ring_buf_bip_get_claim(&rb, &ptr, 16));
+    TEST_ASSERT_EQUAL_PTR(&buff[6], ptr);
+    for (uint32_t i = 0; i < 6; i++) {
+        TEST_ASSERT_EQUAL_UINT8(6 + i, ptr[i]);
+    }
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_bip_get_finish(&rb, 6));
+
+    TEST_ASSERT_EQUAL_UINT32(5, ring_buf_bip_get_claim(&rb, &ptr, 16));
+    TEST_ASSERT_EQUAL_PTR(buff, ptr);
+    for (uint32_t i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL_UINT8(12 + i, ptr[i]);
+    }
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_bip_get_finish(&rb, 5));
+    TEST_ASSERT_TRUE(ring_buf_bip_is_empty(&rb));
+}
+
+/**
+ * Claims without a contiguous span are refused
+ *
+ * Description:
+ * - This test verifies that a claim is refused when no contiguous span of
+ *   the requested size is free, even if enough bytes are free in total, and
+ *   that finishing more than claimed is rejected.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 16 bytes, write 12 bytes and read 4.
+ * - Claim 5 bytes, then 4 bytes.
+ * - Finish 5 bytes, then 2 bytes.
+ *
+ * Expected result:
+ * - 8 bytes are free, but the largest span is 4 bytes: the claim of 5 bytes
+ *   returns 0 and the claim of 4 bytes succeeds.
+ * - Finishing 5 bytes returns -1, finishing 2 bytes returns 0.
+ */
+void test_ring_buf_bip_refuses_split_claims(void)
+{
+    struct ring_buf_bip rb;
+    uint8_t buff[16];
+    uint8_t *ptr;
+
+    ring_buf_bip_init(&rb, sizeof(buff), buff);
+
+    TEST_ASSERT_EQUAL_UINT32(12, ring_buf_bip_put_claim(&rb, &ptr, 12));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_bip_put_finish(&rb, 12));
+    TEST_ASSERT_EQUAL_UINT32(4, ring_buf_bip_get_claim(&rb, &ptr, 4));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_bip_get_finish(&rb, 4));
+
+    TEST_ASSERT_EQUAL_UINT32(4, ring_buf_bip_space_get(&rb));
+    TEST_ASSERT_EQUAL_UINT32(0, ring_buf_bip_put_claim(&rb, &ptr, 5));
+    TEST_ASSERT_EQUAL_UINT32(4, ring_buf_bip_put_claim(&rb, &ptr, 4));
+    TEST_ASSERT_EQUAL_PTR(&buff[12], ptr);
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_bip_put_finish(&rb, 5));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_bip_put_finish(&rb, 2));
+    TEST_ASSERT_EQUAL_UINT32(10, ring_buf_bip_size_get(&rb));
+
+    TEST_ASSERT_EQUAL_UINT32(10, ring_buf_bip_get_claim(&rb, &ptr, 16));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_bip_get_finish(&rb, 11));
+    TEST_ASSERT_EQUAL_UINT32(10, ring_buf_bip_get_claim(&rb, &ptr, 16));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_bip_get_finish(&rb, 10));
+    TEST_ASSERT_TRUE(ring_buf_bip_is_empty(&rb));
+}
+
+#define BIP_TEST_FRAMES    (1u << 16)
+#define BIP_MAX_FRAME_SIZE 40u
+
+static struct ring_buf_bip bip_rb;
+static uint8_t bip_buff[128];
+
+static void *bip_producer(void *arg)
+{
+    (void) arg;
+
+    for (uint32_t sent = 0; sent < BIP_TEST_FRAMES; ) {
+        uint8_t *dst;
+        uint32_t len = 2 + sent % (BIP_MAX_FRAME_SIZE - 1);
+
+        if (ring_buf_bip_put_claim(&bip_rb, &dst, len) == 0) {
+            sched_yield();
+            continue;
+        }
+
+        dst[0] = (uint8_t) len;
+        for (uint32_t i = 1; i < len; i++) {
+            dst[i] = (uint8_t) (sent + i);
+        }
+
+        ring_buf_bip_put_finish(&bip_rb, len);
+        sent++;
+    }
+
+    return NULL;
+}
+
+static void *bip_consumer(void *arg)
+{
+    uint32_t *errors = arg;
+
+    for (uint32_t received = 0; received < BIP_TEST_FRAMES; ) {
+        uint8_t *src;
+        uint32_t len = ring_buf_bip_get_claim(&bip_rb, &src, sizeof(bip_buff));
+        uint32_t used = 0;
+
+        /* frames are never split, so each claim holds whole frames */
+        while (used < len) {
+            uint32_t frame_len = src[used];
+
+            *errors += (frame_len != 2 + received % (BIP_MAX_FRAME_SIZE - 1));
+            *errors += (used + frame_len > len);
+
+            for (uint32_t i = 1; i < frame_len && used + i < len; i++) {
+                *errors += (src[used + i] != (uint8_t) (received + i));
+            }
+
+            used += frame_len;
+            received++;
+        }
+
+        ring_buf_bip_get_finish(&bip_rb, len);
+
+        if (len == 0) {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Concurrent producer and consumer of variable size frames
+ *
+ * Description:
+ * - This test verifies that one producer thread and one consumer thread can
+ *   share a bip-buffer without locking, and that frames written with a
+ *   single claim are always read back with a single claim.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 128 bytes.
+ * - Start a producer thread writing 64k frames of 2 to 40 bytes, each in one
+ *   claim, starting with its length.
+ * - Start a consumer thread parsing frames from its claims.
+ *
+ * Expected result:
+ * - Every frame is received whole, in order and without corruption.
+ */
+void test_ring_buf_bip_concurrent_frames(void)
+{
+    uint32_t errors = 0;
+    pthread_t producer;
+    pthread_t consumer;
+
+    ring_buf_bip_init(&bip_rb, sizeof(bip_buff), bip_buff);
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&consumer, NULL, bip_consumer, &errors));
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&producer, NULL, bip_producer, NULL));
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(producer, NULL));
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(consumer, NULL));
+
+    TEST_ASSERT_EQUAL_UINT32(0, errors);
+    TEST_ASSERT_TRUE(ring_buf_bip_is_empty(&bip_rb));
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "unity.h"
+#include "ring_buffer.h"
+#include "ring_buffer_io.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+
+static int fds[2];
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, pipe(fds));
+}
+
+void tearDown(void)
+{
+    close(fds[0]);
+    close(fds[1]);
+}
+
+/**
+ * Put and get claims return both segments of a wrapped region
+ *
+ * Description:
+ * - This test verifies that the iovec claim routines return the region up
+ *   to the end of the storage and the one continuing at its beginning.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 10 bytes and move its indices to offset 6.
+ * - Claim 8 bytes for writing, fill them and finish.
+ * - Claim 8 bytes for reading.
+ *
+ * Expected result:
+ * - Both claims return 8 bytes in 2 segments of 4 bytes, the second one at
+ *   the beginning of the storage.
+ * - The data read matches the data written.
+ */
+void test_claim_iov_returns_both_segments(void)
+{
+    struct ring_buf rb;
+    uint8_t buff[10];
+    uint8_t data[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    struct iovec iov[RING_BUF_IOV_MAX];
+    int iovcnt;
+
+    ring_buf_init(&rb, sizeof(buff), buff);
+    TEST_ASSERT_EQUAL_UINT32(6, ring_buf_put(&rb, data, 6));
+    TEST_ASSERT_EQUAL_UINT32(6, ring_buf_get(&rb, NULL, 6));
+
+    TEST_ASSERT_EQUAL_UINT32(8, ring_buf_put_claim_iov(&rb, iov, &iovcnt, 8));
+    TEST_ASSERT_EQUAL_INT(2, iovcnt);
+    TEST_ASSERT_EQUAL_PTR(&buff[6], iov[0].iov_base);
+    TEST_ASSERT_EQUAL_UINT32(4, iov[0].iov_len);
+    TEST_ASSERT_EQUAL_PTR(&buff[0], iov[1].iov_base);
+    TEST_ASSERT_EQUAL_UINT32(4, iov[1].iov_len);
+
+    memcpy(iov[0].iov_base, data, 4);
+    memcpy(iov[1].iov_base, &data[4], 4);
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_put_finish(&rb, 8));
+
+    TEST_ASSERT_EQUAL_UINT32(8, ring_buf_get_claim_iov(&rb, iov, &iovcnt, 8));
+    TEST_ASSERT_EQUAL_INT(2, iovcnt);
+    TEST_ASSERT_EQUAL_MEMORY(data, iov[0].iov_base, 4);
+    TEST_ASSERT_EQUAL_MEMORY(&data[4], iov[1].iov_base, 4);
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_get_finish(&rb, 8));
+
+    TEST_ASSERT_TRUE(ring_buf_is_empty(&rb));
+}
+
+/**
+ * Claims are bounded by free space and valid data
+ *
+ * Description:
+ * - This test verifies that the iovec claim routines never return more than
+ *   the free space (for writing) or the valid data (for reading).
+ *
+ * Steps:
+ * - Initialize a ring buffer of 10 bytes and write 7 bytes.
+ * - Claim 10 bytes for writing, then 10 bytes for reading.
+ * - Fill the ring buffer and claim 1 byte for writing.
+ *
+ * Expected result:
+ * - The put claim returns 3 bytes, the get claim 7 bytes.
+ * - The last claim returns 0 bytes and no segment.
+ */
+void test_claim_iov_bounded_by_space(void)
+{
+    struct ring_buf rb;
+    uint8_t buff[10];
+    uint8_t data[10] = {0};
+    struct iovec iov[RING_BUF_IOV_MAX];
+    int iovcnt;
+
+    ring_buf_init(&rb, sizeof(buff), buff);
+    TEST_ASSERT_EQUAL_UINT32(7, ring_buf_put(&rb, data, 7));
+
+    TEST_ASSERT_EQUAL_UINT32(3, ring_buf_put_claim_iov(&rb, iov, &iovcnt, 10));
+    TEST_ASSERT_EQUAL_INT(1, iovcnt);
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_put_finish(&rb, 0));
+
+    TEST_ASSERT_EQUAL_UINT32(7, ring_buf_get_claim_iov(&rb, iov, &iovcnt, 10));
+    TEST_ASSERT_EQUAL_INT(1, iovcnt);
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_get_finish(&rb, 0));
+
+    TEST_ASSERT_EQUAL_UINT32(3, ring_buf_put(&rb, data, 3));
+    TEST_ASSERT_EQUAL_UINT32(0, ring_buf_put_claim_iov(&rb, iov, &iovcnt, 1));
+    TEST_ASSERT_EQUAL_INT(0, iovcnt);
+}
+
+/**
+ * Read from and write to a pipe across the wrap point
+ *
+ * Description:
+ * - This test verifies that ring_buf_read_fd and ring_buf_write_fd move data
+ *   between a file descriptor and both segments of a wrapped region.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 16 bytes and move its indices to offset 12.
+ * - Write 10 bytes to a pipe, then read them with ring_buf_read_fd.
+ * - Write them back to the pipe with ring_buf_write_fd and read the pipe.
+ *
+ * Expected result:
+ * - ring_buf_read_fd and ring_buf_write_fd both return 10.
+ * - The bytes read back from the pipe match the original ones.
+ * - The ring buffer is empty at the end.
+ */
+void test_read_and_write_fd_across_wrap(void)
+{
+    struct ring_buf rb;
+    uint8_t buff[16];
+    uint8_t data[10] = {0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19};
+    uint8_t read_back[10] = {0};
+
+    ring_buf_init(&rb, sizeof(buff), buff);
+    TEST_ASSERT_EQUAL_UINT32(12, ring_buf_put(&rb, buff, 12));
+    TEST_ASSERT_EQUAL_UINT32(12, ring_buf_get(&rb, NULL, 12));
+
+    TEST_ASSERT_EQUAL_INT(10, write(fds[1], data, sizeof(data)));
+    TEST_ASSERT_EQUAL_INT(10, ring_buf_read_fd(&rb, fds[0], 16));
+    TEST_ASSERT_EQUAL_UINT32(10, ring_buf_size_get(&rb));
+
+    TEST_ASSERT_EQUAL_INT(10, ring_buf_write_fd(&rb, fds[1], 16));
+    TEST_ASSERT_TRUE(ring_buf_is_empty(&rb));
+
+    TEST_ASSERT_EQUAL_INT(10, read(fds[0], read_back, sizeof(read_back)));
+    TEST_ASSERT_EQUAL_MEMORY(data, read_back, sizeof(data));
+}
+
+/**
+ * Partial read keeps the rest of the claim free
+ *
+ * Description:
+ * - This test verifies that only the bytes actually read are committed, and
+ *   that nothing is read when the ring buffer is full.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 8 bytes.
+ * - Write 3 bytes to a pipe and call ring_buf_read_fd for 8 bytes.
+ * - Fill the ring buffer and call ring_buf_read_fd again.
+ *
+ * Expected result:
+ * - The first call returns 3 and 5 bytes of space remain.
+ * - The second call returns -1 with errno set to ENOBUFS and leaves the
+ *   pipe untouched.
+ */
+void test_read_fd_partial_and_full(void)
+{
+    struct ring_buf rb;
+    uint8_t buff[8];
+    uint8_t data[5] = {1, 2, 3, 4, 5};
+
+    ring_buf_init(&rb, sizeof(buff), buff);
+
+    TEST_ASSERT_EQUAL_INT(3, write(fds[1], data, 3));
+    TEST_ASSERT_EQUAL_INT(3, ring_buf_read_fd(&rb, fds[0], 8));
+    TEST_ASSERT_EQUAL_UINT32(5, ring_buf_space_get(&rb));
+
+    TEST_ASSERT_EQUAL_UINT32(5, ring_buf_put(&rb, data, 5));
+    TEST_ASSERT_EQUAL_INT(1, write(fds[1], data, 1));
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, ring_buf_read_fd(&rb, fds[0], 8));
+    TEST_ASSERT_EQUAL_INT(ENOBUFS, errno);
+    TEST_ASSERT_EQUAL_UINT32(8, ring_buf_size_get(&rb));
+    TEST_ASSERT_EQUAL_INT(1, read(fds[0], data, sizeof(data)));
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "unity.h"
+#include "ring_buffer.h"
+#include "ring_buffer_mirror.h"
+
+#include <string.h>
+
+
+static struct ring_buf rb;
+static uint32_t page_size;
+
+void setUp(void)
+{
+    page_size = ring_buf_mirror_size_align(1);
+    TEST_ASSERT_TRUE(page_size > 0);
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_mirror_init(&rb, page_size));
+}
+
+void tearDown(void)
+{
+    ring_buf_mirror_free(&rb);
+}
+
+/**
+ * Validate size alignment and rejected sizes
+ *
+ * Description:
+ * - This test verifies that sizes are rounded up to whole pages and that
+ *   ring_buf_mirror_init rejects sizes that are not a multiple of a page.
+ *
+ * Steps:
+ * - Align a few sizes with ring_buf_mirror_size_align.
+ * - Initialize a mirrored ring buffer of 0 bytes and of page size + 1 bytes.
+ *
+ * Expected result:
+ * - Sizes are rounded up to the next page multiple.
+ * - Both initializations return -1.
+ */
+void test_mirror_size_alignment(void)
+{
+    struct ring_buf other;
+
+    TEST_ASSERT_EQUAL_UINT32(page_size, ring_buf_mirror_size_align(page_size));
+    TEST_ASSERT_EQUAL_UINT32(2 * page_size, ring_buf_mirror_size_align(page_size + 1));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_mirror_init(&other, 0));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_mirror_init(&other, page_size + 1));
+}
+
+/**
+ * Validate storage is mirrored
+ *
+ * Description:
+ * - This test verifies that both halves of the mapping share the same
+ *   memory.
+ *
+ * Steps:
+ * - Initialize a mirrored ring buffer of one page.
+ * - Write through a claim in the first half and read the second half.
+ *
+ * Expected result:
+ * - Bytes written in the first half are visible in the second half.
+ */
+void test_mirror_storage_is_shared(void)
+{
+    uint8_t *dst;
+
+    TEST_ASSERT_EQUAL_UINT32(page_size, ring_buf_capacity_get(&rb));
+    TEST_ASSERT_EQUAL_UINT32(4, ring_buf_put_claim(&rb, &dst, 4));
+    memcpy(dst, "\x01\x02\x03\x04", 4);
+
+    TEST_ASSERT_EQUAL_MEMORY("\x01\x02\x03\x04", dst + page_size, 4);
+}
+
+/**
+ * Claims are contiguous across the wrap point
+ *
+ * Description:
+ * - This test verifies that put and get claims are not truncated at the end
+ *   of the storage.
+ *
+ * Steps:
+ * - Initialize a mirrored ring buffer of one page.
+ * - Move the indices to 16 bytes before the end of the storage.
+ * - Claim 64 bytes for writing, fill them and finish.
+ * - Claim 64 bytes for reading.
+ *
+ * Expected result:
+ * - Both claims return 64 bytes in a single contiguous region.
+ * - The data read matches the data written, including the bytes stored at
+ *   the beginning of the storage.
+ */
+void test_mirror_claims_do_not_split_at_wrap(void)
+{
+    uint8_t *dst;
+    uint8_t *src;
+    uint8_t pattern[64];
+
+    for (uint32_t i = 0; i < sizeof(pattern); i++) {
+        pattern[i] = (uint8_t) (i + 1);
+    }
+
+    /* advance to 16 bytes before the wrap point */
+    TEST_ASSERT_EQUAL_UINT32(page_size - 16, ring_buf_put_claim(&rb, &dst, page_size - 16));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_put_finish(&rb, page_size - 16));
+    TEST_ASSERT_EQUAL_UINT32(page_size - 16, ring_buf_get(&rb, NULL, page_size - 16));
+
+    TEST_ASSERT_EQUAL_UINT32(sizeof(pattern), ring_buf_put_claim(&rb, &dst, sizeof(pattern)));
+    memcpy(dst, pattern, sizeof(pattern));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_put_finish(&rb, sizeof(pattern)));
+
+    TEST_ASSERT_EQUAL_UINT32(sizeof(pattern), ring_buf_get_claim(&rb, &src, sizeof(pattern)));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, src, sizeof(pattern));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_get_finish(&rb, sizeof(pattern)));
+
+    TEST_ASSERT_TRUE(ring_buf_is_empty(&rb));
+}
+
+/**
+ * Claims are bounded by free space and valid data
+ *
+ * Description:
+ * - This test verifies that mirroring only removes the wrap limit: claims
+ *   still never exceed the free space or the valid data.
+ *
+ * Steps:
+ * - Initialize a mirrored ring buffer of one page.
+ * - Write half a page, read a quarter page.
+ * - Claim a full page for writing, then a full page for reading.
+ *
+ * Expected result:
+ * - The put claim returns the free space (three quarters of a page).
+ * - The get claim returns the valid data (a quarter of a page).
+ */
+void test_mirror_claims_bounded_by_space(void)
+{
+    uint8_t *ptr;
+
+    TEST_ASSERT_EQUAL_UINT32(page_size / 2, ring_buf_put_claim(&rb, &ptr, page_size / 2));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_put_finish(&rb, page_size / 2));
+    TEST_ASSERT_EQUAL_UINT32(page_size / 4, ring_buf_get(&rb, NULL, page_size / 4));
+
+    TEST_ASSERT_EQUAL_UINT32(3 * page_size / 4, ring_buf_put_claim(&rb, &ptr, page_size));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_put_finish(&rb, 0));
+
+    TEST_ASSERT_EQUAL_UINT32(page_size / 4, ring_buf_get_claim(&rb, &ptr, page_size));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_get_finish(&rb, 0));
+}
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "unity.h"
+#include "ring_buffer_mpmc.h"
+
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+
+/**
+ * Single write and single read (basic functionality test)
+ *
+ * Description:
+ * - This test ensures that an item written to a MPMC ring buffer is read
+ *   back with the same type, value, length and payload.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 4 slots of up to 9 32-bit words.
+ * - Write 1 item of 9 32-bit words.
+ * - Read 1 item.
+ *
+ * Expected result:
+ * - The item read matches the item written.
+ * - The ring buffer is empty afterwards.
+ */
+void test_mpmc_single_write_and_single_read(void)
+{
+    struct ring_buf_mpmc rb;
+    uint32_t buff[RING_BUF_MPMC_BUFFER_SIZE32(4, 9)];
+    uint32_t data[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    uint32_t read[9] = {0};
+
+    ring_buf_mpmc_item_init(&rb, 4, 9, buff);
+
+    TEST_ASSERT_TRUE(ring_buf_mpmc_is_empty(&rb));
+    TEST_ASSERT_EQUAL_UINT32(4, ring_buf_mpmc_capacity_get(&rb));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_mpmc_item_put(&rb, 19, 8, data, 9));
+    TEST_ASSERT_FALSE(ring_buf_mpmc_is_empty(&rb));
+
+    uint16_t type = 0;
+    uint8_t value = 0;
+    uint8_t read_len = 9;
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_mpmc_item_get(&rb, &type, &value, read, &read_len));
+    TEST_ASSERT_EQUAL_UINT16(19, type);
+    TEST_ASSERT_EQUAL_UINT8(8, value);
+    TEST_ASSERT_EQUAL_UINT8(9, read_len);
+    TEST_ASSERT_EQUAL_MEMORY(data, read, sizeof(data));
+
+    TEST_ASSERT_TRUE(ring_buf_mpmc_is_empty(&rb));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_mpmc_item_get(&rb, &type, &value, read, &read_len));
+}
+
+/**
+ * Reject items and reads that do not fit
+ *
+ * Description:
+ * - This test ensures that items larger than a slot are rejected and that a
+ *   read into a too small area reports the required size without removing
+ *   the item.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 2 slots of up to 4 32-bit words.
+ * - Write 1 item of 5 32-bit words (which should fail).
+ * - Write 1 item of 4 32-bit words.
+ * - Read it into an area of 2 32-bit words (which should fail).
+ * - Read it into an area of 4 32-bit words.
+ *
+ * Expected result:
+ * - ring_buf_mpmc_item_put returns -1 for the oversized item.
+ * - ring_buf_mpmc_item_get returns -2 and size32 is set to 4.
+ * - The second read returns the item intact.
+ */
+void test_mpmc_oversized_item_and_small_read_area(void)
+{
+    struct ring_buf_mpmc rb;
+    uint32_t buff[RING_BUF_MPMC_BUFFER_SIZE32(2, 4)];
+    uint32_t data[5] = {1, 2, 3, 4, 5};
+    uint32_t read[4] = {0};
+
+    ring_buf_mpmc_item_init(&rb, 2, 4, buff);
+
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_mpmc_item_put(&rb, 1, 2, data, 5));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_mpmc_item_put(&rb, 1, 2, data, 4));
+
+    uint16_t type = 0;
+    uint8_t value = 0;
+    uint8_t read_len = 2;
+    TEST_ASSERT_EQUAL_INT32(-2, ring_buf_mpmc_item_get(&rb, &type, &value, read, &read_len));
+    TEST_ASSERT_EQUAL_UINT8(4, read_len);
+    TEST_ASSERT_FALSE(ring_buf_mpmc_is_empty(&rb));
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_mpmc_item_get(&rb, &type, &value, read, &read_len));
+    TEST_ASSERT_EQUAL_UINT16(1, type);
+    TEST_ASSERT_EQUAL_UINT8(2, value);
+    TEST_ASSERT_EQUAL_UINT8(4, read_len);
+    TEST_ASSERT_EQUAL_MEMORY(data, read, 4 * sizeof(uint32_t));
+}
+
+/**
+ * Fill buffer and wrap around
+ *
+ * Description:
+ * - This test confirms that the ring buffer holds exactly as many items as
+ *   slots, rejects further writes, and keeps FIFO order over several laps.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 4 slots of up to 1 32-bit word.
+ * - Repeat 3 times: write 4 items, attempt a fifth one (which should fail),
+ *   then read all items back.
+ *
+ * Expected result:
+ * - The fifth write returns -2.
+ * - Items are read in the order they were written.
+ */
+void test_mpmc_fill_and_wraparound(void)
+{
+    struct ring_buf_mpmc rb;
+    uint32_t buff[RING_BUF_MPMC_BUFFER_SIZE32(4, 1)];
+
+    ring_buf_mpmc_item_init(&rb, 4, 1, buff);
+
+    for (uint32_t lap = 0; lap < 3; lap++) {
+        for (uint32_t i = 0; i < 4; i++) {
+            uint32_t word = lap * 4 + i;
+            TEST_ASSERT_EQUAL_INT32(0, ring_buf_mpmc_item_put(&rb, (uint16_t) word, 0, &word, 1));
+        }
+
+        uint32_t extra = 0xdead;
+        TEST_ASSERT_EQUAL_INT32(-2, ring_buf_mpmc_item_put(&rb, 0, 0, &extra, 1));
+
+        for (uint32_t i = 0; i < 4; i++) {
+            uint32_t word = 0;
+            uint16_t type = 0;
+            uint8_t value = 0;
+            uint8_t read_len = 1;
+
+            TEST_ASSERT_EQUAL_INT32(0, ring_buf_mpmc_item_get(&rb, &type, &value, &word, &read_len));
+            TEST_ASSERT_EQUAL_UINT32(lap * 4 + i, word);
+            TEST_ASSERT_EQUAL_UINT16(lap * 4 + i, type);
+        }
+
+        TEST_ASSERT_TRUE(ring_buf_mpmc_is_empty(&rb));
+    }
+}
+
+#define MPMC_THREADS          4u
+#define MPMC_ITEMS_PER_THREAD 100000u
+
+struct mpmc_consumer_result {
+    struct ring_buf_mpmc *rb;
+    uint32_t last_seq[MPMC_THREADS];
+    uint32_t received;
+    uint32_t errors;
+};
+
+static struct ring_buf_mpmc mpmc_rb;
+static uint32_t mpmc_buff[RING_BUF_MPMC_BUFFER_SIZE32(64, 3)];
+static uint32_t mpmc_received_total;
+
+static void *mpmc_producer(void *arg)
+{
+    uint16_t id = (uint16_t) (uintptr_t) arg;
+
+    for (uint32_t seq = 1; seq <= MPMC_ITEMS_PER_THREAD; ) {
+        uint32_t data[3] = {seq, ~seq, seq * 3u};
+
+        if (ring_buf_mpmc_item_put(&mpmc_rb, id, (uint8_t) seq, data, (uint8_t) (1u + seq % 3u)) == 0) {
+            seq++;
+        } else {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void *mpmc_consumer(void *arg)
+{
+    struct mpmc_consumer_result *result = arg;
+
+    while (__atomic_load_n(&mpmc_received_total, __ATOMIC_RELAXED) <
+           MPMC_THREADS * MPMC_ITEMS_PER_THREAD) {
+        uint32_t data[3];
+        uint16_t type;
+        uint8_t value;
+        uint8_t size32 = 3;
+
+        if (ring_buf_mpmc_item_get(result->rb, &type, &value, data, &size32) != 0) {
+            sched_yield();
+            continue;
+        }
+
+        uint32_t seq = data[0];
+
+        result->errors += (type >= MPMC_THREADS);
+        result->errors += (value != (uint8_t) seq);
+        result->errors += (size32 != 1u + seq % 3u);
+        result->errors += (size32 > 1 && data[1] != ~seq);
+        result->errors += (size32 > 2 && data[2] != seq * 3u);
+        /* items of one producer must be seen in order by every consumer */
+        result->errors += (type < MPMC_THREADS && seq <= result->last_seq[type]);
+
+        if (type < MPMC_THREADS) {
+            result->last_seq[type] = seq;
+        }
+
+        result->received++;
+        __atomic_add_fetch(&mpmc_received_total, 1, __ATOMIC_RELAXED);
+    }
+
+    return NULL;
+}
+
+/**
+ * Concurrent multi-producer/multi-consumer stress test
+ *
+ * Description:
+ * - This test verifies that several producer and consumer threads can use
+ *   the same ring buffer without locking, without losing, duplicating or
+ *   corrupting items.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 64 slots of up to 3 32-bit words.
+ * - Start 4 producer threads, each writing 100000 numbered items.
+ * - Start 4 consumer threads reading until all items are received.
+ *
+ * Expected result:
+ * - Every item is received exactly once with a valid payload.
+ * - Each consumer sees the items of a given producer in increasing order.
+ */
+void test_mpmc_concurrent_producers_and_consumers(void)
+{
+    pthread_t producers[MPMC_THREADS];
+    pthread_t consumers[MPMC_THREADS];
+    struct mpmc_consumer_result results[MPMC_THREADS];
+
+    ring_buf_mpmc_item_init(&mpmc_rb, 64, 3, mpmc_buff);
+    mpmc_received_total = 0;
+
+    for (uint32_t i = 0; i < MPMC_THREADS; i++) {
+        memset(&results[i], 0, sizeof(results[i]));
+        results[i].rb = &mpmc_rb;
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&consumers[i], NULL, mpmc_consumer, &results[i]));
+    }
+
+    for (uint32_t i = 0; i < MPMC_THREADS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&producers[i], NULL, mpmc_producer,
+                                                (void *) (uintptr_t) i));
+    }
+
+    uint32_t received = 0;
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < MPMC_THREADS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_join(producers[i], NULL));
+    }
+
+    for (uint32_t i = 0; i < MPMC_THREADS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_join(consumers[i], NULL));
+        received += results[i].received;
+        errors += results[i].errors;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, errors);
+    TEST_ASSERT_EQUAL_UINT32(MPMC_THREADS * MPMC_ITEMS_PER_THREAD, received);
+    TEST_ASSERT_TRUE(ring_buf_mpmc_is_empty(&mpmc_rb));
+}
@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define _GNU_SOURCE
+
+#include "unity.h"
+#include "ring_buffer_persist.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+
+static char path[] = "/tmp/test_ring_buf_persist_XXXXXX";
+
+void setUp(void)
+{
+    int fd;
+
+    strcpy(path, "/tmp/test_ring_buf_persist_XXXXXX");
+    fd = mkstemp(path);
+    TEST_ASSERT_TRUE(fd >= 0);
+    close(fd);
+}
+
+void tearDown(void)
+{
+    unlink(path);
+}
+
+/**
+ * Committed data is recovered on reopen
+ *
+ * Description:
+ * - This test verifies that data committed to a file-backed ring buffer is
+ *   found again, from the last read position, once the file is reopened.
+ *
+ * Steps:
+ * - Open a ring buffer of 16 bytes on an empty file.
+ * - Write 12 bytes, read 8, write 10 more (across the wrap point), close.
+ * - Reopen the file and read everything.
+ *
+ * Expected result:
+ * - The reopened ring buffer holds the 14 unread bytes, in order.
+ */
+void test_ring_buf_persist_recovers_committed_data(void)
+{
+    struct ring_buf_persist prb;
+    uint8_t data[22];
+    uint8_t read[16];
+
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t) (i + 1);
+    }
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_persist_open(&prb, path, 16,
+                                                     RING_BUF_PERSIST_SYNC_COMMIT, 0));
+    TEST_ASSERT_TRUE(ring_buf_is_empty(&prb.rb));
+    TEST_ASSERT_EQUAL_UINT32(12, ring_buf_persist_put(&prb, data, 12));
+    TEST_ASSERT_EQUAL_UINT32(8, ring_buf_persist_get(&prb, read, 8));
+    TEST_ASSERT_EQUAL_UINT32(10, ring_buf_persist_put(&prb, &data[12], 10));
+    ring_buf_persist_close(&prb);
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_persist_open(&prb, path, 16,
+                                                     RING_BUF_PERSIST_SYNC_COMMIT, 0));
+    TEST_ASSERT_EQUAL_UINT32(14, ring_buf_size_get(&prb.rb));
+    TEST_ASSERT_EQUAL_UINT32(14, ring_buf_persist_get(&prb, read, sizeof(read)));
+    TEST_ASSERT_EQUAL_MEMORY(&data[8], read, 14);
+    TEST_ASSERT_TRUE(ring_buf_is_empty(&prb.rb));
+    ring_buf_persist_close(&prb);
+}
+
+/**
+ * Data survives a process that exits without closing
+ *
+ * Description:
+ * - This test verifies that commits are recorded in the file as they
+ *   happen, so a producer process that dies does not lose them, while data
+ *   claimed but not committed is not recovered.
+ *
+ * Steps:
+ * - In a child process, open the ring buffer without flushing, write
+ *   6 bytes through a claim, claim 4 more without committing, then exit
+ *   without closing.
+ * - Reopen the file in the parent.
+ *
+ * Expected result:
+ * - The parent reads back the 6 committed bytes only.
+ */
+void test_ring_buf_persist_survives_process_exit(void)
+{
+    struct ring_buf_persist prb;
+    uint8_t read[16];
+    int status;
+
+    pid_t pid = fork();
+    TEST_ASSERT_TRUE(pid >= 0);
+
+    if (pid == 0) {
+        uint8_t *dst;
+
+        if (ring_buf_persist_open(&prb, path, 16, RING_BUF_PERSIST_SYNC_NONE, 0) != 0 ||
+            ring_buf_put_claim(&prb.rb, &dst, 6) != 6) {
+            _exit(1);
+        }
+
+        memcpy(dst, "abcdef", 6);
+        ring_buf_persist_put_finish(&prb, 6);
+        ring_buf_put_claim(&prb.rb, &dst, 4);
+        memcpy(dst, "ghij", 4);
+        _exit(0);
+    }
+
+    TEST_ASSERT_EQUAL_INT(pid, waitpid(pid, &status, 0));
+    TEST_ASSERT_TRUE(WIFEXITED(status));
+    TEST_ASSERT_EQUAL_INT(0, WEXITSTATUS(status));
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_persist_open(&prb, path, 16,
+                                                     RING_BUF_PERSIST_SYNC_NONE, 0));
+    TEST_ASSERT_EQUAL_UINT32(6, ring_buf_persist_get(&prb, read, sizeof(read)));
+    TEST_ASSERT_EQUAL_MEMORY("abcdef", read, 6);
+    ring_buf_persist_close(&prb);
+}
+
+/**
+ * Commits are recorded by flushes
+ *
+ * Description:
+ * - This test verifies that, when flushing is not left to the operating
+ *   system, commits are only recorded in the file by flushes, and that a
+ *   read position ahead of the recorded commits is recovered.
+ *
+ * Steps:
+ * - Open the ring buffer flushing every 100 bytes, write 10 bytes and read
+ *   4 of them.
+ * - Open the file a second time, then close that copy.
+ * - Flush the first copy and open the file a third time.
+ *
+ * Expected result:
+ * - The second copy is empty.
+ * - The third copy holds the 6 unread bytes.
+ */
+void test_ring_buf_persist_records_commits_on_flush(void)
+{
+    struct ring_buf_persist prb;
+    struct ring_buf_persist copy;
+    uint8_t data[10];
+    uint8_t read[10];
+
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t) (i + 1);
+    }
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_persist_open(&prb, path, 16,
+                                                     RING_BUF_PERSIST_SYNC_BYTES, 100));
+    TEST_ASSERT_EQUAL_UINT32(10, ring_buf_persist_put(&prb, data, 10));
+    TEST_ASSERT_EQUAL_UINT32(4, ring_buf_persist_get(&prb, read, 4));
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_persist_open(&copy, path, 16,
+                                                     RING_BUF_PERSIST_SYNC_BYTES, 100));
+    TEST_ASSERT_TRUE(ring_buf_is_empty(&copy.rb));
+    ring_buf_persist_close(&copy);
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_persist_sync(&prb));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_persist_open(&copy, path, 16,
+                                                     RING_BUF_PERSIST_SYNC_BYTES, 100));
+    TEST_ASSERT_EQUAL_UINT32(6, ring_buf_persist_get(&copy, read, sizeof(read)));
+    TEST_ASSERT_EQUAL_MEMORY(&data[4], read, 6);
+    ring_buf_persist_close(&copy);
+    ring_buf_persist_close(&prb);
+}
+
+/**
+ * Flush policies
+ *
+ * Description:
+ * - This test verifies when each policy flushes committed bytes.
+ *
+ * Steps:
+ * - Open the ring buffer flushing every 10 bytes, write 4 then 6 bytes.
+ * - Reopen it flushing on every commit, write 1 byte.
+ * - Reopen it flushing every hour, write 1 byte.
+ * - Reopen it flushing every 0 ms, write 1 byte.
+ *
+ * Expected result:
+ * - 4 bytes are pending after the first write, none after the second.
+ * - Nothing is pending after a commit when flushing on every commit or
+ *   every 0 ms, 1 byte is pending when flushing every hour.
+ */
+void test_ring_buf_persist_sync_policies(void)
+{
+    struct ring_buf_persist prb;
+    uint8_t data[10] = {0};
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_persist_open(&prb, path, 64,
+                                                     RING_BUF_PERSIST_SYNC_BYTES, 10));
+    TEST_ASSERT_EQUAL_UINT32(4, ring_buf_persist_put(&prb, data, 4));
+    TEST_ASSERT_EQUAL_UINT32(4, ring_buf_persist_unsynced_get(&prb));
+    TEST_ASSERT_EQUAL_UINT32(6, ring_buf_persist_put(&prb, data, 6));
+    TEST_ASSERT_EQUAL_UINT32(0, ring_buf_persist_unsynced_get(&prb));
+    ring_buf_persist_close(&prb);
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_persist_open(&prb, path, 64,
+                                                     RING_BUF_PERSIST_SYNC_COMMIT, 0));
+    TEST_ASSERT_EQUAL_UINT32(1, ring_buf_persist_put(&prb, data, 1));
+    TEST_ASSERT_EQUAL_UINT32(0, ring_buf_persist_unsynced_get(&prb));
+    ring_buf_persist_close(&prb);
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_persist_open(&prb, path, 64,
+                                                     RING_BUF_PERSIST_SYNC_TIME, 3600000));
+    TEST_ASSERT_EQUAL_UINT32(1, ring_buf_persist_put(&prb, data, 1));
+    TEST_ASSERT_EQUAL_UINT32(1, ring_buf_persist_unsynced_get(&prb));
+    ring_buf_persist_close(&prb);
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_persist_open(&prb, path, 64,
+                                                     RING_BUF_PERSIST_SYNC_TIME, 0));
+    TEST_ASSERT_EQUAL_UINT32(1, ring_buf_persist_put(&prb, data, 1));
+    TEST_ASSERT_EQUAL_UINT32(0, ring_buf_persist_unsynced_get(&prb));
+    TEST_ASSERT_EQUAL_UINT32(13, ring_buf_size_get(&prb.rb));
+    ring_buf_persist_close(&prb);
+}
+
+/**
+ * An interrupted creation is recovered
+ *
+ * Description:
+ * - This test verifies that a file left sized but with a blank header, as
+ *   by a crash between its creation and the first header flush, is
+ *   initialized again instead of being rejected.
+ *
+ * Steps:
+ * - Size the file to one page plus 16 bytes of zeros.
+ * - Open it as a ring buffer of 16 bytes, write 5 bytes and close.
+ * - Reopen it and read everything.
+ *
+ * Expected result:
+ * - The first open succeeds with an empty ring buffer.
+ * - The reopened ring buffer holds the 5 bytes written.
+ */
+void test_ring_buf_persist_recovers_interrupted_creation(void)
+{
+    struct ring_buf_persist prb;
+    uint8_t data[5] = {1, 2, 3, 4, 5};
+    uint8_t read[16];
+
+    TEST_ASSERT_EQUAL_INT(0, truncate(path, sysconf(_SC_PAGESIZE) + 16));
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_persist_open(&prb, path, 16,
+                                                     RING_BUF_PERSIST_SYNC_COMMIT, 0));
+    TEST_ASSERT_TRUE(ring_buf_is_empty(&prb.rb));
+    TEST_ASSERT_EQUAL_UINT32(5, ring_buf_persist_put(&prb, data, sizeof(data)));
+    ring_buf_persist_close(&prb);
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_persist_open(&prb, path, 16,
+                                                     RING_BUF_PERSIST_SYNC_COMMIT, 0));
+    TEST_ASSERT_EQUAL_UINT32(5, ring_buf_persist_get(&prb, read, sizeof(read)));
+    TEST_ASSERT_EQUAL_MEMORY(data, read, sizeof(data));
+    ring_buf_persist_close(&prb);
+}
+
+/**
+ * Incompatible files are rejected
+ *
+ * Description:
+ * - This test verifies that invalid arguments, a size mismatch and a
+ *   corrupted header are reported instead of recovering garbage.
+ *
+ * Steps:
+ * - Open with size 0 and with an unknown policy.
+ * - Create a ring buffer of 16 bytes, then reopen it as 32 bytes.
+ * - Overwrite the first byte of the file, then reopen it as 16 bytes.
+ *
+ * Expected result:
+ * - Every open returns -1.
+ */
+void test_ring_buf_persist_rejects_incompatible_files(void)
+{
+    struct ring_buf_persist prb;
+
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_persist_open(&prb, path, 0,
+                                                      RING_BUF_PERSIST_SYNC_NONE, 0));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_persist_open(&prb, path, 16, 42, 0));
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_persist_open(&prb, path, 16,
+                                                     RING_BUF_PERSIST_SYNC_NONE, 0));
+    ring_buf_persist_close(&prb);
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_persist_open(&prb, path, 32,
+                                                      RING_BUF_PERSIST_SYNC_NONE, 0));
+
+    FILE *file = fopen(path, "r+b");
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL_INT(0, fputc(0, file));
+    fclose(file);
+
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_persist_open(&prb, path, 16,
+                                                      RING_BUF_PERSIST_SYNC_NONE, 0));
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "unity.h"
+#include "ring_buffer_pow2.h"
+
+#include <string.h>
+
+
+RING_BUF_DECLARE_POW2(small_rb, 8);
+RING_BUF_DECLARE_POW2(large_rb, 4096);
+
+void setUp(void)
+{
+    small_rb_reset();
+    large_rb_reset();
+}
+
+/**
+ * Validate initial state
+ *
+ * Description:
+ * - This test verifies that a declared ring buffer starts empty with its
+ *   whole capacity free.
+ *
+ * Steps:
+ * - Read the state of a ring buffer declared with 8 bytes.
+ *
+ * Expected result:
+ * - The ring buffer is empty, with 8 bytes free and 0 bytes used.
+ */
+void test_pow2_initial_state(void)
+{
+    TEST_ASSERT_TRUE(small_rb_is_empty());
+    TEST_ASSERT_EQUAL_UINT32(8, small_rb_space_get());
+    TEST_ASSERT_EQUAL_UINT32(0, small_rb_size_get());
+    TEST_ASSERT_EQUAL_UINT32(4096, large_rb_space_get());
+}
+
+/**
+ * Write and read over several laps
+ *
+ * Description:
+ * - This test verifies that data written with put is read back intact
+ *   with get while the indices wrap around the storage many times.
+ *
+ * Steps:
+ * - Repeat 100 times: write 5 bytes, peek them, then read them back, on a
+ *   ring buffer of 8 bytes.
+ *
+ * Expected result:
+ * - Every put and get moves 5 bytes and the data matches.
+ * - The ring buffer is empty at the end.
+ */
+void test_pow2_put_get_wraparound(void)
+{
+    for (uint32_t lap = 0; lap < 100; lap++) {
+        uint8_t data[5];
+        uint8_t read[5] = {0};
+
+        for (uint32_t i = 0; i < sizeof(data); i++) {
+            data[i] = (uint8_t) (lap * 5 + i);
+        }
+
+        TEST_ASSERT_EQUAL_UINT32(5, small_rb_put(data, sizeof(data)));
+        TEST_ASSERT_EQUAL_UINT32(5, small_rb_peek(read, sizeof(read)));
+        TEST_ASSERT_EQUAL_MEMORY(data, read, sizeof(data));
+
+        memset(read, 0, sizeof(read));
+        TEST_ASSERT_EQUAL_UINT32(5, small_rb_get(read, sizeof(read)));
+        TEST_ASSERT_EQUAL_MEMORY(data, read, sizeof(data));
+    }
+
+    TEST_ASSERT_TRUE(small_rb_is_empty());
+}
+
+/**
+ * Write more than capacity
+ *
+ * Description:
+ * - This test verifies that put only stores what fits and get only returns
+ *   what is stored.
+ *
+ * Steps:
+ * - Write 10 bytes to a ring buffer of 8 bytes.
+ * - Read 10 bytes.
+ *
+ * Expected result:
+ * - put returns 8 and the ring buffer is full.
+ * - get returns 8 with the first 8 bytes written.
+ */
+void test_pow2_write_more_than_capacity(void)
+{
+    uint8_t data[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    uint8_t read[10] = {0};
+
+    TEST_ASSERT_EQUAL_UINT32(8, small_rb_put(data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT32(0, small_rb_space_get());
+
+    TEST_ASSERT_EQUAL_UINT32(8, small_rb_get(read, sizeof(read)));
+    TEST_ASSERT_EQUAL_MEMORY(data, read, 8);
+}
+
+/**
+ * Claims stop at the wrap point
+ *
+ * Description:
+ * - This test verifies that claims behave as ring_buf_put_claim and
+ *   ring_buf_get_claim: they stop at the end of the storage, and finishing
+ *   more than claimed is rejected.
+ *
+ * Steps:
+ * - Write and read 6 bytes on a ring buffer of 8 bytes.
+ * - Claim 5 bytes for writing twice, then finish 6 bytes.
+ * - Claim 6 bytes for reading twice, then finish 7 bytes and 6 bytes.
+ *
+ * Expected result:
+ * - Claims return 2 then 3 bytes, the second one at the start of storage.
+ * - Finishing 7 bytes returns -1, finishing 6 bytes returns 0.
+ */
+void test_pow2_claims_stop_at_wrap(void)
+{
+    uint8_t data[6] = {0};
+    uint8_t *first;
+    uint8_t *second;
+
+    TEST_ASSERT_EQUAL_UINT32(6, small_rb_put(data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT32(6, small_rb_get(NULL, sizeof(data)));
+
+    TEST_ASSERT_EQUAL_UINT32(2, small_rb_put_claim(&first, 5));
+    TEST_ASSERT_EQUAL_UINT32(3, small_rb_put_claim(&second, 3));
+    TEST_ASSERT_EQUAL_PTR(small_rb_buffer, second);
+    TEST_ASSERT_EQUAL_INT32(-1, small_rb_put_finish(6));
+    TEST_ASSERT_EQUAL_INT32(0, small_rb_put_finish(5));
+
+    TEST_ASSERT_EQUAL_UINT32(2, small_rb_get_claim(&first, 6));
+    TEST_ASSERT_EQUAL_UINT32(3, small_rb_get_claim(&second, 6));
+    TEST_ASSERT_EQUAL_INT32(-1, small_rb_get_finish(6));
+    TEST_ASSERT_EQUAL_INT32(0, small_rb_get_finish(5));
+
+    TEST_ASSERT_TRUE(small_rb_is_empty());
+}
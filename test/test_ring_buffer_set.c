@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "unity.h"
+#include "ring_buffer_set.h"
+
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+
+#define SET_RINGS     200u
+#define SET_RING_SIZE 16u
+
+static struct ring_buf_set set;
+static struct ring_buf rings[SET_RINGS];
+static uint8_t storage[SET_RINGS][SET_RING_SIZE];
+
+void setUp(void)
+{
+    ring_buf_set_init(&set);
+
+    for (uint32_t i = 0; i < SET_RINGS; i++) {
+        ring_buf_init(&rings[i], SET_RING_SIZE, storage[i]);
+        TEST_ASSERT_EQUAL_INT32(0, ring_buf_set_add(&set, i, &rings[i]));
+    }
+}
+
+/**
+ * Ring buffers holding data are returned by priority
+ *
+ * Description:
+ * - This test verifies that ring_buf_set_next returns the lowest slot
+ *   holding data, until it is drained, and skips idle ring buffers.
+ *
+ * Steps:
+ * - Add 200 empty ring buffers to a set.
+ * - Write to the ring buffers of slots 150, 3 and 77, notifying the set.
+ * - Notify slot 5 without writing to it.
+ * - Call ring_buf_set_next, draining the returned ring buffer one byte at a
+ *   time.
+ *
+ * Expected result:
+ * - Slot 3 is returned until drained, then slot 77, then slot 150.
+ * - Slot 5 is never returned, and -1 is returned once all are drained.
+ */
+void test_ring_buf_set_next_by_priority(void)
+{
+    static const uint32_t slots[] = {150, 3, 77};
+    static const int32_t expected[] = {3, 3, 77, 77, 150, 150};
+    uint8_t data[2] = {1, 2};
+
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_set_next(&set));
+
+    for (uint32_t i = 0; i < sizeof(slots) / sizeof(slots[0]); i++) {
+        TEST_ASSERT_EQUAL_UINT32(2, ring_buf_put(&rings[slots[i]], data, sizeof(data)));
+        ring_buf_set_notify(&set, slots[i]);
+    }
+    ring_buf_set_notify(&set, 5);
+
+    for (uint32_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        int32_t index = ring_buf_set_next(&set);
+
+        TEST_ASSERT_EQUAL_INT32(expected[i], index);
+        TEST_ASSERT_EQUAL_UINT32(1, ring_buf_get(&rings[index], NULL, 1));
+    }
+
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_set_next(&set));
+}
+
+/**
+ * Add and remove ring buffers
+ *
+ * Description:
+ * - This test verifies slot checks of ring_buf_set_add and
+ *   ring_buf_set_notify, and that ring buffers are found when they hold data before being added and ignored
+ *   once removed.
+ *
+ * Steps:
+ * - Add a ring buffer to slot 256 and to the used slot 10, and notify
+ *   slot 256.
+ * - Remove slot 10, write to its ring buffer and add it to slot 10 again.
+ * - Remove it again.
+ *
+ * Expected result:
+ * - Both first additions return -1, and the notification is ignored.
+ * - The re-added ring buffer is returned by ring_buf_set_next, and no
+ *   slot is returned once it is removed.
+ */
+void test_ring_buf_set_add_and_remove(void)
+{
+    uint8_t data = 0;
+
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_set_add(&set, RING_BUF_SET_MAX_RINGS, &rings[0]));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_set_add(&set, 10, &rings[0]));
+    ring_buf_set_notify(&set, RING_BUF_SET_MAX_RINGS);
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_set_next(&set));
+
+    ring_buf_set_remove(&set, 10);
+    TEST_ASSERT_EQUAL_UINT32(1, ring_buf_put(&rings[10], &data, 1));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_set_next(&set));
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_set_add(&set, 10, &rings[10]));
+    TEST_ASSERT_EQUAL_INT32(10, ring_buf_set_next(&set));
+
+    ring_buf_set_remove(&set, 10);
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_set_next(&set));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_set_wait(&set, 0));
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_set_wait(&set, 10));
+}
+
+#define SET_PRODUCERS 4u
+#define SET_MESSAGES  20000u
+
+static void *set_producer(void *arg)
+{
+    uint32_t index = (uint32_t) (uintptr_t) arg;
+
+    for (uint32_t sent = 0; sent < SET_MESSAGES; ) {
+        uint32_t value = sent;
+
+        if (ring_buf_space_get(&rings[index]) < sizeof(value)) {
+            sched_yield();
+            continue;
+        }
+
+        ring_buf_put(&rings[index], (uint8_t *) &value, sizeof(value));
+        ring_buf_set_notify(&set, index);
+        sent++;
+    }
+
+    return NULL;
+}
+
+/**
+ * Blocking consumer of concurrent producers
+ *
+ * Description:
+ * - This test verifies that a consumer blocked in ring_buf_set_wait is
+ *   woken by producers of different ring buffers and drains every message.
+ *
+ * Steps:
+ * - Start 4 producer threads, each writing 20000 32-bit counters to its
+ *   own ring buffer of the set (slots 0, 64, 128 and 192).
+ * - Wait on the set and drain the returned ring buffer, until all counters
+ *   are read.
+ *
+ * Expected result:
+ * - Each ring buffer delivers its counters in order, none is lost.
+ */
+void test_ring_buf_set_wait_concurrent_producers(void)
+{
+    pthread_t producers[SET_PRODUCERS];
+    uint32_t expected[SET_RINGS] = {0};
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < SET_PRODUCERS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&producers[i], NULL, set_producer,
+                                                (void *) (uintptr_t) (i * 64u)));
+    }
+
+    for (uint32_t received = 0; received < SET_PRODUCERS * SET_MESSAGES; ) {
+        int32_t index = ring_buf_set_wait(&set, RING_BUF_WAIT_FOREVER);
+        uint32_t value;
+
+        TEST_ASSERT_TRUE(index >= 0);
+
+        while (ring_buf_get(&rings[index], (uint8_t *) &value, sizeof(value)) == sizeof(value)) {
+            errors += (value != expected[index]);
+            expected[index]++;
+            received++;
+        }
+    }
+
+    for (uint32_t i = 0; i < SET_PRODUCERS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_join(producers[i], NULL));
+        TEST_ASSERT_EQUAL_UINT32(SET_MESSAGES, expected[i * 64u]);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, errors);
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_set_next(&set));
+}
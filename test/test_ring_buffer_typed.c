@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "unity.h"
+#include "ring_buffer_typed.h"
+
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+
+struct sample {
+    uint16_t channel;
+    int16_t value;
+    uint32_t timestamp;
+};
+
+RING_BUF_DEFINE_TYPED(sample_rb, struct sample, 4);
+RING_BUF_DEFINE_TYPED(word_rb, uint32_t, 256);
+
+void setUp(void)
+{
+    sample_rb_reset();
+    word_rb_reset();
+}
+
+/**
+ * Push and pop single elements
+ *
+ * Description:
+ * - This test verifies that elements pushed to a typed ring buffer are
+ *   popped back intact and in order, and that the ring buffer holds exactly
+ *   its capacity.
+ *
+ * Steps:
+ * - Repeat 10 times on a ring buffer of 4 elements: push 4 elements, attempt
+ *   a fifth one, check the front element, then pop all elements and attempt
+ *   one more pop.
+ *
+ * Expected result:
+ * - The fifth push returns -2 and the extra pop returns -1.
+ * - The front element is the oldest one and stays in the ring buffer.
+ * - Elements are popped in the order they were pushed.
+ */
+void test_typed_push_and_pop(void)
+{
+    TEST_ASSERT_TRUE(sample_rb_is_empty());
+    TEST_ASSERT_NULL(sample_rb_front());
+    TEST_ASSERT_EQUAL_UINT32(4, sample_rb_space_get());
+
+    for (uint32_t lap = 0; lap < 10; lap++) {
+        for (uint32_t i = 0; i < 4; i++) {
+            struct sample s = {.channel = (uint16_t) i, .value = (int16_t) -i,
+                               .timestamp = lap * 4 + i};
+
+            TEST_ASSERT_EQUAL_INT32(0, sample_rb_push(s));
+        }
+
+        TEST_ASSERT_EQUAL_INT32(-2, sample_rb_push((struct sample) {0}));
+        TEST_ASSERT_EQUAL_UINT32(4, sample_rb_size_get());
+        TEST_ASSERT_EQUAL_UINT32(lap * 4, sample_rb_front()->timestamp);
+        TEST_ASSERT_EQUAL_UINT32(4, sample_rb_size_get());
+
+        for (uint32_t i = 0; i < 4; i++) {
+            struct sample s;
+
+            TEST_ASSERT_EQUAL_INT32(0, sample_rb_pop(&s));
+            TEST_ASSERT_EQUAL_UINT16(i, s.channel);
+            TEST_ASSERT_EQUAL_INT16(-(int16_t) i, s.value);
+            TEST_ASSERT_EQUAL_UINT32(lap * 4 + i, s.timestamp);
+        }
+
+        TEST_ASSERT_EQUAL_INT32(-1, sample_rb_pop(NULL));
+        TEST_ASSERT_TRUE(sample_rb_is_empty());
+    }
+}
+
+/**
+ * Push and pop several elements at once
+ *
+ * Description:
+ * - This test verifies that push_n and pop_n move as many elements as fit
+ *   or are available, across the wrap point.
+ *
+ * Steps:
+ * - On a ring buffer of 4 elements, push and pop 3 elements.
+ * - Push 6 elements at once, then pop 1 discarding it, then pop 6 at once.
+ *
+ * Expected result:
+ * - push_n returns 4 and pop_n returns 3, with the elements in order.
+ */
+void test_typed_push_n_and_pop_n(void)
+{
+    struct sample in[6];
+    struct sample out[6];
+
+    for (uint32_t i = 0; i < 6; i++) {
+        in[i] = (struct sample) {.channel = 1, .value = 2, .timestamp = i};
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(3, sample_rb_push_n(in, 3));
+    TEST_ASSERT_EQUAL_UINT32(3, sample_rb_pop_n(out, 6));
+
+    TEST_ASSERT_EQUAL_UINT32(4, sample_rb_push_n(in, 6));
+    TEST_ASSERT_EQUAL_INT32(0, sample_rb_pop(NULL));
+
+    memset(out, 0, sizeof(out));
+    TEST_ASSERT_EQUAL_UINT32(3, sample_rb_pop_n(out, 6));
+    TEST_ASSERT_EQUAL_MEMORY(&in[1], out, 3 * sizeof(struct sample));
+    TEST_ASSERT_TRUE(sample_rb_is_empty());
+}
+
+#define TYPED_TEST_WORDS (1u << 20)
+
+static void *typed_producer(void *arg)
+{
+    (void) arg;
+
+    for (uint32_t i = 0; i < TYPED_TEST_WORDS; ) {
+        if (word_rb_push(i) == 0) {
+            i++;
+        } else {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Concurrent producer and consumer
+ *
+ * Description:
+ * - This test verifies that a producer thread and a consumer thread can
+ *   share a typed ring buffer without locking.
+ *
+ * Steps:
+ * - Start a producer thread pushing 2^20 increasing words to a ring buffer
+ *   of 256 words.
+ * - Pop words in batches from the test thread until all are received.
+ *
+ * Expected result:
+ * - All words are received once and in order.
+ */
+void test_typed_concurrent_producer_and_consumer(void)
+{
+    pthread_t producer;
+    uint32_t expected = 0;
+    uint32_t errors = 0;
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&producer, NULL, typed_producer, NULL));
+
+    while (expected < TYPED_TEST_WORDS) {
+        uint32_t words[7];
+        uint32_t count = word_rb_pop_n(words, 7);
+
+        for (uint32_t i = 0; i < count; i++) {
+            errors += (words[i] != expected++);
+        }
+
+        if (count == 0) {
+            sched_yield();
+        }
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(producer, NULL));
+    TEST_ASSERT_EQUAL_UINT32(0, errors);
+    TEST_ASSERT_TRUE(word_rb_is_empty());
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "unity.h"
+#include "ring_buffer.h"
+#include "ring_buffer_wait.h"
+
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+
+#define WAIT_STREAM_BYTES (256u * 1024u)
+
+struct wait_ctx {
+    struct ring_buf rb;
+    struct ring_buf_waitq data_wq;
+    struct ring_buf_waitq space_wq;
+    uint8_t buff[32];
+    uint32_t errors;
+};
+
+static struct wait_ctx ctx;
+
+void setUp(void)
+{
+    memset(&ctx, 0, sizeof(ctx));
+    ring_buf_init(&ctx.rb, sizeof(ctx.buff), ctx.buff);
+    ring_buf_waitq_init(&ctx.data_wq);
+    ring_buf_waitq_init(&ctx.space_wq);
+}
+
+static void *blocking_producer(void *arg)
+{
+    (void) arg;
+
+    for (uint32_t sent = 0; sent < WAIT_STREAM_BYTES; ) {
+        uint8_t data[7];
+        uint32_t size = sizeof(data);
+
+        for (uint32_t i = 0; i < size; i++) {
+            data[i] = (uint8_t) (sent + i);
+        }
+
+        if (ring_buf_wait_space(&ctx.rb, &ctx.space_wq, size, RING_BUF_WAIT_FOREVER) != 0) {
+            ctx.errors++;
+            break;
+        }
+
+        sent += ring_buf_put(&ctx.rb, data, size);
+        ring_buf_wake(&ctx.data_wq);
+    }
+
+    return NULL;
+}
+
+/**
+ * Blocking producer and consumer exchange a stream
+ *
+ * Description:
+ * - This test verifies that a producer waiting for space and a consumer
+ *   waiting for data wake each other up and never lose a wake-up.
+ *
+ * Steps:
+ * - Initialize a ring buffer of 32 bytes and two wait queues.
+ * - Start a producer thread that waits for space before every 7 byte write
+ *   and wakes the data wait queue after it.
+ * - On the test thread, wait for 5 bytes of data before every read and wake
+ *   the space wait queue after it.
+ *
+ * Expected result:
+ * - No wait fails and every byte is received in order.
+ */
+void test_blocking_producer_and_consumer(void)
+{
+    pthread_t producer;
+    uint32_t received = 0;
+    uint32_t errors = 0;
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&producer, NULL, blocking_producer, NULL));
+
+    while (received < WAIT_STREAM_BYTES) {
+        uint8_t data[5];
+        uint32_t size = WAIT_STREAM_BYTES - received;
+
+        size = (size < sizeof(data)) ? size : sizeof(data);
+
+        if (ring_buf_wait_data(&ctx.rb, &ctx.data_wq, size, RING_BUF_WAIT_FOREVER) != 0) {
+            errors++;
+            break;
+        }
+
+        uint32_t read = ring_buf_get(&ctx.rb, data, size);
+        ring_buf_wake(&ctx.space_wq);
+
+        for (uint32_t i = 0; i < read; i++) {
+            errors += (data[i] != (uint8_t) (received + i));
+        }
+
+        received += read;
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_join(producer, NULL));
+    TEST_ASSERT_EQUAL_UINT32(0, errors);
+    TEST_ASSERT_EQUAL_UINT32(0, ctx.errors);
+    TEST_ASSERT_EQUAL_UINT32(WAIT_STREAM_BYTES, received);
+}
+
+/**
+ * Waiting times out
+ *
+ * Description:
+ * - This test verifies that waits return -1 when the condition is not met
+ *   in time, and 0 at once when it already is.
+ *
+ * Steps:
+ * - Wait for data on an empty ring buffer with a timeout of 0 ms and of
+ *   20 ms.
+ * - Wait for space on the same ring buffer with a timeout of 0 ms.
+ *
+ * Expected result:
+ * - Both data waits return -1, the second one after at least 20 ms.
+ * - The space wait returns 0.
+ */
+void test_wait_timeout(void)
+{
+    struct timespec start;
+    struct timespec end;
+
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_wait_data(&ctx.rb, &ctx.data_wq, 1, 0));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    TEST_ASSERT_EQUAL_INT32(-1, ring_buf_wait_data(&ctx.rb, &ctx.data_wq, 1, 20));
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    int64_t elapsed_ms = (int64_t) (end.tv_sec - start.tv_sec) * 1000 +
+                         (end.tv_nsec - start.tv_nsec) / 1000000;
+    TEST_ASSERT_TRUE(elapsed_ms >= 19);
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_wait_space(&ctx.rb, &ctx.space_wq, sizeof(ctx.buff), 0));
+}
+
+/**
+ * Waking without waiters is free
+ *
+ * Description:
+ * - This test verifies that ring_buf_wake does nothing (and so issues no
+ *   system call) when no thread is waiting.
+ *
+ * Steps:
+ * - Wake an idle wait queue.
+ *
+ * Expected result:
+ * - The wait queue sequence and waiter count are unchanged.
+ */
+void test_wake_without_waiters(void)
+{
+    ring_buf_wake(&ctx.data_wq);
+
+    TEST_ASSERT_EQUAL_UINT32(0, ctx.data_wq.seq);
+    TEST_ASSERT_EQUAL_UINT32(0, ctx.data_wq.waiters);
+}
@@ -6,10 +6,537 @@
 
 #include "unity.h"
 #include "smf.h"
-#include "mock_smf.h"
+#include "smf_event.h"
+#include "mock_smf_port.h"
 
+#include <stdio.h>
+#include <string.h>
 
-void test_dummy(void)
+
+enum test_state {
+    PARENT,
+    CHILD_A,
+    CHILD_B,
+    STATE_COUNT,
+};
+
+enum test_event {
+    EVENT_HANDLED_BY_A = 1,
+    EVENT_TO_PARENT,
+    EVENT_TO_B,
+    EVENT_POST_MORE,
+    EVENT_TERMINATE,
+    EVENT_RESTART,
+};
+
+struct test_object {
+    struct smf_ctx ctx;
+    char log[256];
+    size_t length;
+};
+
+static const struct smf_state states[STATE_COUNT];
+static struct test_object object;
+static struct ring_buf queue;
+static uint32_t queue_storage[32];
+
+static void log_action(struct test_object *obj, const char *action)
+{
+    const struct smf_event *event = smf_get_event(&obj->ctx);
+
+    if (event != NULL) {
+        obj->length += (size_t) snprintf(obj->log + obj->length, sizeof(obj->log) - obj->length,
+                                         "%s:%u ", action, event->id);
+    } else {
+        obj->length += (size_t) snprintf(obj->log + obj->length, sizeof(obj->log) - obj->length,
+                                         "%s ", action);
+    }
+}
+
+static void parent_entry(void *obj)
+{
+    log_action(obj, "Pentry");
+}
+
+static void parent_run(void *obj)
+{
+    const struct smf_event *event = smf_get_event(SMF_CTX(obj));
+
+    log_action(obj, "Prun");
+
+    if (event != NULL && event->id == EVENT_TO_PARENT) {
+        smf_set_state(SMF_CTX(obj), &states[CHILD_B]);
+    }
+}
+
+static void parent_exit(void *obj)
+{
+    log_action(obj, "Pexit");
+}
+
+static void a_entry(void *obj)
+{
+    log_action(obj, "Aentry");
+}
+
+static void a_run(void *obj)
+{
+    const struct smf_event *event = smf_get_event(SMF_CTX(obj));
+
+    log_action(obj, "Arun");
+
+    if (event == NULL) {
+        return;
+    }
+
+    switch (event->id) {
+    case EVENT_HANDLED_BY_A:
+        smf_set_handled(SMF_CTX(obj));
+        break;
+    case EVENT_TO_B:
+        smf_set_state(SMF_CTX(obj), &states[CHILD_B]);
+        break;
+    case EVENT_POST_MORE:
+        smf_set_handled(SMF_CTX(obj));
+        TEST_ASSERT_EQUAL_INT32(0, smf_post_event(SMF_CTX(obj), EVENT_HANDLED_BY_A, 0,
+                                                  NULL, 0));
+        break;
+    default:
+        break;
+    }
+}
+
+static void a_exit(void *obj)
+{
+    log_action(obj, "Aexit");
+}
+
+static void b_entry(void *obj)
+{
+    log_action(obj, "Bentry");
+}
+
+static void b_run(void *obj)
+{
+    const struct smf_event *event = smf_get_event(SMF_CTX(obj));
+
+    log_action(obj, "Brun");
+
+    if (event != NULL && event->id == EVENT_TERMINATE) {
+        smf_set_terminate(SMF_CTX(obj), (int32_t) event->data[0]);
+    } else if (event != NULL && event->id == EVENT_RESTART) {
+        smf_set_handled(SMF_CTX(obj));
+        smf_restart(SMF_CTX(obj), &states[CHILD_A]);
+    }
+}
+
+static const struct smf_state states[STATE_COUNT] = {
+    [PARENT] = SMF_CREATE_STATE(parent_entry, parent_run, parent_exit, NULL, NULL),
+    [CHILD_A] = SMF_CREATE_STATE(a_entry, a_run, a_exit, &states[PARENT], NULL),
+    [CHILD_B] = SMF_CREATE_STATE(b_entry, b_run, NULL, &states[PARENT], NULL),
+};
+
+static void log_clear(void)
+{
+    object.log[0] = '\0';
+    object.length = 0;
+}
+
+void setUp(void)
+{
+    memset(&object, 0, sizeof(object));
+    ring_buf_item_init(&queue, sizeof(queue_storage) / sizeof(queue_storage[0]),
+                       queue_storage);
+
+    smf_set_initial(SMF_CTX(&object), &states[CHILD_A]);
+    smf_set_event_queue(SMF_CTX(&object), &queue);
+    log_clear();
+}
+
+/**
+ * Events propagate to ancestors until handled
+ *
+ * Description:
+ * - This test verifies that smf_dispatch runs the current state and then
+ *   its ancestors, and that smf_set_handled stops the propagation.
+ *
+ * Steps:
+ * - Post an event child A handles, then one it ignores.
+ * - Dispatch them one by one.
+ *
+ * Expected result:
+ * - The first event only runs child A.
+ * - The second event runs child A, then the parent.
+ * - Each dispatch returns 0 and no event is left pending.
+ */
+void test_smf_dispatch_propagates_until_handled(void)
+{
+    TEST_ASSERT_EQUAL_INT32(0, smf_post_event(SMF_CTX(&object), EVENT_HANDLED_BY_A, 0, NULL, 0));
+    TEST_ASSERT_EQUAL_INT32(0, smf_post_event(SMF_CTX(&object), 42, 0, NULL, 0));
+    TEST_ASSERT_TRUE(smf_event_pending(SMF_CTX(&object)));
+
+    TEST_ASSERT_EQUAL_INT32(0, smf_dispatch(SMF_CTX(&object)));
+    TEST_ASSERT_EQUAL_STRING("Arun:1 ", object.log);
+
+    log_clear();
+    TEST_ASSERT_EQUAL_INT32(0, smf_dispatch(SMF_CTX(&object)));
+    TEST_ASSERT_EQUAL_STRING("Arun:42 Prun:42 ", object.log);
+
+    TEST_ASSERT_FALSE(smf_event_pending(SMF_CTX(&object)));
+    TEST_ASSERT_NULL(smf_get_event(SMF_CTX(&object)));
+}
+
+/**
+ * Transitions stop the propagation of an event
+ *
+ * Description:
+ * - This test verifies that a state transitioning while it handles an event
+ *   stops its propagation, whether it is the current state or an ancestor.
+ *
+ * Steps:
+ * - Post an event child A transitions on, to child B.
+ * - Dispatch it, then post and dispatch an event the parent transitions on.
+ *
+ * Expected result:
+ * - Child A exits and child B enters, without parent exit nor entry, and
+ *   the parent does not run.
+ * - The second event runs child B then the parent, which re-enters child B.
+ */
+void test_smf_dispatch_transition_stops_propagation(void)
+{
+    TEST_ASSERT_EQUAL_INT32(0, smf_post_event(SMF_CTX(&object), EVENT_TO_B, 0, NULL, 0));
+    TEST_ASSERT_EQUAL_INT32(0, smf_dispatch(SMF_CTX(&object)));
+    TEST_ASSERT_EQUAL_STRING("Arun:3 Aexit:3 Bentry:3 ", object.log);
+    TEST_ASSERT_EQUAL_PTR(&states[CHILD_B], SMF_CTX(&object)->current);
+
+    log_clear();
+    TEST_ASSERT_EQUAL_INT32(0, smf_post_event(SMF_CTX(&object), EVENT_TO_PARENT, 0, NULL, 0));
+    TEST_ASSERT_EQUAL_INT32(0, smf_dispatch(SMF_CTX(&object)));
+    TEST_ASSERT_EQUAL_STRING("Brun:2 Prun:2 Bentry:2 ", object.log);
+}
+
+/**
+ * Events posted by actions run to completion one at a time
+ *
+ * Description:
+ * - This test verifies that an event posted while another is dispatched is
+ *   queued, and delivered by the next call to smf_dispatch.
+ *
+ * Steps:
+ * - Post an event whose handler posts another one.
+ * - Dispatch once, then once more.
+ *
+ * Expected result:
+ * - The first dispatch only handles the first event, and leaves the posted
+ *   one pending.
+ * - The second dispatch handles the posted event.
+ */
+void test_smf_dispatch_posted_events_are_queued(void)
+{
+    TEST_ASSERT_EQUAL_INT32(0, smf_post_event(SMF_CTX(&object), EVENT_POST_MORE, 0, NULL, 0));
+
+    TEST_ASSERT_EQUAL_INT32(0, smf_dispatch(SMF_CTX(&object)));
+    TEST_ASSERT_EQUAL_STRING("Arun:4 ", object.log);
+    TEST_ASSERT_TRUE(smf_event_pending(SMF_CTX(&object)));
+
+    log_clear();
+    TEST_ASSERT_EQUAL_INT32(0, smf_dispatch(SMF_CTX(&object)));
+    TEST_ASSERT_EQUAL_STRING("Arun:1 ", object.log);
+    TEST_ASSERT_FALSE(smf_event_pending(SMF_CTX(&object)));
+}
+
+/**
+ * Event payloads and termination values are delivered
+ *
+ * Description:
+ * - This test verifies that the value and payload of an event reach its
+ *   handler, and that a handler terminating the state machine makes
+ *   smf_dispatch return the termination value.
+ *
+ * Steps:
+ * - Move to child B and post an event carrying the termination value in
+ *   its payload.
+ * - Dispatch it, then post another event and dispatch again.
+ *
+ * Expected result:
+ * - smf_dispatch returns the termination value both times.
+ * - The second event is not delivered.
+ */
+void test_smf_dispatch_terminate(void)
+{
+    const uint32_t data[2] = { 7, 0 };
+
+    smf_set_state(SMF_CTX(&object), &states[CHILD_B]);
+    log_clear();
+
+    TEST_ASSERT_EQUAL_INT32(0, smf_post_event(SMF_CTX(&object), EVENT_TERMINATE, 3, data, 2));
+    TEST_ASSERT_EQUAL_INT32(7, smf_dispatch(SMF_CTX(&object)));
+    TEST_ASSERT_EQUAL_STRING("Brun:5 ", object.log);
+
+    TEST_ASSERT_EQUAL_INT32(0, smf_post_event(SMF_CTX(&object), 42, 0, NULL, 0));
+    TEST_ASSERT_EQUAL_INT32(7, smf_dispatch(SMF_CTX(&object)));
+    TEST_ASSERT_EQUAL_STRING("Brun:5 ", object.log);
+}
+
+/**
+ * Invalid events are dropped
+ *
+ * Description:
+ * - This test verifies that smf_post_event rejects payloads larger than
+ *   SMF_EVENT_MAX_SIZE32, and that smf_dispatch drops queued items too big
+ *   for an event, logs an error and delivers the next event.
+ *
+ * Steps:
+ * - Post an oversized event.
+ * - Put an oversized item straight into the queue, then post a valid event.
+ * - Dispatch once.
+ *
+ * Expected result:
+ * - smf_post_event returns -1 for the oversized event.
+ * - The dispatch delivers the valid event and logs one error.
+ */
+void test_smf_dispatch_drops_invalid_events(void)
+{
+    uint32_t data[SMF_EVENT_MAX_SIZE32 + 1] = { 0 };
+
+    TEST_ASSERT_EQUAL_INT32(-1, smf_post_event(SMF_CTX(&object), 42, 0, data,
+                                               SMF_EVENT_MAX_SIZE32 + 1));
+    TEST_ASSERT_FALSE(smf_event_pending(SMF_CTX(&object)));
+
+    TEST_ASSERT_EQUAL_INT32(0, ring_buf_item_put(&queue, 42, 0, data, SMF_EVENT_MAX_SIZE32 + 1));
+    TEST_ASSERT_EQUAL_INT32(0, smf_post_event(SMF_CTX(&object), EVENT_HANDLED_BY_A, 0, NULL, 0));
+
+    TEST_ASSERT_EQUAL_INT32(0, smf_dispatch(SMF_CTX(&object)));
+    TEST_ASSERT_EQUAL_STRING("Arun:1 ", object.log);
+    TEST_ASSERT_EQUAL(1, smf_port_log_fake.call_count);
+    TEST_ASSERT_FALSE(smf_event_pending(SMF_CTX(&object)));
+}
+
+/**
+ * Dispatching without events does nothing
+ *
+ * Description:
+ * - This test verifies that smf_dispatch runs no action when the queue is
+ *   empty or missing, and that posting fails when the queue is missing or
+ *   full.
+ *
+ * Steps:
+ * - Dispatch with an empty queue.
+ * - Post events until the queue is full.
+ * - Remove the queue, then dispatch and post.
+ *
+ * Expected result:
+ * - No action runs.
+ * - Posting to the full queue returns -2, without a queue -1.
+ */
+void test_smf_dispatch_without_events(void)
+{
+    int32_t result;
+
+    TEST_ASSERT_EQUAL_INT32(0, smf_dispatch(SMF_CTX(&object)));
+    TEST_ASSERT_EQUAL_STRING("", object.log);
+
+    do {
+        result = smf_post_event(SMF_CTX(&object), 42, 0, NULL, 0);
+    } while (result == 0);
+    TEST_ASSERT_EQUAL_INT32(-2, result);
+
+    smf_set_event_queue(SMF_CTX(&object), NULL);
+    TEST_ASSERT_FALSE(smf_event_pending(SMF_CTX(&object)));
+    TEST_ASSERT_EQUAL_INT32(0, smf_dispatch(SMF_CTX(&object)));
+    TEST_ASSERT_EQUAL_STRING("", object.log);
+    TEST_ASSERT_EQUAL_INT32(-1, smf_post_event(SMF_CTX(&object), 42, 0, NULL, 0));
+}
+
+/**
+ * Contexts are fully initialized
+ *
+ * Description:
+ * - This test verifies that smf_set_initial starts a state machine whose
+ *   context holds garbage, as a context on the stack or from malloc does.
+ *
+ * Steps:
+ * - Fill a context with garbage, and start it as well as a zeroed context
+ *   in child A.
+ * - Move both to child B and run them.
+ *
+ * Expected result:
+ * - The same entry, exit and run actions run for both contexts.
+ */
+void test_smf_set_initial_garbage_context(void)
+{
+    struct test_object garbage;
+    struct test_object *objects[2] = { &object, &garbage };
+
+    memset(&garbage, 0xA5, sizeof(garbage));
+
+    for (uint32_t i = 0; i < 2; i++) {
+        objects[i]->log[0] = '\0';
+        objects[i]->length = 0;
+
+        smf_set_initial(SMF_CTX(objects[i]), &states[CHILD_A]);
+        smf_set_state(SMF_CTX(objects[i]), &states[CHILD_B]);
+        TEST_ASSERT_EQUAL_INT32(0, smf_run_state(SMF_CTX(objects[i])));
+    }
+
+    TEST_ASSERT_EQUAL_STRING("Pentry Aentry Aexit Bentry Brun ", object.log);
+    TEST_ASSERT_EQUAL_STRING(object.log, garbage.log);
+}
+
+/**
+ * Restarts keep the event queue
+ *
+ * Description:
+ * - This test verifies that a state machine restarting itself from an
+ *   action with smf_restart keeps its event queue and ancestry table.
+ *
+ * Steps:
+ * - Give the state machine an ancestry table.
+ * - Post an event moving to child B, then one making child B restart the
+ *   state machine in child A, then one handled by child A.
+ * - Dispatch all events.
+ *
+ * Expected result:
+ * - Child A is entered again by the restart and handles the last event.
+ * - The queue and the ancestry table are still set, and events can still
+ *   be posted.
+ */
+void test_smf_restart_keeps_event_queue(void)
+{
+    static struct smf_path paths[STATE_COUNT];
+    struct smf_ancestry ancestry;
+
+    TEST_ASSERT_EQUAL_INT32(0, smf_ancestry_init(&ancestry, states, paths, STATE_COUNT));
+    smf_set_ancestry(SMF_CTX(&object), &ancestry);
+
+    TEST_ASSERT_EQUAL_INT32(0, smf_post_event(SMF_CTX(&object), EVENT_TO_B, 0, NULL, 0));
+    TEST_ASSERT_EQUAL_INT32(0, smf_post_event(SMF_CTX(&object), EVENT_RESTART, 0, NULL, 0));
+    TEST_ASSERT_EQUAL_INT32(0, smf_post_event(SMF_CTX(&object), EVENT_HANDLED_BY_A, 0, NULL, 0));
+
+    while (smf_event_pending(SMF_CTX(&object))) {
+        TEST_ASSERT_EQUAL_INT32(0, smf_dispatch(SMF_CTX(&object)));
+    }
+
+    TEST_ASSERT_EQUAL_STRING("Arun:3 Aexit:3 Bentry:3 Brun:6 Pentry:6 Aentry:6 Prun:6 Arun:1 ",
+                             object.log);
+    TEST_ASSERT_EQUAL_PTR(&queue, SMF_CTX(&object)->events);
+    TEST_ASSERT_EQUAL_PTR(&ancestry, SMF_CTX(&object)->ancestry);
+    TEST_ASSERT_EQUAL_INT32(0, smf_post_event(SMF_CTX(&object), EVENT_HANDLED_BY_A, 0, NULL, 0));
+}
+
+static const struct smf_state outer_states[2];
+
+static void inner_entry(void *obj)
+{
+    log_action(obj, (SMF_CTX(obj)->executing == &outer_states[0]) ? "Ientry0" : "Ientry1");
+}
+
+static void inner_exit(void *obj)
+{
+    log_action(obj, (SMF_CTX(obj)->current == &outer_states[0]) ? "Iexit0" : "Iexit1");
+}
+
+static void outer_entry(void *obj)
 {
-    TEST_IGNORE();
+    log_action(obj, "Oentry");
+}
+
+static void outer_run(void *obj)
+{
+    log_action(obj, "Orun");
+    smf_set_state(SMF_CTX(obj), &outer_states[1]);
+}
+
+static void outer_exit(void *obj)
+{
+    log_action(obj, "Oexit");
+}
+
+/* Parent of the states of the ancestry table, outside of the table. */
+static const struct smf_state outer = SMF_CREATE_STATE(outer_entry, outer_run, outer_exit,
+                                                       NULL, NULL);
+
+static const struct smf_state outer_states[2] = {
+    SMF_CREATE_STATE(inner_entry, NULL, inner_exit, &outer, NULL),
+    SMF_CREATE_STATE(inner_entry, NULL, inner_exit, &outer, NULL),
+};
+
+/**
+ * Transitions use the ancestry table like parent chains
+ *
+ * Description:
+ * - This test verifies that transitions between states of an ancestry
+ *   table run the same exit and entry actions as without a table.
+ *
+ * Steps:
+ * - Compute the ancestry table of the test states.
+ * - Move from child A to child B, then to the parent and back to child A,
+ *   with and without the table.
+ *
+ * Expected result:
+ * - Both runs log the same actions, and the parent is never exited nor
+ *   re-entered.
+ */
+void test_smf_ancestry_transitions(void)
+{
+    static struct smf_path paths[STATE_COUNT];
+    struct smf_ancestry ancestry;
+    char without_table[sizeof(object.log)];
+
+    TEST_ASSERT_EQUAL_INT32(0, smf_ancestry_init(&ancestry, states, paths, STATE_COUNT));
+    TEST_ASSERT_EQUAL_UINT32(2, paths[CHILD_B].depth);
+    TEST_ASSERT_EQUAL_PTR(&states[PARENT], paths[CHILD_B].chain[0]);
+
+    for (uint32_t run = 0; run < 2; run++) {
+        smf_set_initial(SMF_CTX(&object), &states[CHILD_A]);
+        smf_set_ancestry(SMF_CTX(&object), (run == 1) ? &ancestry : NULL);
+        log_clear();
+
+        smf_set_state(SMF_CTX(&object), &states[CHILD_B]);
+        smf_set_state(SMF_CTX(&object), &states[PARENT]);
+        smf_set_state(SMF_CTX(&object), &states[CHILD_A]);
+
+        if (run == 0) {
+            strcpy(without_table, object.log);
+        }
+    }
+
+    TEST_ASSERT_EQUAL_STRING("Aexit Bentry Aentry ", without_table);
+    TEST_ASSERT_EQUAL_STRING(without_table, object.log);
+}
+
+/**
+ * Transitions from a parent outside of the ancestry table
+ *
+ * Description:
+ * - This test verifies that a parent outside of an ancestry table moving
+ *   its child between two states of the table is neither exited nor
+ *   re-entered, as without a table.
+ *
+ * Steps:
+ * - Compute the ancestry table of two states sharing a parent outside of
+ *   the table.
+ * - Start in the first state, and run the state machine once, with and
+ *   without the table: the parent moves to the second state.
+ *
+ * Expected result:
+ * - Both runs log the parent run action, the exit of the first state and
+ *   the entry of the second state only.
+ */
+void test_smf_ancestry_parent_outside_table(void)
+{
+    static struct smf_path paths[2];
+    struct smf_ancestry ancestry;
+
+    TEST_ASSERT_EQUAL_INT32(0, smf_ancestry_init(&ancestry, outer_states, paths, 2));
+
+    for (uint32_t run = 0; run < 2; run++) {
+        smf_set_initial(SMF_CTX(&object), &outer_states[0]);
+        smf_set_ancestry(SMF_CTX(&object), (run == 1) ? &ancestry : NULL);
+        log_clear();
+
+        TEST_ASSERT_EQUAL_INT32(0, smf_run_state(SMF_CTX(&object)));
+        TEST_ASSERT_EQUAL_STRING("Orun Iexit0 Ientry1 ", object.log);
+        TEST_ASSERT_EQUAL_PTR(&outer_states[1], SMF_CTX(&object)->current);
+    }
 }
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "unity.h"
+#include "smf_engine.h"
+#include "mock_smf_port.h"
+
+#include <string.h>
+
+
+#define INSTANCES    200u
+#define EVENT_STEP   1u
+#define EVENT_FINISH 2u
+
+enum test_state {
+    RED,
+    GREEN,
+    DONE,
+    STATE_COUNT,
+};
+
+struct test_object {
+    struct smf_ctx ctx;
+    struct ring_buf queue;
+    uint32_t storage[64];
+    uint32_t runs;
+    uint32_t events;
+};
+
+static const struct smf_state states[STATE_COUNT];
+static struct test_object objects[INSTANCES];
+static struct smf_path paths[STATE_COUNT];
+static struct smf_ancestry ancestry;
+static struct smf_engine engine;
+
+/* States of the instances run by the batch being recorded, in run order. */
+static const struct smf_state *run_order[INSTANCES];
+static uint32_t run_count;
+
+static void record_run(struct test_object *o)
+{
+    const struct smf_event *event = smf_get_event(SMF_CTX(o));
+
+    if (event != NULL) {
+        o->events++;
+    } else {
+        o->runs++;
+    }
+
+    /* workers may run instances concurrently */
+    uint32_t n = __atomic_fetch_add(&run_count, 1, __ATOMIC_RELAXED);
+
+    if (n < INSTANCES) {
+        run_order[n] = SMF_CTX(o)->current;
+    }
+}
+
+static void red_run(void *obj)
+{
+    const struct smf_event *event = smf_get_event(SMF_CTX(obj));
+
+    record_run(obj);
+
+    if (event != NULL && event->id == EVENT_STEP) {
+        smf_set_state(SMF_CTX(obj), &states[GREEN]);
+    }
+}
+
+static void green_run(void *obj)
+{
+    const struct smf_event *event = smf_get_event(SMF_CTX(obj));
+
+    record_run(obj);
+
+    if (event != NULL && event->id == EVENT_FINISH) {
+        smf_set_state(SMF_CTX(obj), &states[DONE]);
+    }
+}
+
+static void done_entry(void *obj)
+{
+    smf_set_terminate(SMF_CTX(obj), 1 + (int32_t) (((struct test_object *) obj) - objects));
+}
+
+static const struct smf_state states[STATE_COUNT] = {
+    [RED] = SMF_CREATE_STATE(NULL, red_run, NULL, NULL, NULL),
+    [GREEN] = SMF_CREATE_STATE(NULL, green_run, NULL, NULL, NULL),
+    [DONE] = SMF_CREATE_STATE(done_entry, NULL, NULL, NULL, NULL),
+};
+
+void setUp(void)
+{
+    memset(objects, 0, sizeof(objects));
+    run_count = 0;
+
+    TEST_ASSERT_EQUAL_INT32(0, smf_ancestry_init(&ancestry, states, paths, STATE_COUNT));
+    TEST_ASSERT_EQUAL_INT32(0, smf_engine_init(&engine, &ancestry));
+
+    for (uint32_t i = 0; i < INSTANCES; i++) {
+        struct test_object *o = &objects[i];
+
+        ring_buf_item_init(&o->queue, sizeof(o->storage) / sizeof(o->storage[0]), o->storage);
+        smf_set_initial(SMF_CTX(o), &states[(i % 3u == 0) ? GREEN : RED]);
+        smf_set_event_queue(SMF_CTX(o), &o->queue);
+
+        TEST_ASSERT_EQUAL_INT32((int32_t) i, smf_engine_add(&engine, SMF_CTX(o)));
+    }
+}
+
+/**
+ * Batches run scheduled instances grouped by state
+ *
+ * Description:
+ * - This test verifies that a batch only runs the instances that were woken
+ *   or received events, and runs them grouped by current state.
+ *
+ * Steps:
+ * - Wake every other instance, in decreasing order, with one instance in
+ *   three in the second state and the others in the first one.
+ * - Run a batch, then another one.
+ *
+ * Expected result:
+ * - The first batch runs the woken instances once each, all instances of
+ *   the first state before those of the second.
+ * - The second batch runs nothing.
+ */
+void test_smf_engine_batch_grouped_by_state(void)
+{
+    uint32_t woken = 0;
+
+    for (uint32_t i = INSTANCES; i-- > 0; ) {
+        if (i % 2u == 0) {
+            smf_engine_wake(&engine, i);
+            woken++;
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(woken, smf_engine_run(&engine));
+    TEST_ASSERT_EQUAL_UINT32(woken, run_count);
+
+    for (uint32_t i = 1; i < run_count; i++) {
+        TEST_ASSERT_TRUE(run_order[i - 1u] <= run_order[i]);
+    }
+
+    for (uint32_t i = 0; i < INSTANCES; i++) {
+        TEST_ASSERT_EQUAL_UINT32((i % 2u == 0) ? 1u : 0u, objects[i].runs);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, smf_engine_run(&engine));
+}
+
+/**
+ * Busy instances get an event budget per batch
+ *
+ * Description:
+ * - This test verifies that an instance dispatches at most
+ *   SMF_ENGINE_EVENT_BUDGET events per batch, and is scheduled again while
+ *   events are left.
+ *
+ * Steps:
+ * - Post SMF_ENGINE_EVENT_BUDGET + 2 events to one instance.
+ * - Run batches until none is left.
+ *
+ * Expected result:
+ * - The first batch dispatches SMF_ENGINE_EVENT_BUDGET events, the second
+ *   one the remaining two, then nothing runs.
+ */
+void test_smf_engine_event_budget(void)
+{
+    for (uint32_t i = 0; i < SMF_ENGINE_EVENT_BUDGET + 2u; i++) {
+        TEST_ASSERT_EQUAL_INT32(0, smf_engine_post(&engine, 5, 42, 0, NULL, 0));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(1, smf_engine_run(&engine));
+    TEST_ASSERT_EQUAL_UINT32(SMF_ENGINE_EVENT_BUDGET, objects[5].events);
+
+    TEST_ASSERT_EQUAL_UINT32(1, smf_engine_run(&engine));
+    TEST_ASSERT_EQUAL_UINT32(SMF_ENGINE_EVENT_BUDGET + 2u, objects[5].events);
+
+    TEST_ASSERT_EQUAL_UINT32(0, smf_engine_run(&engine));
+    TEST_ASSERT_EQUAL_UINT32(0, objects[5].runs);
+}
+
+/**
+ * Terminated instances are not run again
+ *
+ * Description:
+ * - This test verifies that instances terminating in a batch report their
+ *   termination value, and are not run by later batches.
+ *
+ * Steps:
+ * - Post a step and a finish event to every instance, which terminate them.
+ * - Run a batch, then wake all instances and run another one.
+ *
+ * Expected result:
+ * - Every instance reports its own termination value.
+ * - The second batch runs nothing.
+ */
+void test_smf_engine_termination(void)
+{
+    for (uint32_t i = 0; i < INSTANCES; i++) {
+        TEST_ASSERT_EQUAL_INT32(0, smf_engine_post(&engine, i, EVENT_STEP, 0, NULL, 0));
+        TEST_ASSERT_EQUAL_INT32(0, smf_engine_post(&engine, i, EVENT_FINISH, 0, NULL, 0));
+        TEST_ASSERT_EQUAL_INT32(0, smf_engine_result(&engine, i));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(INSTANCES, smf_engine_run(&engine));
+
+    for (uint32_t i = 0; i < INSTANCES; i++) {
+        TEST_ASSERT_EQUAL_INT32((int32_t) i + 1, smf_engine_result(&engine, i));
+        smf_engine_wake(&engine, i);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, smf_engine_run(&engine));
+}
+
+/**
+ * Workers run batches like the calling thread alone
+ *
+ * Description:
+ * - This test verifies that batches split between worker threads run every
+ *   scheduled instance once, and reach the same results.
+ *
+ * Steps:
+ * - Start 3 workers.
+ * - Post a step and a finish event to every instance, and run batches
+ *   until none is left.
+ * - Stop the workers.
+ *
+ * Expected result:
+ * - Every instance dispatched both events and reports its own termination
+ *   value.
+ */
+void test_smf_engine_workers(void)
+{
+    TEST_ASSERT_EQUAL_INT32(0, smf_engine_workers_start(&engine, 3));
+    TEST_ASSERT_EQUAL_INT32(-1, smf_engine_workers_start(&engine, 3));
+
+    for (uint32_t i = 0; i < INSTANCES; i++) {
+        TEST_ASSERT_EQUAL_INT32(0, smf_engine_post(&engine, i, EVENT_STEP, 0, NULL, 0));
+        TEST_ASSERT_EQUAL_INT32(0, smf_engine_post(&engine, i, EVENT_FINISH, 0, NULL, 0));
+    }
+
+    while (smf_engine_run(&engine) != 0) {
+    }
+
+    smf_engine_workers_stop(&engine);
+
+    for (uint32_t i = 0; i < INSTANCES; i++) {
+        TEST_ASSERT_EQUAL_UINT32(2, objects[i].events);
+        TEST_ASSERT_EQUAL_INT32((int32_t) i + 1, smf_engine_result(&engine, i));
+    }
+}
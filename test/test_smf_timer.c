@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "unity.h"
+#include "smf_timer.h"
+#include "mock_smf_port.h"
+
+#include <string.h>
+
+
+#define EVENT_TIMEOUT 7u
+
+enum test_state {
+    IDLE,
+    WAIT,
+    STATE_COUNT,
+};
+
+struct test_object {
+    struct smf_ctx ctx;
+    struct smf_timer timer;
+    uint32_t timeout;
+    uint32_t expiries;
+    uint32_t stale;
+    bool restart;
+};
+
+static const struct smf_state states[STATE_COUNT];
+static struct test_object object;
+static struct smf_timer_wheel wheel;
+static struct ring_buf queue;
+static uint32_t queue_storage[32];
+
+static void wait_entry(void *obj)
+{
+    struct test_object *o = obj;
+
+    TEST_ASSERT_EQUAL_INT32(0, smf_timer_arm(SMF_CTX(o), &o->timer, o->timeout));
+}
+
+static void wait_run(void *obj)
+{
+    struct test_object *o = obj;
+    const struct smf_event *event = smf_get_event(SMF_CTX(o));
+
+    /* runs without event restart the state when asked to */
+    if (event == NULL) {
+        if (o->restart) {
+            o->restart = false;
+            smf_set_state(SMF_CTX(o), &states[WAIT]);
+        }
+        return;
+    }
+
+    if (smf_timer_is_expiry(&o->timer, event)) {
+        o->expiries++;
+        smf_set_state(SMF_CTX(o), &states[IDLE]);
+    } else if (event->id == EVENT_TIMEOUT) {
+        o->stale++;
+    }
+}
+
+static const struct smf_state states[STATE_COUNT] = {
+    [IDLE] = SMF_CREATE_STATE(NULL, NULL, NULL, NULL, NULL),
+    [WAIT] = SMF_CREATE_STATE(wait_entry, wait_run, NULL, NULL, NULL),
+};
+
+/* Start the state machine in the waiting state, at a given tick. */
+static void start(uint64_t now, uint32_t timeout)
+{
+    memset(&object, 0, sizeof(object));
+    ring_buf_item_init(&queue, sizeof(queue_storage) / sizeof(queue_storage[0]),
+                       queue_storage);
+    smf_timer_wheel_init(&wheel, now, NULL, NULL);
+    smf_timer_init(&object.timer, &wheel, EVENT_TIMEOUT);
+
+    object.timeout = timeout;
+    smf_set_initial(SMF_CTX(&object), &states[WAIT]);
+    smf_set_event_queue(SMF_CTX(&object), &queue);
+}
+
+/* Dispatch all queued events. */
+static void dispatch_all(void)
+{
+    while (smf_event_pending(SMF_CTX(&object))) {
+        TEST_ASSERT_EQUAL_INT32(0, smf_dispatch(SMF_CTX(&object)));
+    }
+}
+
+/**
+ * Timers expire on their tick across level boundaries
+ *
+ * Description:
+ * - This test verifies that timers expire exactly on their tick, whether
+ *   they stay in the first level of the wheel or are cascaded down from
+ *   higher levels, whatever the alignment of the start tick.
+ *
+ * Steps:
+ * - For timeouts around the 64 and 4096 tick level boundaries, and start
+ *   ticks aligned or not on them, arm a timer from an entry action.
+ * - Advance the wheel to the tick before the expiry, then to the expiry.
+ * - Dispatch the queued events.
+ *
+ * Expected result:
+ * - Nothing expires before the expiry tick, and the timer expires on it.
+ * - The state recognizes the expiry event and leaves.
+ */
+void test_smf_timer_expires_on_its_tick(void)
+{
+    static const uint32_t timeouts[] = { 1, 63, 64, 65, 4095, 4096, 4097, 262144 };
+    static const uint64_t starts[] = { 0, 63, 4000, 4096 };
+
+    for (size_t s = 0; s < sizeof(starts) / sizeof(starts[0]); s++) {
+        for (size_t t = 0; t < sizeof(timeouts) / sizeof(timeouts[0]); t++) {
+            uint64_t expiry = starts[s] + timeouts[t];
+
+            start(starts[s], timeouts[t]);
+
+            TEST_ASSERT_EQUAL_UINT32(0, smf_timer_wheel_advance(&wheel, expiry - 1u));
+            TEST_ASSERT_FALSE(smf_event_pending(SMF_CTX(&object)));
+
+            TEST_ASSERT_EQUAL_UINT32(1, smf_timer_wheel_advance(&wheel, expiry));
+            dispatch_all();
+
+            TEST_ASSERT_EQUAL_UINT32(1, object.expiries);
+            TEST_ASSERT_EQUAL_PTR(&states[IDLE], SMF_CTX(&object)->current);
+        }
+    }
+}
+
+/**
+ * Timers are cancelled when their state exits
+ *
+ * Description:
+ * - This test verifies that the timer armed by a state is cancelled when
+ *   the state exits.
+ *
+ * Steps:
+ * - Arm a timer of 100 ticks from the entry action of a state.
+ * - Leave the state after 50 ticks.
+ * - Advance the wheel past the expiry.
+ *
+ * Expected result:
+ * - The timer does not expire and no event is queued.
+ */
+void test_smf_timer_cancelled_on_exit(void)
+{
+    start(0, 100);
+
+    TEST_ASSERT_EQUAL_UINT32(0, smf_timer_wheel_advance(&wheel, 50));
+    smf_set_state(SMF_CTX(&object), &states[IDLE]);
+
+    TEST_ASSERT_EQUAL_UINT32(0, smf_timer_wheel_advance(&wheel, 1000));
+    TEST_ASSERT_FALSE(smf_event_pending(SMF_CTX(&object)));
+    TEST_ASSERT_NULL(SMF_CTX(&object)->timers);
+}
+
+/**
+ * Self-transitions restart the timers of a state
+ *
+ * Description:
+ * - This test verifies that a self-transition cancels the timer of the
+ *   state before its entry action arms it again.
+ *
+ * Steps:
+ * - Arm a timer of 100 ticks from the entry action of a state.
+ * - Make the state transition to itself after 50 ticks.
+ * - Advance the wheel to the first expiry tick, then to the second one.
+ *
+ * Expected result:
+ * - Nothing expires on the first expiry tick.
+ * - The timer expires 100 ticks after the self-transition.
+ */
+void test_smf_timer_restarted_on_self_transition(void)
+{
+    start(0, 100);
+
+    TEST_ASSERT_EQUAL_UINT32(0, smf_timer_wheel_advance(&wheel, 50));
+    object.restart = true;
+    TEST_ASSERT_EQUAL_INT32(0, smf_run_state(SMF_CTX(&object)));
+
+    TEST_ASSERT_EQUAL_UINT32(0, smf_timer_wheel_advance(&wheel, 149));
+    TEST_ASSERT_EQUAL_UINT32(1, smf_timer_wheel_advance(&wheel, 150));
+    dispatch_all();
+    TEST_ASSERT_EQUAL_UINT32(1, object.expiries);
+}
+
+/**
+ * Expiry events of cancelled timers are stale
+ *
+ * Description:
+ * - This test verifies that smf_timer_is_expiry rejects an expiry event
+ *   still queued after its timer was restarted or cancelled.
+ *
+ * Steps:
+ * - Let a timer expire without dispatching its event, then restart the
+ *   state, which arms the timer again, and dispatch.
+ * - Let the timer expire again, cancel it, and dispatch.
+ *
+ * Expected result:
+ * - Both queued events are delivered but not recognized as expiries.
+ * - The restarted timer still expires on its own tick.
+ */
+void test_smf_timer_stale_expiry(void)
+{
+    start(0, 10);
+
+    TEST_ASSERT_EQUAL_UINT32(1, smf_timer_wheel_advance(&wheel, 10));
+    object.restart = true;
+    TEST_ASSERT_EQUAL_INT32(0, smf_run_state(SMF_CTX(&object)));
+    dispatch_all();
+
+    TEST_ASSERT_EQUAL_UINT32(0, object.expiries);
+    TEST_ASSERT_EQUAL_UINT32(1, object.stale);
+
+    TEST_ASSERT_EQUAL_UINT32(1, smf_timer_wheel_advance(&wheel, 20));
+    smf_timer_cancel(&object.timer);
+    dispatch_all();
+
+    TEST_ASSERT_EQUAL_UINT32(0, object.expiries);
+    TEST_ASSERT_EQUAL_UINT32(2, object.stale);
+    TEST_ASSERT_EQUAL_PTR(&states[WAIT], SMF_CTX(&object)->current);
+}
+
+/**
+ * Stale expiry events survive many cancellations
+ *
+ * Description:
+ * - This test verifies that an expiry event stays stale however many times
+ *   its timer is cancelled and armed again while the event is queued,
+ *   beyond 256 times.
+ *
+ * Steps:
+ * - Let a timer expire without dispatching its event.
+ * - Cancel the timer 255 times, then arm it again (the 256th
+ *   cancellation) and let it expire.
+ * - Dispatch both queued events.
+ *
+ * Expected result:
+ * - Only the second event is recognized as an expiry.
+ */
+void test_smf_timer_stale_expiry_after_many_cancels(void)
+{
+    start(0, 10);
+
+    TEST_ASSERT_EQUAL_UINT32(1, smf_timer_wheel_advance(&wheel, 10));
+
+    for (uint32_t i = 0; i < 255; i++) {
+        smf_timer_cancel(&object.timer);
+    }
+
+    TEST_ASSERT_EQUAL_INT32(0, smf_timer_arm(SMF_CTX(&object), &object.timer, 10));
+    TEST_ASSERT_EQUAL_UINT32(1, smf_timer_wheel_advance(&wheel, 20));
+    dispatch_all();
+
+    TEST_ASSERT_EQUAL_UINT32(1, object.stale);
+    TEST_ASSERT_EQUAL_UINT32(1, object.expiries);
+}
+
+/**
+ * Timers are cancelled when the state machine restarts or terminates
+ *
+ * Description:
+ * - This test verifies that smf_restart and smf_set_terminate cancel the
+ *   armed timers of a state machine.
+ *
+ * Steps:
+ * - Arm a timer, then restart the state machine, which arms it again.
+ * - Advance the wheel past the first expiry.
+ * - Terminate the state machine and advance past the second expiry.
+ *
+ * Expected result:
+ * - Only the timer armed by the restart expires.
+ * - No timer is left armed after termination.
+ */
+void test_smf_timer_cancelled_on_restart_and_terminate(void)
+{
+    start(0, 10);
+
+    TEST_ASSERT_EQUAL_UINT32(0, smf_timer_wheel_advance(&wheel, 5));
+    object.timeout = 20;
+    smf_restart(SMF_CTX(&object), &states[WAIT]);
+
+    TEST_ASSERT_EQUAL_UINT32(0, smf_timer_wheel_advance(&wheel, 24));
+    TEST_ASSERT_EQUAL_UINT32(1, smf_timer_wheel_advance(&wheel, 25));
+    dispatch_all();
+    TEST_ASSERT_EQUAL_UINT32(1, object.expiries);
+
+    smf_set_state(SMF_CTX(&object), &states[WAIT]);
+    smf_set_terminate(SMF_CTX(&object), 1);
+
+    TEST_ASSERT_FALSE(object.timer.armed);
+    TEST_ASSERT_NULL(SMF_CTX(&object)->timers);
+    TEST_ASSERT_EQUAL_UINT32(0, smf_timer_wheel_advance(&wheel, 1000));
+}
+
+/**
+ * Timeouts out of range are rejected
+ *
+ * Description:
+ * - This test verifies that smf_timer_arm rejects timeouts of 0 ticks and
+ *   of more than SMF_TIMER_MAX_TICKS.
+ *
+ * Steps:
+ * - Arm a timer with 0 ticks, SMF_TIMER_MAX_TICKS + 1 ticks and
+ *   SMF_TIMER_MAX_TICKS ticks.
+ *
+ * Expected result:
+ * - The first two calls return -1, the last one 0.
+ */
+void test_smf_timer_range(void)
+{
+    start(0, 1);
+    smf_set_state(SMF_CTX(&object), &states[IDLE]);
+
+    TEST_ASSERT_EQUAL_INT32(-1, smf_timer_arm(SMF_CTX(&object), &object.timer, 0));
+    TEST_ASSERT_EQUAL_INT32(-1, smf_timer_arm(SMF_CTX(&object), &object.timer,
+                                              SMF_TIMER_MAX_TICKS + 1u));
+    TEST_ASSERT_EQUAL_INT32(0, smf_timer_arm(SMF_CTX(&object), &object.timer,
+                                             SMF_TIMER_MAX_TICKS));
+    TEST_ASSERT_TRUE(object.timer.armed);
+}
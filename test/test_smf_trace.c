@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "unity.h"
+#include "smf_trace.h"
+#include "mock_smf_port.h"
+
+#include <string.h>
+#include <unistd.h>
+
+
+#define RECORD_SIZE sizeof(struct smf_trace_record)
+
+static const struct smf_state states[2] = {
+    SMF_CREATE_STATE(NULL, NULL, NULL, NULL, NULL),
+    SMF_CREATE_STATE(NULL, NULL, NULL, NULL, NULL),
+};
+static struct smf_ctx ctx;
+static struct smf_trace_buffer buffer;
+static uint64_t storage[4 * RECORD_SIZE / sizeof(uint64_t) + 1u];
+static int fds[2];
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, pipe(fds));
+
+    /* room for 4 whole records, and a few bytes that are not used */
+    smf_trace_thread_init(&buffer, 3, (uint8_t *) storage, sizeof(storage));
+}
+
+void tearDown(void)
+{
+    smf_trace_thread_stop();
+    close(fds[0]);
+    close(fds[1]);
+}
+
+/* Read records drained to the pipe. */
+static void records_read(struct smf_trace_record *records, size_t count)
+{
+    TEST_ASSERT_EQUAL_INT((int) (count * RECORD_SIZE),
+                          (int) read(fds[0], records, count * RECORD_SIZE));
+}
+
+/**
+ * Records are drained as written
+ *
+ * Description:
+ * - This test verifies that records written to the trace buffer of a
+ *   thread are drained to a file whole, in order and unchanged.
+ *
+ * Steps:
+ * - Record a transition, an event and a termination.
+ * - Drain the buffer to a pipe and read the records back.
+ *
+ * Expected result:
+ * - 3 records are drained, with their kind, context, states, argument and
+ *   thread identifier, and non-decreasing timestamps.
+ * - A second drain writes nothing.
+ */
+void test_smf_trace_record_drain(void)
+{
+    struct smf_trace_record records[3];
+
+    smf_trace_record(&ctx, SMF_TRACE_TRANSITION, &states[0], &states[1], 0);
+    smf_trace_record(&ctx, SMF_TRACE_EVENT, NULL, &states[1], 42);
+    smf_trace_record(&ctx, SMF_TRACE_TERMINATE, NULL, &states[1], 7);
+
+    TEST_ASSERT_EQUAL_INT(3, (int) smf_trace_drain(&buffer, fds[1]));
+    records_read(records, 3);
+
+    TEST_ASSERT_EQUAL_UINT16(SMF_TRACE_TRANSITION, records[0].kind);
+    TEST_ASSERT_EQUAL_UINT64((uintptr_t) &ctx, records[0].ctx);
+    TEST_ASSERT_EQUAL_UINT64((uintptr_t) &states[0], records[0].from);
+    TEST_ASSERT_EQUAL_UINT64((uintptr_t) &states[1], records[0].to);
+    TEST_ASSERT_EQUAL_UINT16(3, records[0].thread);
+
+    TEST_ASSERT_EQUAL_UINT16(SMF_TRACE_EVENT, records[1].kind);
+    TEST_ASSERT_EQUAL_UINT64(0, records[1].from);
+    TEST_ASSERT_EQUAL_UINT32(42, records[1].arg);
+
+    TEST_ASSERT_EQUAL_UINT16(SMF_TRACE_TERMINATE, records[2].kind);
+    TEST_ASSERT_EQUAL_UINT32(7, records[2].arg);
+
+    TEST_ASSERT_TRUE(records[0].timestamp <= records[1].timestamp);
+    TEST_ASSERT_TRUE(records[1].timestamp <= records[2].timestamp);
+
+    TEST_ASSERT_EQUAL_INT(0, (int) smf_trace_drain(&buffer, fds[1]));
+}
+
+/**
+ * Records lost to a full buffer are counted
+ *
+ * Description:
+ * - This test verifies that records are dropped when the trace buffer is
+ *   full, and that a SMF_TRACE_DROPPED record counting them marks the gap
+ *   once it was drained.
+ *
+ * Steps:
+ * - Record 6 events in a buffer holding 4 records, and drain it.
+ * - Record one more event and drain again.
+ *
+ * Expected result:
+ * - The first drain returns the first 4 events.
+ * - The second drain returns a SMF_TRACE_DROPPED record with an argument
+ *   of 2, then the last event.
+ */
+void test_smf_trace_dropped_records(void)
+{
+    struct smf_trace_record records[4];
+
+    for (uint32_t i = 0; i < 6; i++) {
+        smf_trace_record(&ctx, SMF_TRACE_EVENT, NULL, &states[0], i);
+    }
+
+    TEST_ASSERT_EQUAL_INT(4, (int) smf_trace_drain(&buffer, fds[1]));
+    records_read(records, 4);
+
+    for (uint32_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, records[i].arg);
+    }
+
+    smf_trace_record(&ctx, SMF_TRACE_EVENT, NULL, &states[0], 6);
+
+    TEST_ASSERT_EQUAL_INT(2, (int) smf_trace_drain(&buffer, fds[1]));
+    records_read(records, 2);
+
+    TEST_ASSERT_EQUAL_UINT16(SMF_TRACE_DROPPED, records[0].kind);
+    TEST_ASSERT_EQUAL_UINT32(2, records[0].arg);
+    TEST_ASSERT_EQUAL_UINT16(SMF_TRACE_EVENT, records[1].kind);
+    TEST_ASSERT_EQUAL_UINT32(6, records[1].arg);
+}
+
+/**
+ * Threads without a trace buffer are not traced
+ *
+ * Description:
+ * - This test verifies that records of a thread whose tracing stopped are
+ *   discarded.
+ *
+ * Steps:
+ * - Stop tracing, record an event, and drain the buffer.
+ *
+ * Expected result:
+ * - Nothing is drained.
+ */
+void test_smf_trace_thread_stop(void)
+{
+    smf_trace_thread_stop();
+    smf_trace_record(&ctx, SMF_TRACE_EVENT, NULL, &states[0], 1);
+
+    TEST_ASSERT_EQUAL_INT(0, (int) smf_trace_drain(&buffer, fds[1]));
+}
+
+/**
+ * The file header names the states
+ *
+ * Description:
+ * - This test verifies that smf_trace_header_write writes the file header
+ *   read by the decoder, followed by the address and name of each state.
+ *
+ * Steps:
+ * - Write the header of two named states to a pipe and read it back.
+ *
+ * Expected result:
+ * - The header holds the magic number, version, record size, number of
+ *   states and a non-zero timestamp rate.
+ * - Each state entry holds its address, name length and name.
+ */
+void test_smf_trace_header(void)
+{
+    static const char *const names[2] = { "IDLE", "RUNNING" };
+    struct smf_trace_file_header header;
+    uint64_t address;
+    uint32_t length;
+    char name[8];
+
+    TEST_ASSERT_EQUAL_INT32(0, smf_trace_header_write(fds[1], states, names, 2));
+
+    TEST_ASSERT_EQUAL_INT((int) sizeof(header), (int) read(fds[0], &header, sizeof(header)));
+    TEST_ASSERT_EQUAL_HEX32(SMF_TRACE_MAGIC, header.magic);
+    TEST_ASSERT_EQUAL_UINT16(SMF_TRACE_VERSION, header.version);
+    TEST_ASSERT_EQUAL_UINT16(RECORD_SIZE, header.record_size);
+    TEST_ASSERT_EQUAL_UINT32(2, header.name_count);
+    TEST_ASSERT_TRUE(header.timestamp_khz != 0);
+
+    for (uint32_t i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL_INT((int) sizeof(address), (int) read(fds[0], &address,
+                                                                 sizeof(address)));
+        TEST_ASSERT_EQUAL_INT((int) sizeof(length), (int) read(fds[0], &length, sizeof(length)));
+        TEST_ASSERT_EQUAL_UINT64((uintptr_t) &states[i], address);
+        TEST_ASSERT_EQUAL_UINT32(strlen(names[i]), length);
+
+        TEST_ASSERT_EQUAL_INT((int) length, (int) read(fds[0], name, length));
+        TEST_ASSERT_EQUAL_MEMORY(names[i], name, length);
+    }
+}
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2024
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Offline decoder of state machine trace files.
+ *
+ * Reads a file written with smf_trace_header_write() and smf_trace_drain(),
+ * sorts its records by timestamp (records of several threads are drained in
+ * chunks) and prints one line per record, with state addresses resolved to
+ * the names found in the header:
+ *
+ *   <time> <thread> <ctx> <kind> <from> -> <to> [arg]
+ *
+ * Times are relative to the first record, in nanoseconds converted with
+ * the timestamp rate found in the header. The file must come from a system
+ * with the same byte order.
+ *
+ * Build and run:
+ *   gcc -O2 -std=c11 -Isrc tools/smf_trace_decode.c -o smf_trace_decode
+ *   ./smf_trace_decode trace.bin
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "smf_trace.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct state_name {
+    uint64_t address;
+    char *name;
+};
+
+struct trace {
+    struct state_name *names;
+    uint32_t name_count;
+    uint32_t timestamp_khz;
+    struct smf_trace_record *records;
+    size_t record_count;
+};
+
+static const char *const kind_names[] = {
+    [SMF_TRACE_INITIAL] = "initial",
+    [SMF_TRACE_TRANSITION] = "transition",
+    [SMF_TRACE_ENTRY] = "entry",
+    [SMF_TRACE_EXIT] = "exit",
+    [SMF_TRACE_EVENT] = "event",
+    [SMF_TRACE_TERMINATE] = "terminate",
+    [SMF_TRACE_DROPPED] = "dropped",
+};
+
+static int read_exact(FILE *file, void *data, size_t size)
+{
+    return (fread(data, 1, size, file) == size) ? 0 : -1;
+}
+
+/* Number of bytes between the position of a file and its end. */
+static uint64_t bytes_left(FILE *file, uint64_t size)
+{
+    long position = ftell(file);
+
+    return (position >= 0 && (uint64_t) position <= size) ? size - (uint64_t) position : 0;
+}
+
+static int trace_load(struct trace *trace, FILE *file)
+{
+    struct smf_trace_file_header header;
+    uint64_t size;
+
+    if (fseek(file, 0, SEEK_END) != 0 || ftell(file) < 0) {
+        fprintf(stderr, "cannot get the size of the file\n");
+        return -1;
+    }
+    size = (uint64_t) ftell(file);
+    rewind(file);
+
+    if (read_exact(file, &header, sizeof(header)) != 0 || header.magic != SMF_TRACE_MAGIC ||
+        header.version != SMF_TRACE_VERSION ||
+        header.record_size != sizeof(struct smf_trace_record) || header.timestamp_khz == 0) {
+        fprintf(stderr, "not a trace file, or an incompatible one\n");
+        return -1;
+    }
+
+    /* each name takes at least its address and length, bound the counts by
+     * the file size before allocating */
+    if (header.name_count > bytes_left(file, size) / (sizeof(uint64_t) + sizeof(uint32_t))) {
+        fprintf(stderr, "truncated state names\n");
+        return -1;
+    }
+
+    trace->timestamp_khz = header.timestamp_khz;
+    trace->names = calloc((size_t) header.name_count + 1u, sizeof(*trace->names));
+    if (trace->names == NULL) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < header.name_count; i++) {
+        struct state_name *entry = &trace->names[i];
+        uint32_t length;
+
+        if (read_exact(file, &entry->address, sizeof(entry->address)) != 0 ||
+            read_exact(file, &length, sizeof(length)) != 0 ||
+            length > bytes_left(file, size) ||
+            (entry->name = calloc((size_t) length + 1u, 1)) == NULL ||
+            read_exact(file, entry->name, length) != 0) {
+            fprintf(stderr, "truncated state names\n");
+            return -1;
+        }
+
+        trace->name_count++;
+    }
+
+    size_t capacity = 1024;
+
+    trace->records = malloc(capacity * sizeof(*trace->records));
+    trace->record_count = 0;
+
+    while (trace->records != NULL) {
+        if (trace->record_count == capacity) {
+            capacity *= 2;
+            struct smf_trace_record *records = realloc(trace->records,
+                                                       capacity * sizeof(*records));
+            if (records == NULL) {
+                return -1;
+            }
+            trace->records = records;
+        }
+
+        if (read_exact(file, &trace->records[trace->record_count],
+                       sizeof(*trace->records)) != 0) {
+            return 0;
+        }
+
+        trace->record_count++;
+    }
+
+    return -1;
+}
+
+/* Records being sorted by order_compare(). */
+static const struct smf_trace_record *sort_records;
+
+/*
+ * Order records by timestamp. Records with the same timestamp keep their
+ * file order, which is the recording order of each thread.
+ */
+static int order_compare(const void *a, const void *b)
+{
+    size_t ia = *(const size_t *) a;
+    size_t ib = *(const size_t *) b;
+    uint64_t ta = sort_records[ia].timestamp;
+    uint64_t tb = sort_records[ib].timestamp;
+
+    if (ta != tb) {
+        return (ta < tb) ? -1 : 1;
+    }
+
+    return (ia < ib) ? -1 : (ia > ib);
+}
+
+static const char *state_name(const struct trace *trace, uint64_t address, char *buf,
+                              size_t size)
+{
+    if (address == 0) {
+        return "-";
+    }
+
+    for (uint32_t i = 0; i < trace->name_count; i++) {
+        if (trace->names[i].address == address) {
+            return trace->names[i].name;
+        }
+    }
+
+    snprintf(buf, size, "0x%" PRIx64, address);
+
+    return buf;
+}
+
+int main(int argc, char **argv)
+{
+    struct trace trace = {0};
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s TRACE_FILE\n", argv[0]);
+        return 2;
+    }
+
+    FILE *file = fopen(argv[1], "rb");
+    if (file == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    int result = trace_load(&trace, file);
+    fclose(file);
+
+    if (result != 0) {
+        return 1;
+    }
+
+    size_t *order = malloc((trace.record_count + 1u) * sizeof(*order));
+    if (order == NULL) {
+        return 1;
+    }
+
+    for (size_t i = 0; i < trace.record_count; i++) {
+        order[i] = i;
+    }
+
+    sort_records = trace.records;
+    qsort(order, trace.record_count, sizeof(*order), order_compare);
+
+    uint64_t start = (trace.record_count > 0) ? trace.records[order[0]].timestamp : 0;
+
+    for (size_t i = 0; i < trace.record_count; i++) {
+        const struct smf_trace_record *record = &trace.records[order[i]];
+        const char *kind = (record->kind < sizeof(kind_names) / sizeof(kind_names[0]))
+                           ? kind_names[record->kind] : "unknown";
+        char from[32];
+        char to[32];
+
+        uint64_t ns = (uint64_t) ((double) (record->timestamp - start) * 1e6 /
+                                  trace.timestamp_khz);
+
+        printf("%12" PRIu64 " %3u 0x%" PRIx64 " %-10s %s -> %s", ns,
+               record->thread, record->ctx, kind,
+               state_name(&trace, record->from, from, sizeof(from)),
+               state_name(&trace, record->to, to, sizeof(to)));
+
+        if (record->kind == SMF_TRACE_EVENT || record->kind == SMF_TRACE_TERMINATE ||
+            record->kind == SMF_TRACE_DROPPED) {
+            printf(" %" PRIu32, record->arg);
+        }
+
+        printf("\n");
+    }
+
+    return 0;
+}